@@ -0,0 +1,28 @@
+// @effect Vignette
+// @after output
+// @order 0
+// @uniform amount 0.5
+// @uniform radius 0.75
+// @enabled 0
+//
+// Example effect for the View menu "Effects".
+// Change "@enabled 0" to 1 and save the file while the
+// player is running. Changes are loaded without restarting.
+//
+layout(rgba8, binding=0) uniform image2D src;
+layout(rgba8, binding=1) uniform writeonly image2D dst;
+layout(location = 0) uniform float amount;
+layout(location = 1) uniform float radius;
+
+void main() {
+	ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 size = imageSize(src);
+	if (pos.x >= size.x || pos.y >= size.y)
+		return;
+	vec4 c = imageLoad(src, pos);
+	vec2 uv = (vec2(pos) + 0.5) / vec2(size) - 0.5;
+	uv.x *= float(size.x) / float(size.y);
+	float d = length(uv);
+	float v = 1.0 - amount * smoothstep(radius * 0.5, radius, d);
+	imageStore(dst, pos, vec4(c.rgb * v, c.a));
+}
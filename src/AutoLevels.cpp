@@ -0,0 +1,250 @@
+/*
+
+	AutoLevels.cpp
+
+	Spout Video Player
+
+	Automatic levels from the luminance of the frame.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "AutoLevels.h"
+
+autoLevels::~autoLevels() {
+	Release();
+}
+
+//---------------------------------------------------------
+// Function: SetDamping
+void autoLevels::SetDamping(double seconds)
+{
+	m_damping = seconds;
+	if (m_damping < 0.0)
+		m_damping = 0.0;
+}
+
+//---------------------------------------------------------
+// Function: Start
+// Results waiting are for the last source and are discarded
+void autoLevels::Start()
+{
+	for (auto &rb : m_ring) {
+		if (rb.fence)
+			glDeleteSync(rb.fence);
+		rb.fence = nullptr;
+	}
+	m_next = 0;
+	m_read = 0;
+	m_bLevels = false;
+	m_min = 0.0;
+	m_max = 1.0;
+	m_mean = 0.5;
+	m_brightness = 0.0f;
+	m_contrast = 1.0f;
+	m_gamma = 1.0f;
+}
+
+//---------------------------------------------------------
+// Function: Release
+void autoLevels::Release()
+{
+	Start();
+	for (auto &rb : m_ring) {
+		if (rb.buffer > 0)
+			glDeleteBuffers(1, &rb.buffer);
+		rb.buffer = 0;
+	}
+}
+
+//---------------------------------------------------------
+// Function: Analyse
+// The grid has about 960 columns for any frame size.
+void autoLevels::Analyse(spoutShaders &shaders, GLuint TextureID,
+	unsigned int width, unsigned int height)
+{
+	if (TextureID == 0 || width == 0 || height == 0)
+		return;
+
+	// All the buffers are waiting to be read
+	readback &rb = m_ring[m_next];
+	if (rb.fence)
+		return;
+
+	if (rb.buffer == 0)
+		glGenBuffers(1, &rb.buffer);
+
+	unsigned int step = width / 960;
+	if (step < 1)
+		step = 1;
+
+	if (shaders.Levels(TextureID, rb.buffer, width, height, step)) {
+		rb.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_next = (m_next + 1) % RING;
+	}
+}
+
+//---------------------------------------------------------
+// Function: Update
+// Buffers are read in the order they were used. The
+// damping is for the time since the last levels read.
+bool autoLevels::Update()
+{
+	bool bChanged = false;
+
+	while (m_ring[m_read].fence) {
+
+		readback &rb = m_ring[m_read];
+		GLenum status = glClientWaitSync(rb.fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			break;
+		glDeleteSync(rb.fence);
+		rb.fence = nullptr;
+		m_read = (m_read + 1) % RING;
+
+		GLuint levels[4] = { 255, 0, 0, 0 };
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, rb.buffer);
+		GLuint* data = (GLuint*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, sizeof(levels), GL_MAP_READ_BIT);
+		if (data) {
+			memcpy(levels, data, sizeof(levels));
+			glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		}
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		if (levels[3] == 0)
+			continue;
+
+		double lmin  = (double)levels[0] / 255.0;
+		double lmax  = (double)levels[1] / 255.0;
+		double lmean = (double)levels[2] / (double)levels[3] / 255.0;
+
+		double now = ofGetElapsedTimef();
+		if (!m_bLevels || m_damping <= 0.0) {
+			m_min  = lmin;
+			m_max  = lmax;
+			m_mean = lmean;
+			m_bLevels = true;
+		}
+		else {
+			double k = 1.0 - exp(-(now - m_lastTime) / m_damping);
+			m_min  += k * (lmin - m_min);
+			m_max  += k * (lmax - m_max);
+			m_mean += k * (lmean - m_mean);
+		}
+		m_lastTime = now;
+		bChanged = true;
+	}
+
+	if (bChanged)
+		SetAdjustments();
+
+	return bChanged;
+}
+
+//---------------------------------------------------------
+// Function: SetAdjustments
+// The adjust shader applies gamma, then contrast about 0.5, then
+// brightness. Gamma is found so that the mean is at mid grey after
+// the minimum and maximum with the same gamma are stretched to 0 - 1.
+// Contrast is limited for a frame with little range, e.g. a fade.
+void autoLevels::SetAdjustments()
+{
+	const double target = 0.45; // mid grey after the stretch
+	double lo = m_min;
+	double hi = m_max;
+	double mean = m_mean;
+	if (hi - lo < 1.0/255.0) {
+		m_brightness = 0.0f;
+		m_contrast = 1.0f;
+		m_gamma = 1.0f;
+		return;
+	}
+	if (mean < lo) mean = lo;
+	if (mean > hi) mean = hi;
+
+	// Position of the mean increases with gamma
+	auto position = [lo, hi, mean](double g) {
+		double l = pow(lo, 1.0/g);
+		double h = pow(hi, 1.0/g);
+		return (pow(mean, 1.0/g) - l) / (h - l);
+	};
+	double glo = 0.5;
+	double ghi = 2.0;
+	for (int i = 0; i < 20; i++) {
+		double g = (glo + ghi) / 2.0;
+		if (position(g) < target)
+			glo = g;
+		else
+			ghi = g;
+	}
+	double gamma = (glo + ghi) / 2.0;
+
+	double l = pow(lo, 1.0/gamma);
+	double h = pow(hi, 1.0/gamma);
+	double contrast = 1.0 / (h - l);
+	if (contrast > 4.0)
+		contrast = 4.0;
+	double brightness = (0.5 - (l + h) / 2.0) * contrast;
+	if (brightness < -1.0) brightness = -1.0;
+	if (brightness > 1.0) brightness = 1.0;
+
+	m_brightness = (float)brightness;
+	m_contrast = (float)contrast;
+	m_gamma = (float)gamma;
+}
+
+//---------------------------------------------------------
+// Function: GetBrightness
+float autoLevels::GetBrightness()
+{
+	return m_brightness;
+}
+
+//---------------------------------------------------------
+// Function: GetContrast
+float autoLevels::GetContrast()
+{
+	return m_contrast;
+}
+
+//---------------------------------------------------------
+// Function: GetGamma
+float autoLevels::GetGamma()
+{
+	return m_gamma;
+}
+
+//---------------------------------------------------------
+// Function: GetMin
+float autoLevels::GetMin()
+{
+	return (float)m_min;
+}
+
+//---------------------------------------------------------
+// Function: GetMax
+float autoLevels::GetMax()
+{
+	return (float)m_max;
+}
+
+//---------------------------------------------------------
+// Function: GetMean
+float autoLevels::GetMean()
+{
+	return (float)m_mean;
+}
@@ -0,0 +1,96 @@
+/*
+
+	AutoLevels.h
+
+	Spout Video Player
+
+	Automatic levels from the luminance of the frame.
+
+	The minimum, maximum and mean luminance of each frame are found by
+	a reduction compute shader before the adjustments. The results are
+	written to a ring of readback buffers with a fence for each, and a
+	buffer is mapped only when its fence has signalled, so that the
+	render thread never waits for the GPU. Frames are not analysed while
+	all the buffers are waiting.
+
+	Brightness, contrast and gamma for spoutShaders::Adjust are found
+	to stretch the levels to the full range with the mean at mid grey.
+	The levels are damped in time so that the changes are smooth.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutShaders.h" // For the levels shader
+
+class autoLevels {
+
+	public:
+
+		~autoLevels();
+
+		// Time constant of the damping (seconds)
+		void SetDamping(double seconds);
+
+		// Clear the levels for a new source
+		void Start();
+		void Release();
+
+		// Find the levels of a frame if a readback buffer is free
+		void Analyse(spoutShaders &shaders, GLuint TextureID,
+			unsigned int width, unsigned int height);
+
+		// Read the levels of completed frames without waiting.
+		// Returns true if the adjustments have changed.
+		bool Update();
+
+		// Adjustments for the levels. Neutral until the first levels are read.
+		float GetBrightness();
+		float GetContrast();
+		float GetGamma();
+
+		// Damped luminance levels 0 - 1
+		float GetMin();
+		float GetMax();
+		float GetMean();
+
+	protected :
+
+		static const int RING = 3;
+		struct readback {
+			GLuint buffer = 0;
+			GLsync fence = nullptr;
+		};
+		readback m_ring[RING];
+		int m_next = 0; // next buffer to use
+		int m_read = 0; // oldest buffer waiting
+
+		double m_damping = 0.5;
+		double m_lastTime = 0.0;
+		bool m_bLevels = false; // levels have been read
+		double m_min = 0.0;
+		double m_max = 1.0;
+		double m_mean = 0.5;
+
+		float m_brightness = 0.0f;
+		float m_contrast = 1.0f;
+		float m_gamma = 1.0f;
+
+		void SetAdjustments();
+
+};
@@ -0,0 +1,305 @@
+/*
+
+	ClipCache.cpp
+
+	Spout Video Player
+
+	Memory cache of decoded movie frames.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "ClipCache.h"
+
+//---------------------------------------------------------
+// Function: SetBudget
+// Maximum memory for all clips
+void clipCache::SetBudget(int megabytes)
+{
+	if (megabytes < 64)
+		megabytes = 64;
+	m_budget = (size_t)megabytes*1024*1024;
+	Evict(0);
+}
+
+//---------------------------------------------------------
+// Function: GetBudget
+int clipCache::GetBudget()
+{
+	return (int)(m_budget/(1024*1024));
+}
+
+//---------------------------------------------------------
+// Function: Begin
+// Select a clip to cache or play.
+// The clip is moved to the front of the list.
+bool clipCache::Begin(std::string path, int nFrames, int width, int height)
+{
+	m_bSkip = false;
+
+	for (auto it = m_clips.begin(); it != m_clips.end(); it++) {
+		if (it->path == path) {
+			// Same clip with different content
+			if (it->width != width || it->height != height || (int)it->frames.size() != nFrames) {
+				m_bytes -= it->bytes;
+				m_clips.erase(it);
+				break;
+			}
+			// Most recently used
+			m_clips.splice(m_clips.begin(), m_clips, it);
+			return IsComplete();
+		}
+	}
+
+	if (nFrames <= 0 || width <= 0 || height <= 0)
+		return false;
+
+	// A clip larger than the budget is not cached
+	size_t clipbytes = (size_t)nFrames*width*height*4;
+	if (clipbytes > m_budget) {
+		SpoutLogNotice("clipCache - %s (%d MB) is larger than the cache (%d MB)",
+			path.c_str(), (int)(clipbytes/(1024*1024)), GetBudget());
+		m_bSkip = true;
+		return false;
+	}
+
+	clip newclip;
+	newclip.path = path;
+	newclip.width = width;
+	newclip.height = height;
+	newclip.frames.resize(nFrames);
+	m_clips.push_front(newclip);
+
+	return false;
+}
+
+//---------------------------------------------------------
+// Function: Release
+void clipCache::Release()
+{
+	m_clips.clear();
+	m_bytes = 0;
+	m_bSkip = false;
+}
+
+//---------------------------------------------------------
+// Function: Add
+// Copy a decoded frame to the current clip
+bool clipCache::Add(int frame, ofPixels &pixels)
+{
+	if (m_bSkip || m_clips.empty())
+		return false;
+
+	clip &current = m_clips.front();
+	if (frame < 0 || frame >= (int)current.frames.size()
+		|| current.frames[frame].isAllocated()
+		|| (int)pixels.getWidth() != current.width
+		|| (int)pixels.getHeight() != current.height)
+		return false;
+
+	// Make room by removing the least recently used clips
+	size_t bytes = pixels.size();
+	if (!Evict(bytes))
+		return false;
+
+	current.frames[frame] = pixels;
+	current.captured++;
+	current.bytes += bytes;
+	m_bytes += bytes;
+
+	if (current.captured == (int)current.frames.size()) {
+		SpoutLogNotice("clipCache - cached %s (%d frames, %d MB, total %d MB)",
+			current.path.c_str(), current.captured, (int)(current.bytes/(1024*1024)), (int)(m_bytes/(1024*1024)));
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Get
+// Decoded frame of the current clip
+ofPixels* clipCache::Get(int frame)
+{
+	if (m_bSkip || m_clips.empty())
+		return nullptr;
+
+	clip &current = m_clips.front();
+	if (frame < 0 || frame >= (int)current.frames.size() || !current.frames[frame].isAllocated())
+		return nullptr;
+
+	return &current.frames[frame];
+}
+
+//---------------------------------------------------------
+// Function: IsComplete
+bool clipCache::IsComplete()
+{
+	if (m_bSkip || m_clips.empty())
+		return false;
+	clip &current = m_clips.front();
+	return (current.captured > 0 && current.captured == (int)current.frames.size());
+}
+
+//---------------------------------------------------------
+// Function: GetFrames
+int clipCache::GetFrames()
+{
+	if (m_bSkip || m_clips.empty())
+		return 0;
+	return (int)m_clips.front().frames.size();
+}
+
+//---------------------------------------------------------
+// Function: GetFrameWidth
+int clipCache::GetFrameWidth()
+{
+	if (m_bSkip || m_clips.empty())
+		return 0;
+	return m_clips.front().width;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameHeight
+int clipCache::GetFrameHeight()
+{
+	if (m_bSkip || m_clips.empty())
+		return 0;
+	return m_clips.front().height;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameRate
+// The movie frame rate is used
+double clipCache::GetFrameRate()
+{
+	return 0.0;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameData
+const unsigned char* clipCache::GetFrameData(int frame)
+{
+	ofPixels* pixels = Get(frame);
+	if (!pixels)
+		return nullptr;
+	return pixels->getData();
+}
+
+//---------------------------------------------------------
+// Function: Evict
+// Remove least recently used clips until there is room
+// for the required bytes. The current clip is not removed.
+bool clipCache::Evict(size_t bytes)
+{
+	while (m_bytes + bytes > m_budget && m_clips.size() > 1) {
+		clip &oldest = m_clips.back();
+		SpoutLogNotice("clipCache - removed %s (%d MB)", oldest.path.c_str(), (int)(oldest.bytes/(1024*1024)));
+		m_bytes -= oldest.bytes;
+		m_clips.pop_back();
+	}
+
+	if (m_bytes + bytes > m_budget) {
+		// Only the current clip is left and it does not fit.
+		// This can happen if the budget is reduced.
+		if (!m_clips.empty()) {
+			m_bytes -= m_clips.front().bytes;
+			m_clips.pop_front();
+		}
+		m_bSkip = true;
+		return false;
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: FrameTime
+// Process CPU time (user and kernel) between output frames.
+// Decoded and cached frames are averaged separately
+// to show the CPU saved by the cache.
+void clipCache::FrameTime(bool bCached)
+{
+	double cpu = ProcessCpu();
+	double frametime = cpu - m_lastCpu;
+	m_lastCpu = cpu;
+	if (frametime <= 0.0 || frametime > 1000.0)
+		return;
+
+	if (bCached) {
+		m_cachedCpu = (m_cachedCpu == 0.0) ? frametime : m_cachedCpu*0.98 + frametime*0.02;
+		if (m_decodeCpu > m_cachedCpu)
+			m_savedCpu += (m_decodeCpu - m_cachedCpu);
+	}
+	else {
+		m_decodeCpu = (m_decodeCpu == 0.0) ? frametime : m_decodeCpu*0.98 + frametime*0.02;
+	}
+}
+
+//---------------------------------------------------------
+// Function: GetDecodeCpu
+double clipCache::GetDecodeCpu()
+{
+	return m_decodeCpu;
+}
+
+//---------------------------------------------------------
+// Function: GetCachedCpu
+double clipCache::GetCachedCpu()
+{
+	return m_cachedCpu;
+}
+
+//---------------------------------------------------------
+// Function: GetSavedCpu
+double clipCache::GetSavedCpu()
+{
+	return m_savedCpu;
+}
+
+//---------------------------------------------------------
+// Function: GetBytes
+size_t clipCache::GetBytes()
+{
+	return m_bytes;
+}
+
+//---------------------------------------------------------
+// Function: GetClips
+int clipCache::GetClips()
+{
+	return (int)m_clips.size();
+}
+
+//---------------------------------------------------------
+// Function: ProcessCpu
+// Process user and kernel time in msec
+double clipCache::ProcessCpu()
+{
+	FILETIME create, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &create, &exit, &kernel, &user))
+		return 0.0;
+
+	ULARGE_INTEGER k, u;
+	k.LowPart  = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart  = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+
+	// 100 nanosecond units
+	return (double)(k.QuadPart + u.QuadPart) / 10000.0;
+}
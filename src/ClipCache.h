@@ -0,0 +1,107 @@
+/*
+
+	ClipCache.h
+
+	Spout Video Player
+
+	Memory cache of decoded movie frames.
+
+	Frames are copied from the decoder on the first pass and later
+	passes are played from memory without decoding. Several clips
+	can be cached within a size budget. The least recently used
+	clips are removed to make room for a new one.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutUtils.h" // For logging
+#include "FrameSource.h"
+
+using namespace spoututils;
+
+class clipCache : public frameSource {
+
+	public:
+
+		// Size budget in megabytes
+		void SetBudget(int megabytes);
+		int GetBudget();
+
+		// Select a clip to cache or play.
+		// Returns true if the clip is already cached.
+		bool Begin(std::string path, int nFrames, int width, int height);
+
+		// Remove all clips
+		void Release();
+
+		// Copy a decoded frame to the current clip
+		bool Add(int frame, ofPixels &pixels);
+
+		// Decoded frame of the current clip or nullptr
+		ofPixels* Get(int frame);
+
+		// All frames of the current clip are cached
+		bool IsComplete();
+
+		// Number of frames in the current clip
+		int GetFrames();
+
+		// frameSource
+		int GetFrameWidth();
+		int GetFrameHeight();
+		double GetFrameRate();
+		const unsigned char* GetFrameData(int frame);
+
+		// Process CPU time for each output frame
+		void FrameTime(bool bCached);
+		double GetDecodeCpu(); // msec per decoded frame
+		double GetCachedCpu(); // msec per cached frame
+		double GetSavedCpu();  // total msec saved by cached frames
+
+		// Memory footprint
+		size_t GetBytes(); // all clips
+		int GetClips();
+
+	protected :
+
+		struct clip {
+			std::string path;
+			std::vector<ofPixels> frames;
+			int width = 0;
+			int height = 0;
+			int captured = 0; // number of frames copied
+			size_t bytes = 0;
+		};
+
+		// Most recently used first
+		std::list<clip> m_clips;
+		size_t m_budget = (size_t)4096*1024*1024;
+		size_t m_bytes = 0;
+		bool m_bSkip = false; // current clip is larger than the budget
+
+		bool Evict(size_t bytes);
+
+		// CPU timing
+		double m_lastCpu = 0.0;
+		double m_decodeCpu = 0.0;
+		double m_cachedCpu = 0.0;
+		double m_savedCpu = 0.0;
+		double ProcessCpu();
+
+};
@@ -0,0 +1,264 @@
+/*
+
+	CueList.cpp
+
+	Spout Video Player
+
+	Scheduled playback from a cue file.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "CueList.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <ctime>
+
+//---------------------------------------------------------
+// Function: GetCommandName
+const char* cueList::GetCommandName(int command)
+{
+	switch (command) {
+		case CUE_PLAY:   return "play";
+		case CUE_SEEK:   return "seek";
+		case CUE_PAUSE:  return "pause";
+		case CUE_RESUME: return "resume";
+		case CUE_STOP:   return "stop";
+		default: return "";
+	}
+}
+
+//---------------------------------------------------------
+// Function: Load
+// Lines that cannot be read are skipped
+bool cueList::Load(const std::string &path)
+{
+	Clear();
+
+	std::ifstream file(path);
+	if (!file.is_open())
+		return false;
+	m_path = path;
+
+	// The time of day now, with the clock start
+	m_start = std::chrono::steady_clock::now();
+	auto wall = std::chrono::system_clock::now();
+	time_t tt = std::chrono::system_clock::to_time_t(wall);
+	tm local{};
+	localtime_s(&local, &tt);
+	double subsecond = (double)(std::chrono::duration_cast<std::chrono::milliseconds>(
+		wall.time_since_epoch()).count() % 1000)/1000.0;
+	double today = (double)(local.tm_hour*3600 + local.tm_min*60 + local.tm_sec) + subsecond;
+
+	std::filesystem::path folder = std::filesystem::path(path).parent_path();
+	double lastDay = -1.0; // time of day on the line before
+	double days = 0.0;
+
+	std::string line;
+	int number = 0;
+	while (std::getline(file, line)) {
+		number++;
+		std::istringstream words(line);
+		std::string timestr, name;
+		if (line.empty() || line[0] == '#' || !(words >> timestr >> name))
+			continue;
+
+		cue c{};
+		c.line = number;
+		c.command = -1;
+		for (int i = 0; i < CUE_COMMANDS; i++) {
+			if (name == GetCommandName(i))
+				c.command = i;
+		}
+
+		double seconds = 0.0;
+		bool bRelative = false;
+		if (c.command < 0 || !ParseTime(timestr, seconds, bRelative))
+			continue;
+
+		if (c.command == CUE_PLAY) {
+			if (!(words >> std::quoted(c.path)))
+				continue;
+			words >> c.frame;
+			std::filesystem::path file(c.path);
+			if (file.is_relative())
+				c.path = (folder / file).string();
+		}
+		else if (c.command == CUE_SEEK) {
+			if (!(words >> c.frame))
+				continue;
+		}
+		if (c.frame < 0) c.frame = 0;
+
+		if (bRelative) {
+			c.time = seconds;
+		}
+		else {
+			if (seconds < lastDay)
+				days += 86400.0;
+			lastDay = seconds;
+			c.time = seconds + days - today;
+		}
+		m_cues.push_back(c);
+	}
+
+	// Cues at the same time stay in file order
+	std::stable_sort(m_cues.begin(), m_cues.end(),
+		[](const cue &a, const cue &b) { return a.time < b.time; });
+
+	return IsLoaded();
+}
+
+//---------------------------------------------------------
+// Function: Clear
+void cueList::Clear()
+{
+	m_cues.clear();
+	m_next = 0;
+	m_pending = -1;
+	m_path.clear();
+	m_bSaved = false;
+}
+
+//---------------------------------------------------------
+// Function: IsLoaded
+bool cueList::IsLoaded()
+{
+	return !m_cues.empty();
+}
+
+//---------------------------------------------------------
+// Function: GetCues
+int cueList::GetCues()
+{
+	return (int)m_cues.size();
+}
+
+//---------------------------------------------------------
+// Function: GetCue
+cueList::cue &cueList::GetCue(int index)
+{
+	return m_cues[index];
+}
+
+//---------------------------------------------------------
+// Function: Now
+double cueList::Now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+//---------------------------------------------------------
+// Function: Due
+// Cues scheduled before the file was loaded are fired
+// at once and their error shows how late they are.
+int cueList::Due(double margin)
+{
+	if (m_next >= m_cues.size())
+		return -1;
+
+	double now = Now();
+	cue &c = m_cues[m_next];
+	if (now + margin < c.time)
+		return -1;
+
+	// The last cue is not shown if this one is
+	// fired before the next frame
+	c.fired = now - c.time;
+	c.bFired = true;
+	m_pending = (int)m_next;
+	return (int)m_next++;
+}
+
+//---------------------------------------------------------
+// Function: NextPlay
+int cueList::NextPlay()
+{
+	for (size_t i = m_next; i < m_cues.size(); i++) {
+		if (m_cues[i].time - Now() > PREROLL)
+			break;
+		if (m_cues[i].command == CUE_PLAY)
+			return (int)i;
+	}
+	return -1;
+}
+
+//---------------------------------------------------------
+// Function: FrameShown
+void cueList::FrameShown()
+{
+	if (m_pending < 0)
+		return;
+
+	cue &c = m_cues[m_pending];
+	c.shown = Now() - c.time;
+	c.bShown = true;
+	m_pending = -1;
+
+	if (m_next >= m_cues.size())
+		SaveReport();
+}
+
+//---------------------------------------------------------
+// Function: SaveReport
+bool cueList::SaveReport()
+{
+	if (m_bSaved || m_path.empty() || m_cues.empty())
+		return false;
+	m_bSaved = true;
+
+	std::ofstream file(m_path + ".report");
+	if (!file.is_open())
+		return false;
+
+	file << "# line scheduled(s) command frame fired(ms) shown(ms)\n";
+	file << std::fixed;
+	for (const cue &c : m_cues) {
+		file << c.line << " " << std::setprecision(3) << c.time << " "
+			<< GetCommandName(c.command) << " " << c.frame << " ";
+		if (c.bFired) file << std::setprecision(1) << c.fired*1000.0; else file << "-";
+		file << " ";
+		if (c.bShown) file << std::setprecision(1) << c.shown*1000.0; else file << "-";
+		file << "\n";
+	}
+	return file.good();
+}
+
+//---------------------------------------------------------
+// Function: ParseTime
+// "hh:mm:ss.mmm" or "+s.sss"
+bool cueList::ParseTime(const std::string &str, double &seconds, bool &bRelative)
+{
+	bRelative = (!str.empty() && str[0] == '+');
+	if (bRelative) {
+		char* end = nullptr;
+		seconds = strtod(str.c_str() + 1, &end);
+		return (end && *end == 0 && seconds >= 0.0);
+	}
+
+	int h = 0, m = 0;
+	double s = 0.0;
+	if (sscanf_s(str.c_str(), "%d:%d:%lf", &h, &m, &s) != 3
+		|| h < 0 || h > 23 || m < 0 || m > 59 || s < 0.0 || s >= 60.0)
+		return false;
+	seconds = (double)(h*3600 + m*60) + s;
+	return true;
+}
@@ -0,0 +1,120 @@
+/*
+
+	CueList.h
+
+	Spout Video Player
+
+	Scheduled playback from a cue file.
+
+	The cue file is a text file given on the command line with "-cues".
+	Each line is :
+
+		time command [file] [frame]
+
+	time is the time of day "hh:mm:ss.mmm", or seconds after the cue
+	file is loaded "+s.sss". A time of day earlier than the one on the
+	line before is on the next day. Commands are :
+
+		play "file" [frame] - show the file from the frame (default 0) and play
+		seek frame          - show a frame of the current file
+		pause               - pause
+		resume              - play after a pause
+		stop                - close the file and show the splash image
+
+	A file path may be relative to the folder of the cue file.
+	Lines starting with '#' are comments.
+
+	Cues are sorted by time on a monotonic clock that starts when the
+	file is loaded, and the time of day is converted to it once, so a
+	change of the system time does not move the cues. A cue is fired
+	in the update cycle nearest its time. The movie decoder of the next
+	"play" cue is opened and seeked to the frame ahead of time, so that
+	the cut is the frame requested without a delay for the decoder.
+	This is done by the decoder thread (DecoderThread.h) so that the
+	movie that is playing does not wait for the open.
+
+	For validation, the time each cue is fired and the time of the
+	first new frame after it are recorded relative to the scheduled
+	time and saved in "cuefile.report" after the last cue.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+class cueList {
+
+	public:
+
+		enum { CUE_PLAY, CUE_SEEK, CUE_PAUSE, CUE_RESUME, CUE_STOP, CUE_COMMANDS };
+		static const char* GetCommandName(int command);
+
+		// Seconds before a "play" cue to open the decoder
+		static constexpr double PREROLL = 3.0;
+
+		struct cue {
+			double time = 0.0;   // scheduled (seconds from the start)
+			int command = CUE_PLAY;
+			std::string path;    // file for play
+			int frame = 0;       // frame for play and seek
+			int line = 0;        // line in the cue file
+			double fired = -1.0; // actual - scheduled (seconds)
+			double shown = -1.0; // first new frame - scheduled (seconds)
+			bool bFired = false;
+			bool bShown = false;
+		};
+
+		// Load and start the clock.
+		// Returns false if there is no file or no cues.
+		bool Load(const std::string &path);
+		void Clear();
+		bool IsLoaded();
+		int GetCues();
+		cue &GetCue(int index);
+
+		// Seconds on the monotonic clock since the file was loaded
+		double Now();
+
+		// The next cue due within the margin (seconds), or -1.
+		// The cue is marked as fired at the current time.
+		int Due(double margin);
+
+		// The next "play" cue within the pre-roll time, or -1
+		int NextPlay();
+
+		// A new frame after a cue has been fired
+		void FrameShown();
+
+		// Fired and shown times of each cue.
+		// Saved once, after the last cue or when closed.
+		bool SaveReport();
+
+	protected :
+
+		std::vector<cue> m_cues;
+		size_t m_next = 0;       // next cue to fire
+		int m_pending = -1;      // cue fired waiting for a frame
+		std::string m_path;
+		std::chrono::steady_clock::time_point m_start;
+		bool m_bSaved = false;
+
+		static bool ParseTime(const std::string &str, double &seconds, bool &bRelative);
+
+};
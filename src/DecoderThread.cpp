@@ -0,0 +1,261 @@
+/*
+
+	DecoderThread.cpp
+
+	Spout Video Player
+
+	Movie decoders opened in the background.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "AutoLevels.h"
+#include "DecoderThread.h"
+
+decoderThread::~decoderThread()
+{
+	Stop();
+}
+
+//---------------------------------------------------------
+// Function: Begin
+// The thread starts with the first request
+void decoderThread::Begin()
+{
+	if (!m_thread.joinable()) {
+		m_bStop = false;
+		m_thread = std::thread(&decoderThread::Run, this);
+	}
+}
+
+//---------------------------------------------------------
+// Function: Stop
+void decoderThread::Stop()
+{
+	if (!m_thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStop = true;
+	}
+	m_wake.notify_all();
+	m_thread.join();
+}
+
+//---------------------------------------------------------
+// Function: Open
+int decoderThread::Open(std::string path, int frame)
+{
+	Begin();
+
+	job j;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		j.id = m_nextId++;
+		j.path = path;
+		j.frame = frame;
+		m_waiting.push_back(j);
+	}
+	m_wake.notify_all();
+
+	return j.id;
+}
+
+//---------------------------------------------------------
+// Function: Poll
+int decoderThread::Poll(int id, std::shared_ptr<ofBaseVideoPlayer> &player)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (size_t i = 0; i < m_finished.size(); i++) {
+		if (m_finished[i].id == id) {
+			int state = m_finished[i].state;
+			player = m_finished[i].player;
+			m_finished.erase(m_finished.begin() + i);
+			return state;
+		}
+	}
+	if (m_running == id)
+		return DECODER_WAITING;
+	for (auto &j : m_waiting) {
+		if (j.id == id)
+			return DECODER_WAITING;
+	}
+	return DECODER_FAILED;
+}
+
+//---------------------------------------------------------
+// Function: Load
+std::shared_ptr<ofBaseVideoPlayer> decoderThread::Load(std::string path)
+{
+	int id = Open(path);
+
+	std::shared_ptr<ofBaseVideoPlayer> player;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this, id]() {
+		for (auto &j : m_finished) {
+			if (j.id == id)
+				return true;
+		}
+		return false;
+	});
+	for (size_t i = 0; i < m_finished.size(); i++) {
+		if (m_finished[i].id == id) {
+			player = m_finished[i].player;
+			m_finished.erase(m_finished.begin() + i);
+			break;
+		}
+	}
+
+	return player;
+}
+
+//---------------------------------------------------------
+// Function: Cancel
+void decoderThread::Cancel(int id)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_running == id)
+			m_bCancelled = true;
+		for (size_t i = 0; i < m_waiting.size(); i++) {
+			if (m_waiting[i].id == id) {
+				m_waiting.erase(m_waiting.begin() + i);
+				break;
+			}
+		}
+		for (size_t i = 0; i < m_finished.size(); i++) {
+			if (m_finished[i].id == id) {
+				if (m_finished[i].player)
+					m_release.push_back(m_finished[i].player);
+				m_finished.erase(m_finished.begin() + i);
+				break;
+			}
+		}
+	}
+	m_wake.notify_all();
+}
+
+//---------------------------------------------------------
+// Function: Release
+void decoderThread::Release(std::shared_ptr<ofBaseVideoPlayer> player)
+{
+	if (!player)
+		return;
+
+	Begin();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_release.push_back(player);
+	}
+	player.reset();
+	m_wake.notify_all();
+}
+
+//---------------------------------------------------------
+// Function: Run
+// Players given back are closed before another is opened.
+// All the players left are closed when the thread stops.
+void decoderThread::Run()
+{
+	HRESULT hr = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wake.wait(lock, [this]() {
+			return m_bStop || !m_waiting.empty() || !m_release.empty();
+		});
+
+		if (m_bStop) {
+			for (auto &j : m_finished) {
+				if (j.player)
+					m_release.push_back(j.player);
+			}
+			m_finished.clear();
+			m_waiting.clear();
+		}
+
+		if (!m_release.empty()) {
+			std::vector<std::shared_ptr<ofBaseVideoPlayer>> players;
+			players.swap(m_release);
+			lock.unlock();
+			for (auto &player : players)
+				player->close();
+			players.clear(); // the last references
+			lock.lock();
+			continue;
+		}
+
+		if (m_bStop)
+			break;
+
+		job j = m_waiting.front();
+		m_waiting.pop_front();
+		m_running = j.id;
+		m_bCancelled = false;
+		lock.unlock();
+
+		j.player = OpenPlayer(j.path, j.frame);
+
+		lock.lock();
+		m_running = 0;
+		if (m_bCancelled) {
+			if (j.player)
+				m_release.push_back(j.player);
+			continue;
+		}
+		j.state = j.player ? DECODER_READY : DECODER_FAILED;
+		m_finished.push_back(j);
+		m_done.notify_all();
+	}
+	lock.unlock();
+
+	if (SUCCEEDED(hr))
+		CoUninitialize();
+}
+
+//---------------------------------------------------------
+// Function: OpenPlayer
+// A pre-roll waits for the decoder to deliver the frame, then seeks
+// to it again so that it is new for the first update after it is
+// played (at most one second).
+std::shared_ptr<ofBaseVideoPlayer> decoderThread::OpenPlayer(const std::string &path, int frame)
+{
+	std::shared_ptr<ofBaseVideoPlayer> player = std::make_shared<OF_VID_PLAYER_TYPE>();
+	player->setPixelFormat(OF_PIXELS_RGBA);
+	if (!player->load(path) || player->getDuration() <= 0.0f) {
+		SpoutLogWarning("decoderThread::OpenPlayer - could not open %s", path.c_str());
+		player->close();
+		return nullptr;
+	}
+
+	if (frame >= 0) {
+		player->setVolume(0.0f);
+		player->play();
+		player->setPaused(true);
+		player->setFrame(frame);
+		for (int i = 0; i < 200; i++) {
+			player->update();
+			if (player->isFrameNew())
+				break;
+			Sleep(5);
+		}
+		player->setFrame(frame);
+	}
+
+	return player;
+}
@@ -0,0 +1,103 @@
+/*
+
+	DecoderThread.h
+
+	Spout Video Player
+
+	Movie decoders opened in the background.
+
+	The openFrameworks DirectShow player initialises COM with a count
+	shared by all players that is not thread safe. One thread that lives
+	as long as the application opens and closes every player, with COM
+	initialised for its whole life, so that the count is only changed
+	there. The main thread asks for a movie to be opened, polls for the
+	player without waiting and plays it. A player that is no longer used
+	is given back to the thread to be closed.
+
+	A movie for a cue is also pre-rolled on the thread, paused at the cue
+	frame with the sound off, so that it is ready to play at the cue time.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutUtils.h" // For logging
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace spoututils;
+
+class decoderThread {
+
+	public:
+
+		enum { DECODER_WAITING, DECODER_READY, DECODER_FAILED };
+
+		~decoderThread();
+
+		// Close all the players on the thread and end it
+		void Stop();
+
+		// Open a movie on the thread. With a frame, the player is
+		// paused at that frame with the sound off. Returns a job id.
+		int Open(std::string path, int frame = -1);
+
+		// State of a job without waiting. The player
+		// is given to the caller once when it is ready.
+		int Poll(int id, std::shared_ptr<ofBaseVideoPlayer> &player);
+
+		// Open a movie and wait for it
+		std::shared_ptr<ofBaseVideoPlayer> Load(std::string path);
+
+		// A player opened for the job is closed on the thread
+		void Cancel(int id);
+
+		// Close a player on the thread. The caller
+		// must not keep another reference to it.
+		void Release(std::shared_ptr<ofBaseVideoPlayer> player);
+
+	protected :
+
+		struct job {
+			int id = 0;
+			std::string path;
+			int frame = -1;
+			int state = DECODER_WAITING;
+			std::shared_ptr<ofBaseVideoPlayer> player;
+		};
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_wake; // work for the thread
+		std::condition_variable m_done; // a job has finished
+		std::deque<job> m_waiting;
+		std::vector<job> m_finished;
+		std::vector<std::shared_ptr<ofBaseVideoPlayer>> m_release;
+		int m_running = 0;        // job being opened
+		bool m_bCancelled = false; // the job being opened is not wanted
+		int m_nextId = 1;
+		bool m_bStop = false;
+
+		void Begin();
+		void Run();
+		static std::shared_ptr<ofBaseVideoPlayer> OpenPlayer(const std::string &path, int frame);
+
+};
@@ -0,0 +1,256 @@
+/*
+
+	DeinterlaceCpu.cpp
+
+	Spout Video Player
+
+	CPU reference of the motion adaptive deinterlace compute shader.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "DeinterlaceCpu.h"
+#include <cstring>
+#include <cstdlib>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define DEINTERLACE_SSE2
+#include <emmintrin.h>
+#endif
+
+static inline int Min(int a, int b) { return (a < b) ? a : b; }
+static inline int Max(int a, int b) { return (a > b) ? a : b; }
+
+// Lines beyond the top and bottom are reflected
+// so that they are in the same field
+static inline int Mirror(int y, int height)
+{
+	if (y < 0) y = -y;
+	if (y >= height) y = 2*(height-1) - y;
+	if (y < 0) y = 0;
+	if (y >= height) y = height-1;
+	return y;
+}
+
+//---------------------------------------------------------
+// Function: Frame
+// Lines of the field are copied. The others are interpolated.
+// The temporal neighbours of a missing line are in the previous
+// and current frames for the first field in time, and in the
+// current and next frames for the second.
+void deinterlaceCpu::Frame(const unsigned char* prev, const unsigned char* cur,
+	const unsigned char* next, unsigned char* dst,
+	int width, int height, int parity, bool bSecond, bool bSimd)
+{
+	if (!prev || !cur || !next || !dst || width <= 0 || height <= 0)
+		return;
+
+	size_t pitch = (size_t)width*4;
+	const unsigned char* before = bSecond ? cur : prev;
+	const unsigned char* after  = bSecond ? next : cur;
+
+	for (int y = 0; y < height; y++) {
+		unsigned char* line = dst + (size_t)y*pitch;
+		if (((y ^ parity) & 1) == 0) {
+			memcpy(line, cur + (size_t)y*pitch, pitch);
+			continue;
+		}
+
+		size_t above  = (size_t)Mirror(y-1, height)*pitch;
+		size_t below  = (size_t)Mirror(y+1, height)*pitch;
+		size_t above2 = (size_t)Mirror(y-2, height)*pitch;
+		size_t below2 = (size_t)Mirror(y+2, height)*pitch;
+		size_t row    = (size_t)y*pitch;
+
+		rows r{};
+		r.above = cur + above;
+		r.below = cur + below;
+		r.prevAbove = prev + above;
+		r.prevBelow = prev + below;
+		r.nextAbove = next + above;
+		r.nextBelow = next + below;
+		r.prev2 = before + row;
+		r.next2 = after + row;
+		r.prev2Above = before + above2;
+		r.next2Above = after + above2;
+		r.prev2Below = before + below2;
+		r.next2Below = after + below2;
+
+		int x1 = 0;
+		if (bSimd && HasSimd())
+			x1 = LineSimd(r, line, width);
+		if (x1 > 0) {
+			// Edge pixels that read outside the line
+			Line(r, line, width, 0, 3);
+			Line(r, line, width, x1, width);
+		}
+		else {
+			Line(r, line, width, 0, width);
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: HasSimd
+bool deinterlaceCpu::HasSimd()
+{
+#ifdef DEINTERLACE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+//---------------------------------------------------------
+// Function: Line
+// Scalar filter for pixels x0 to x1 of an interpolated line.
+// Pixels beyond the ends of the line are clamped.
+void deinterlaceCpu::Line(const rows &r, unsigned char* dst, int width, int x0, int x1)
+{
+	for (int x = x0; x < x1; x++) {
+		for (int ch = 0; ch < 4; ch++) {
+
+			auto at = [width, ch](const unsigned char* line, int px) {
+				if (px < 0) px = 0;
+				if (px >= width) px = width-1;
+				return (int)line[px*4 + ch];
+			};
+
+			int c = at(r.above, x);
+			int e = at(r.below, x);
+			int p2 = at(r.prev2, x);
+			int n2 = at(r.next2, x);
+			int d = (p2 + n2) >> 1;
+
+			// Temporal difference of the field and of the lines either side
+			int diff = Max(Max(abs(p2 - n2) >> 1,
+				(abs(at(r.prevAbove, x) - c) + abs(at(r.prevBelow, x) - e)) >> 1),
+				(abs(at(r.nextAbove, x) - c) + abs(at(r.nextBelow, x) - e)) >> 1);
+
+			// Edge directed spatial prediction.
+			// The second step in a direction only if the first is better.
+			int pred = (c + e) >> 1;
+			int best = abs(at(r.above, x-1) - at(r.below, x-1)) + abs(c - e)
+				+ abs(at(r.above, x+1) - at(r.below, x+1)) - 1;
+			for (int dir = -1; dir <= 1; dir += 2) {
+				for (int j = dir; abs(j) <= 2; j += dir) {
+					int score = abs(at(r.above, x-1+j) - at(r.below, x-1-j))
+						+ abs(at(r.above, x+j) - at(r.below, x-j))
+						+ abs(at(r.above, x+1+j) - at(r.below, x+1-j));
+					if (score >= best)
+						break;
+					best = score;
+					pred = (at(r.above, x+j) + at(r.below, x-j)) >> 1;
+				}
+			}
+
+			// Allow more change if the lines of the same field
+			// above and below also differ from the temporal average
+			int b = (at(r.prev2Above, x) + at(r.next2Above, x)) >> 1;
+			int f = (at(r.prev2Below, x) + at(r.next2Below, x)) >> 1;
+			int hi = Max(Max(d - e, d - c), Min(b - c, f - e));
+			int lo = Min(Min(d - e, d - c), Max(b - c, f - e));
+			diff = Max(Max(diff, lo), -hi);
+
+			if (pred > d + diff)
+				pred = d + diff;
+			else if (pred < d - diff)
+				pred = d - diff;
+
+			dst[x*4 + ch] = (unsigned char)pred;
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: LineSimd
+// Two pixels at a time in 16 bit lanes for the pixels that
+// do not read outside the line. Returns the first pixel not
+// filtered, or zero if the line is too short.
+int deinterlaceCpu::LineSimd(const rows &r, unsigned char* dst, int width)
+{
+#ifdef DEINTERLACE_SSE2
+	if (width < 8)
+		return 0;
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+
+	auto load = [zero](const unsigned char* line, int px) {
+		return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(line + px*4)), zero);
+	};
+	auto absd = [zero](__m128i a, __m128i b) {
+		__m128i v = _mm_sub_epi16(a, b);
+		return _mm_max_epi16(v, _mm_sub_epi16(zero, v));
+	};
+	auto half = [](__m128i a, __m128i b) {
+		return _mm_srai_epi16(_mm_add_epi16(a, b), 1);
+	};
+	auto select = [](__m128i mask, __m128i a, __m128i b) {
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	};
+
+	// Pixels x and x+1 read from x-3 to x+4
+	int x = 3;
+	for (; x + 4 < width; x += 2) {
+		__m128i c  = load(r.above, x);
+		__m128i e  = load(r.below, x);
+		__m128i p2 = load(r.prev2, x);
+		__m128i n2 = load(r.next2, x);
+		__m128i d  = half(p2, n2);
+
+		__m128i diff = _mm_max_epi16(_mm_max_epi16(_mm_srai_epi16(absd(p2, n2), 1),
+			_mm_srai_epi16(_mm_add_epi16(absd(load(r.prevAbove, x), c), absd(load(r.prevBelow, x), e)), 1)),
+			_mm_srai_epi16(_mm_add_epi16(absd(load(r.nextAbove, x), c), absd(load(r.nextBelow, x), e)), 1));
+
+		__m128i pred = half(c, e);
+		__m128i best = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(
+			absd(load(r.above, x-1), load(r.below, x-1)), absd(c, e)),
+			absd(load(r.above, x+1), load(r.below, x+1))), one);
+
+		for (int dir = -1; dir <= 1; dir += 2) {
+			__m128i mask = _mm_cmpeq_epi16(zero, zero);
+			for (int j = dir; abs(j) <= 2; j += dir) {
+				__m128i score = _mm_add_epi16(_mm_add_epi16(
+					absd(load(r.above, x-1+j), load(r.below, x-1-j)),
+					absd(load(r.above, x+j), load(r.below, x-j))),
+					absd(load(r.above, x+1+j), load(r.below, x+1-j)));
+				mask = _mm_and_si128(mask, _mm_cmplt_epi16(score, best));
+				best = select(mask, score, best);
+				pred = select(mask, half(load(r.above, x+j), load(r.below, x-j)), pred);
+			}
+		}
+
+		__m128i b = half(load(r.prev2Above, x), load(r.next2Above, x));
+		__m128i f = half(load(r.prev2Below, x), load(r.next2Below, x));
+		__m128i dc = _mm_sub_epi16(d, c);
+		__m128i de = _mm_sub_epi16(d, e);
+		__m128i bc = _mm_sub_epi16(b, c);
+		__m128i fe = _mm_sub_epi16(f, e);
+		__m128i hi = _mm_max_epi16(_mm_max_epi16(de, dc), _mm_min_epi16(bc, fe));
+		__m128i lo = _mm_min_epi16(_mm_min_epi16(de, dc), _mm_max_epi16(bc, fe));
+		diff = _mm_max_epi16(_mm_max_epi16(diff, lo), _mm_sub_epi16(zero, hi));
+
+		pred = _mm_min_epi16(_mm_max_epi16(pred, _mm_sub_epi16(d, diff)), _mm_add_epi16(d, diff));
+		_mm_storel_epi64((__m128i*)(dst + x*4), _mm_packus_epi16(pred, pred));
+	}
+	return x;
+#else
+	return 0;
+#endif
+}
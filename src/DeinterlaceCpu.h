@@ -0,0 +1,70 @@
+/*
+
+	DeinterlaceCpu.h
+
+	Spout Video Player
+
+	CPU reference of the motion adaptive deinterlace compute shader.
+
+	The same yadif filter as spoutShaders::Deinterlace on rgba frames
+	in memory, with SSE2 for two pixels at a time and a scalar path
+	for the edges and for other processors. It has no dependencies so
+	that it can be used by tools and tests without a GL context
+	(see tools/rawtool "deinterlace").
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+class deinterlaceCpu {
+
+	public:
+
+		// Deinterlace the current frame of rgba pixels
+		//   prev, next - frames before and after the current frame
+		//   parity  - field lines kept, 0 even (top) 1 odd (bottom)
+		//   bSecond - the field is the second in time of the frame
+		//   bSimd   - false for the scalar path only
+		static void Frame(const unsigned char* prev, const unsigned char* cur,
+			const unsigned char* next, unsigned char* dst,
+			int width, int height, int parity, bool bSecond, bool bSimd = true);
+
+		// SSE2 is available
+		static bool HasSimd();
+
+	protected :
+
+		// Rows of the three frames for an interpolated line
+		struct rows {
+			const unsigned char* above;     // current frame y-1
+			const unsigned char* below;     // current frame y+1
+			const unsigned char* prevAbove; // previous frame y-1
+			const unsigned char* prevBelow; // previous frame y+1
+			const unsigned char* nextAbove; // next frame y-1
+			const unsigned char* nextBelow; // next frame y+1
+			const unsigned char* prev2;     // same field before, y
+			const unsigned char* next2;     // same field after, y
+			const unsigned char* prev2Above; // y-2
+			const unsigned char* next2Above;
+			const unsigned char* prev2Below; // y+2
+			const unsigned char* next2Below;
+		};
+
+		static void Line(const rows &r, unsigned char* dst, int width, int x0, int x1);
+		static int LineSimd(const rows &r, unsigned char* dst, int width);
+
+};
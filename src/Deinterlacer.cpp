@@ -0,0 +1,163 @@
+/*
+
+	Deinterlacer.cpp
+
+	Spout Video Player
+
+	Motion adaptive deinterlace of interlaced movies.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "Deinterlacer.h"
+
+//---------------------------------------------------------
+// Function: SetMode
+void deinterlacer::SetMode(int mode)
+{
+	if (mode >= 0 && mode < DEINT_MODES && mode != m_mode) {
+		m_mode = mode;
+		m_bField = false;
+	}
+}
+
+//---------------------------------------------------------
+// Function: GetMode
+int deinterlacer::GetMode()
+{
+	return m_mode;
+}
+
+//---------------------------------------------------------
+// Function: GetModeName
+const char* deinterlacer::GetModeName(int mode)
+{
+	switch (mode) {
+		case DEINT_OFF:    return "off";
+		case DEINT_SINGLE: return "single rate";
+		case DEINT_DOUBLE: return "double rate";
+		default: return "";
+	}
+}
+
+//---------------------------------------------------------
+// Function: SetTopFirst
+void deinterlacer::SetTopFirst(bool bTopFirst)
+{
+	m_bTopFirst = bTopFirst;
+}
+
+//---------------------------------------------------------
+// Function: GetTopFirst
+bool deinterlacer::GetTopFirst()
+{
+	return m_bTopFirst;
+}
+
+//---------------------------------------------------------
+// Function: Start
+void deinterlacer::Start()
+{
+	m_frames = 0;
+	m_lastFrame = -1;
+	m_bField = false;
+}
+
+//---------------------------------------------------------
+// Function: Release
+void deinterlacer::Release()
+{
+	for (auto &tex : m_ring)
+		tex.clear();
+	m_width = 0;
+	m_height = 0;
+	Start();
+}
+
+//---------------------------------------------------------
+// Function: Process
+// The texture is replaced in place. A frame that does not follow
+// the last one starts the history again.
+bool deinterlacer::Process(spoutShaders &shaders, GLuint TextureID,
+	unsigned int width, unsigned int height, int frame)
+{
+	if (m_mode == DEINT_OFF || TextureID == 0 || width == 0 || height == 0)
+		return false;
+
+	if (width != m_width || height != m_height) {
+		for (auto &tex : m_ring)
+			tex.allocate(width, height, GL_RGBA8);
+		m_width = width;
+		m_height = height;
+		Start();
+	}
+
+	if (frame != m_lastFrame + 1)
+		m_frames = 0;
+	m_lastFrame = frame;
+
+	GLuint DestID = m_ring[m_frames % RING].getTextureData().textureID;
+	if (!shaders.Copy(TextureID, DestID, m_width, m_height))
+		return false;
+	m_frames++;
+
+	Render(shaders, TextureID, false);
+	m_bField = (m_mode == DEINT_DOUBLE);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: FieldPending
+bool deinterlacer::FieldPending()
+{
+	return m_bField;
+}
+
+//---------------------------------------------------------
+// Function: ProcessField
+bool deinterlacer::ProcessField(spoutShaders &shaders, GLuint TextureID)
+{
+	if (!m_bField || m_frames == 0 || TextureID == 0)
+		return false;
+
+	m_bField = false;
+	Render(shaders, TextureID, true);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Render
+// The frame before the newest is shown so that the
+// next frame is available. Missing frames at the start
+// of the history are replaced by the nearest.
+void deinterlacer::Render(spoutShaders &shaders, GLuint TextureID, bool bSecond)
+{
+	int64_t next = m_frames - 1;
+	int64_t cur  = (next > 0) ? next - 1 : next;
+	int64_t prev = (cur > 0) ? cur - 1 : cur;
+
+	// Top field first keeps the even lines for the first field
+	int parity = (m_bTopFirst == !bSecond) ? 0 : 1;
+
+	shaders.Deinterlace(m_ring[cur % RING].getTextureData().textureID,
+		m_ring[prev % RING].getTextureData().textureID,
+		m_ring[next % RING].getTextureData().textureID,
+		TextureID, m_width, m_height, parity, bSecond);
+}
@@ -0,0 +1,84 @@
+/*
+
+	Deinterlacer.h
+
+	Spout Video Player
+
+	Motion adaptive deinterlace of interlaced movies.
+
+	Processed before the adjustments. Frames are kept in a ring of
+	textures so that each frame is deinterlaced with the frames
+	before and after it, one frame behind the decoder. Modes are :
+
+	  Single - one output frame for each movie frame from the first field
+	  Double - one output frame for each field at twice the movie rate.
+	           The second field is shown half a frame after the first.
+
+	The history starts again if frames are not consecutive, for example
+	after a seek, and the first frame is deinterlaced from itself.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutShaders.h" // For the deinterlace shader
+
+class deinterlacer {
+
+	public:
+
+		enum { DEINT_OFF, DEINT_SINGLE, DEINT_DOUBLE, DEINT_MODES };
+
+		// Off, single or double rate
+		void SetMode(int mode);
+		int GetMode();
+		static const char* GetModeName(int mode);
+
+		// Field order of the movie (default top field first)
+		void SetTopFirst(bool bTopFirst);
+		bool GetTopFirst();
+
+		// Clear the frame history
+		void Start();
+		void Release();
+
+		// Add a new frame and replace it with the deinterlaced
+		// first field of the frame before it.
+		bool Process(spoutShaders &shaders, GLuint TextureID,
+			unsigned int width, unsigned int height, int frame);
+
+		// Second field for double rate
+		bool FieldPending();
+		bool ProcessField(spoutShaders &shaders, GLuint TextureID);
+
+	protected :
+
+		static const int RING = 3;
+		ofTexture m_ring[RING]; // last movie frames
+		unsigned int m_width = 0;
+		unsigned int m_height = 0;
+
+		int m_mode = DEINT_OFF;
+		bool m_bTopFirst = true;
+		int64_t m_frames = 0;  // frames in the history
+		int m_lastFrame = -1;  // movie frame number of the newest
+		bool m_bField = false; // second field not shown yet
+
+		void Render(spoutShaders &shaders, GLuint TextureID, bool bSecond);
+
+};
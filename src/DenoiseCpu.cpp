@@ -0,0 +1,178 @@
+/*
+
+	DenoiseCpu.cpp
+
+	Spout Video Player
+
+	CPU reference of the temporal denoise compute shader.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "DenoiseCpu.h"
+#include <cmath>
+
+// Unsigned normalized store of the shader
+static inline unsigned char Store(float v)
+{
+	if (v <= 0.0f) return 0;
+	if (v >= 1.0f) return 255;
+	return (unsigned char)(v*255.0f + 0.5f);
+}
+
+static inline float SmoothStep(float edge0, float edge1, float x)
+{
+	float t = (x - edge0) / (edge1 - edge0);
+	if (t < 0.0f) t = 0.0f;
+	if (t > 1.0f) t = 1.0f;
+	return t*t*(3.0f - 2.0f*t);
+}
+
+//---------------------------------------------------------
+// Function: Frame
+// Each pixel is mixed with the history in proportion to the
+// strength where the difference is within the noise threshold.
+// Larger differences are motion and the pixel is not changed.
+void denoiseCpu::Frame(const unsigned char* src, unsigned char* history,
+	unsigned char* dst, int width, int height, float strength, bool bUpdate)
+{
+	if (!src || !history || !dst || width <= 0 || height <= 0)
+		return;
+
+	float threshold = 0.04f + 0.16f*strength;
+	size_t count = (size_t)width*height;
+	for (size_t i = 0; i < count; i++) {
+		const unsigned char* c = src + i*4;
+		unsigned char* h = history + i*4;
+		unsigned char* d = dst + i*4;
+
+		float dr = (float)((int)c[0] - (int)h[0]) / 255.0f;
+		float dg = (float)((int)c[1] - (int)h[1]) / 255.0f;
+		float db = (float)((int)c[2] - (int)h[2]) / 255.0f;
+		float distance = sqrtf(dr*dr + dg*dg + db*db);
+		float k = 0.9f*strength*(1.0f - SmoothStep(0.5f*threshold, threshold, distance));
+
+		for (int ch = 0; ch < 3; ch++) {
+			float v = (float)c[ch] / 255.0f;
+			v += ((float)h[ch] / 255.0f - v)*k;
+			d[ch] = Store(v);
+		}
+		d[3] = c[3];
+		if (bUpdate) {
+			h[0] = d[0];
+			h[1] = d[1];
+			h[2] = d[2];
+			h[3] = d[3];
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: Synthetic
+// The background is a gradient with a fine static checker. A bar
+// moves 8 pixels each frame and a grating scrolls 2 pixels.
+void denoiseCpu::Synthetic(unsigned char* clean, unsigned char* noisy,
+	int width, int height, int frame, float sigma, uint32_t &seed)
+{
+	if (!clean || !noisy || width <= 0 || height <= 0)
+		return;
+
+	const float pi = 3.14159265f;
+	int barWidth = width/16 + 1;
+	int barX = (frame*8) % (width + barWidth) - barWidth;
+
+	// Table of normal numbers (Box-Muller) indexed by xorshift
+	static float normal[65536];
+	static bool bNormal = false;
+	if (!bNormal) {
+		uint32_t s = 88172645u;
+		for (int i = 0; i < 65536; i += 2) {
+			float u[2];
+			for (float &v : u) {
+				s ^= s << 13;
+				s ^= s >> 17;
+				s ^= s << 5;
+				v = ((float)(s >> 8) + 0.5f) / 16777216.0f;
+			}
+			float r = sqrtf(-2.0f*logf(u[0]));
+			normal[i] = r*cosf(2.0f*pi*u[1]);
+			normal[i+1] = r*sinf(2.0f*pi*u[1]);
+		}
+		bNormal = true;
+	}
+	auto gaussian = [&seed]() {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return normal[seed >> 16];
+	};
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			float v[3];
+			float base = 40.0f + 150.0f*(float)x/(float)width;
+			base += (((x >> 2) ^ (y >> 2)) & 1) ? 12.0f : -12.0f;
+			v[0] = base;
+			v[1] = base*0.8f + 20.0f;
+			v[2] = 220.0f - base*0.6f;
+			if (y > height*2/3) {
+				float g = 128.0f + 80.0f*sinf(2.0f*pi*(float)(x + frame*2)/24.0f);
+				v[0] = v[1] = v[2] = g;
+			}
+			if (x >= barX && x < barX + barWidth && y > height/6 && y < height*2/3) {
+				v[0] = 230.0f;
+				v[1] = 200.0f;
+				v[2] = 60.0f;
+			}
+
+			size_t i = ((size_t)y*width + x)*4;
+			for (int ch = 0; ch < 3; ch++) {
+				clean[i+ch] = Store(v[ch]/255.0f);
+				noisy[i+ch] = Store((v[ch] + gaussian()*sigma)/255.0f);
+			}
+			clean[i+3] = 255;
+			noisy[i+3] = 255;
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: Psnr
+double denoiseCpu::Psnr(const unsigned char* a, const unsigned char* b,
+	int width, int height, const unsigned char* mask, unsigned char value)
+{
+	if (!a || !b || width <= 0 || height <= 0)
+		return 0.0;
+
+	double sum = 0.0;
+	size_t count = 0;
+	for (size_t i = 0; i < (size_t)width*height; i++) {
+		if (mask && mask[i] != value)
+			continue;
+		for (int ch = 0; ch < 3; ch++) {
+			double d = (double)a[i*4+ch] - (double)b[i*4+ch];
+			sum += d*d;
+		}
+		count += 3;
+	}
+	if (count == 0)
+		return 0.0;
+	if (sum == 0.0)
+		return 99.0;
+	return 10.0*log10(255.0*255.0*(double)count/sum);
+}
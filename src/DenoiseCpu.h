@@ -0,0 +1,58 @@
+/*
+
+	DenoiseCpu.h
+
+	Spout Video Player
+
+	CPU reference of the temporal denoise compute shader.
+
+	The same motion masked recursive filter as spoutShaders::DenoiseAdjust
+	on rgba frames in memory, without the adjustments. With a synthetic
+	noisy sequence and PSNR for the quality and timing benchmarks of the
+	player (command line "-denoisebench") and tools/rawtool "denoise".
+	It has no dependencies so that it can be used without a GL context.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <cstdint>
+
+class denoiseCpu {
+
+	public:
+
+		// Filter a frame of rgba pixels with the history
+		//   history  - denoised previous frame
+		//   strength - 0 - 1 (0 copies the source)
+		//   bUpdate  - keep the result in the history
+		static void Frame(const unsigned char* src, unsigned char* history,
+			unsigned char* dst, int width, int height, float strength, bool bUpdate = true);
+
+		// Frame of a test sequence with static detail, a moving bar and
+		// a scrolling grating, and the same frame with gaussian noise.
+		//   sigma - noise standard deviation (0 - 255)
+		//   seed  - noise generator state, updated for the next frame
+		static void Synthetic(unsigned char* clean, unsigned char* noisy,
+			int width, int height, int frame, float sigma, uint32_t &seed);
+
+		// Peak signal to noise ratio of rgb (dB).
+		// If mask is not null, only where it is equal to value.
+		static double Psnr(const unsigned char* a, const unsigned char* b,
+			int width, int height, const unsigned char* mask = nullptr, unsigned char value = 1);
+
+};
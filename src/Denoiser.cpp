@@ -0,0 +1,176 @@
+/*
+
+	Denoiser.cpp
+
+	Spout Video Player
+
+	Temporal noise reduction of movie frames.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "Denoiser.h"
+#include "DenoiseCpu.h" // For the synthetic sequence
+
+//---------------------------------------------------------
+// Function: Start
+void temporalDenoise::Start()
+{
+	m_bStart = true;
+}
+
+//---------------------------------------------------------
+// Function: Release
+void temporalDenoise::Release()
+{
+	m_history.clear();
+	m_width = 0;
+	m_height = 0;
+	Start();
+}
+
+//---------------------------------------------------------
+// Function: Process
+// The first frame is copied to the history without filtering.
+bool temporalDenoise::Process(spoutShaders &shaders, GLuint TextureID,
+	unsigned int width, unsigned int height, float strength, bool bUpdate,
+	float brightness, float contrast, float saturation, float gamma)
+{
+	if (TextureID == 0 || width == 0 || height == 0)
+		return false;
+
+	if (width != m_width || height != m_height) {
+		m_history.allocate(width, height, GL_RGBA8);
+		m_width = width;
+		m_height = height;
+		Start();
+	}
+
+	if (m_bStart) {
+		strength = 0.0f;
+		bUpdate = true;
+		m_bStart = false;
+	}
+
+	return shaders.DenoiseAdjust(TextureID, m_history.getTextureData().textureID, TextureID,
+		width, height, strength, bUpdate, brightness, contrast, saturation, gamma);
+}
+
+//---------------------------------------------------------
+// Function: Benchmark
+// Each frame of the sequence is denoised with a history for each
+// strength. GPU time is measured with a timer query for each pass
+// and the results are read back for PSNR against the clean frame.
+std::string temporalDenoise::Benchmark(spoutShaders &shaders,
+	unsigned int width, unsigned int height, int frames, float sigma)
+{
+	if (width == 0 || height == 0 || frames < 2)
+		return "";
+
+	const float strengths[] = { 0.25f, 0.5f, 0.75f, 1.0f };
+	const int N = 4;
+
+	size_t size = (size_t)width*height*4;
+	std::vector<unsigned char> clean(size), noisy(size), lastClean(size);
+	std::vector<unsigned char> moving((size_t)width*height);
+
+	ofTexture source, adjusted;
+	source.allocate(width, height, GL_RGBA8);
+	adjusted.allocate(width, height, GL_RGBA8);
+	temporalDenoise denoise[N];
+	ofTexture output[N];
+	for (int i = 0; i < N; i++)
+		output[i].allocate(width, height, GL_RGBA8);
+
+	GLuint query = 0;
+	glGenQueries(1, &query);
+	auto elapsed = [query]() {
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+		return (double)nanoseconds / 1000000.0;
+	};
+
+	double noisyDb[3]{};
+	double db[N][3]{};
+	double adjustMsec = 0.0;
+	double denoiseMsec[N]{};
+	int count = 0;
+	uint32_t seed = 2463534242u;
+	ofPixels pixels;
+
+	for (int f = 0; f < frames; f++) {
+		denoiseCpu::Synthetic(clean.data(), noisy.data(), width, height, f, sigma, seed);
+		source.loadData(noisy.data(), width, height, GL_RGBA);
+		GLuint SourceID = source.getTextureData().textureID;
+
+		// Adjust alone for the time without the denoise
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		shaders.Adjust(SourceID, adjusted.getTextureData().textureID,
+			width, height, 0.0f, 1.0f, 1.0f, 1.0f);
+		glEndQuery(GL_TIME_ELAPSED);
+		adjustMsec += elapsed();
+
+		for (int i = 0; i < N; i++) {
+			GLuint DestID = output[i].getTextureData().textureID;
+			shaders.Copy(SourceID, DestID, width, height);
+			glBeginQuery(GL_TIME_ELAPSED, query);
+			denoise[i].Process(shaders, DestID, width, height, strengths[i], true,
+				0.0f, 1.0f, 1.0f, 1.0f);
+			glEndQuery(GL_TIME_ELAPSED);
+			if (f > 0)
+				denoiseMsec[i] += elapsed();
+		}
+
+		// Quality after the first frame, which starts the history
+		if (f > 0) {
+			for (size_t i = 0; i < moving.size(); i++)
+				moving[i] = (memcmp(&clean[i*4], &lastClean[i*4], 3) != 0) ? 2 : 1;
+
+			// Noisy frame
+			adjusted.readToPixels(pixels);
+			for (int i = 0; i < 3; i++)
+				noisyDb[i] += denoiseCpu::Psnr(clean.data(), pixels.getData(), width, height,
+					(i > 0) ? moving.data() : nullptr, (unsigned char)i);
+			for (int n = 0; n < N; n++) {
+				output[n].readToPixels(pixels);
+				for (int i = 0; i < 3; i++)
+					db[n][i] += denoiseCpu::Psnr(clean.data(), pixels.getData(), width, height,
+						(i > 0) ? moving.data() : nullptr, (unsigned char)i);
+			}
+			count++;
+		}
+		lastClean.swap(clean);
+	}
+
+	glDeleteQueries(1, &query);
+
+	char line[256];
+	sprintf_s(line, 256, "%dx%d, %d frames, noise sigma %.1f\n\n", width, height, frames, sigma);
+	std::string result = line;
+	result += "PSNR (dB)\tall\tstatic\tmoving\tmsec\n";
+	sprintf_s(line, 256, "noisy\t%.2f\t%.2f\t%.2f\t%.3f (adjust)\n",
+		noisyDb[0]/count, noisyDb[1]/count, noisyDb[2]/count, adjustMsec/(double)frames);
+	result += line;
+	for (int n = 0; n < N; n++) {
+		sprintf_s(line, 256, "%.2f\t%.2f\t%.2f\t%.2f\t%.3f\n", strengths[n],
+			db[n][0]/count, db[n][1]/count, db[n][2]/count, denoiseMsec[n]/(double)count);
+		result += line;
+	}
+
+	return result;
+}
@@ -0,0 +1,70 @@
+/*
+
+	Denoiser.h
+
+	Spout Video Player
+
+	Temporal noise reduction of movie frames.
+
+	A recursive filter of each pixel with a history texture that holds
+	the last denoised frame. Where a pixel differs from the history by
+	more than the noise, it is treated as motion and is not filtered,
+	so that moving areas are not smeared. The filter is in the same
+	compute shader pass as brightness, contrast, saturation and gamma
+	(spoutShaders::DenoiseAdjust) and adds one history read and write
+	for each pixel.
+
+	The history starts again with the next frame after Start(), for
+	a new movie or when the denoise is switched on.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutShaders.h" // For the denoise shader
+
+class temporalDenoise {
+
+	public:
+
+		// Clear the history
+		void Start();
+		void Release();
+
+		// Denoise and adjust the texture in place
+		//   strength - 0 - 1
+		//   bUpdate  - false to process the same frame again,
+		//              e.g. with new adjustments while paused
+		bool Process(spoutShaders &shaders, GLuint TextureID,
+			unsigned int width, unsigned int height, float strength, bool bUpdate,
+			float brightness, float contrast, float saturation, float gamma);
+
+		// Quality and GPU time for each strength on a synthetic noisy sequence.
+		// PSNR of all, static and moving pixels and the time of the fused
+		// pass compared with the adjust pass alone.
+		static std::string Benchmark(spoutShaders &shaders,
+			unsigned int width, unsigned int height, int frames = 60, float sigma = 8.0f);
+
+	protected :
+
+		ofTexture m_history; // last denoised frame
+		unsigned int m_width = 0;
+		unsigned int m_height = 0;
+		bool m_bStart = true;
+
+};
@@ -0,0 +1,366 @@
+/*
+
+	EffectChain.cpp
+
+	Spout Video Player
+
+	User compute shader effects loaded from files.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "EffectChain.h"
+#include <sstream>
+
+effectChain::~effectChain() {
+	Close();
+}
+
+//---------------------------------------------------------
+// Function: GetStageName
+const char* effectChain::GetStageName(int stage)
+{
+	switch (stage) {
+		case AFTER_DEINTERLACE: return "deinterlace";
+		case AFTER_ADJUST:      return "adjust";
+		case AFTER_BLUR:        return "blur";
+		case AFTER_SHARPEN:     return "sharpen";
+		case AFTER_OUTPUT:      return "output";
+		default: return "";
+	}
+}
+
+//---------------------------------------------------------
+// Function: Open
+// The folder is created if it does not exist
+bool effectChain::Open(const std::string &folder)
+{
+	Close();
+
+	std::error_code ec;
+	std::filesystem::create_directories(folder, ec);
+	if (!std::filesystem::is_directory(folder, ec)) {
+		SpoutLogWarning("effectChain::Open - no folder %s", folder.c_str());
+		return false;
+	}
+
+	m_folder = folder;
+	m_bStop = false;
+	m_thread = std::thread(&effectChain::Watch, this, folder);
+	SpoutLogNotice("effectChain::Open - %s", folder.c_str());
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Close
+void effectChain::Close()
+{
+	if (m_thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bStop = true;
+		}
+		m_wake.notify_all();
+		m_thread.join();
+	}
+	m_loaded.clear();
+	m_folder.clear();
+	Release();
+}
+
+//---------------------------------------------------------
+// Function: IsOpen
+bool effectChain::IsOpen()
+{
+	return m_thread.joinable();
+}
+
+//---------------------------------------------------------
+// Function: Update
+// A new program is compiled for a new source or a new frame size.
+// The last good program is used until it has linked. A program for
+// another frame size is not run.
+bool effectChain::Update(spoutShaders &shaders, unsigned int width, unsigned int height)
+{
+	bool bChanged = false;
+
+	std::vector<loaded> changes;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		changes.swap(m_loaded);
+	}
+
+	for (auto &change : changes) {
+		auto it = std::find_if(m_effects.begin(), m_effects.end(),
+			[&change](const effect &e) { return e.path == change.path; });
+		if (change.source.empty()) {
+			// Removed
+			if (it != m_effects.end()) {
+				if (it->program > 0) glDeleteProgram(it->program);
+				if (it->pending > 0) glDeleteProgram(it->pending);
+				if (it->pendingShader > 0) glDeleteShader(it->pendingShader);
+				m_effects.erase(it);
+				bChanged = true;
+			}
+			continue;
+		}
+		if (it == m_effects.end()) {
+			m_effects.push_back(effect());
+			it = m_effects.end() - 1;
+			it->path = change.path;
+		}
+		it->desc = change.desc;
+		it->source = change.source;
+		it->bCompile = true;
+		it->bError = false;
+		bChanged = true; // uniforms or stage may have changed
+	}
+
+	for (auto &e : m_effects) {
+
+		if (e.pending > 0) {
+			std::string log;
+			int status = shaders.EffectStatus(e.pending, e.pendingShader, log);
+			if (status > 0) {
+				if (e.program > 0)
+					glDeleteProgram(e.program);
+				e.program = e.pending;
+				e.width = e.pendingWidth;
+				e.height = e.pendingHeight;
+				e.pending = 0;
+				bChanged = true;
+				SpoutLogNotice("effectChain - compiled %s", e.path.c_str());
+			}
+			else if (status < 0) {
+				e.bError = true;
+				SpoutLogWarning("effectChain - %s failed, last program kept\n%s",
+					e.path.c_str(), log.c_str());
+			}
+		}
+
+		if (e.pending == 0 && e.desc.bEnabled
+			&& (e.bCompile || (e.program > 0 && !e.bError
+				&& (e.width != width || e.height != height)))) {
+			e.pending = shaders.CreateEffect(e.source, width, height, e.pendingShader);
+			e.pendingWidth = width;
+			e.pendingHeight = height;
+			e.bCompile = false;
+			if (e.pending == 0)
+				e.bError = true;
+		}
+	}
+
+	if (bChanged) {
+		Sort();
+		m_version++;
+	}
+
+	return bChanged;
+}
+
+//---------------------------------------------------------
+// Function: Process
+// Each effect writes to a work texture that is copied back
+// so that effects can read neighbouring pixels.
+void effectChain::Process(spoutShaders &shaders, int stage, GLuint TextureID,
+	unsigned int width, unsigned int height)
+{
+	if (TextureID == 0 || width == 0 || height == 0)
+		return;
+
+	for (auto &e : m_effects) {
+		if (e.desc.stage != stage || !e.desc.bEnabled || e.program == 0
+			|| e.width != width || e.height != height)
+			continue;
+		if ((unsigned int)m_output.getWidth() != width || (unsigned int)m_output.getHeight() != height)
+			m_output.allocate(width, height, GL_RGBA8);
+		GLuint OutputID = m_output.getTextureData().textureID;
+		if (shaders.Effect(e.program, TextureID, OutputID, width, height, e.desc.uniforms))
+			shaders.Copy(OutputID, TextureID, width, height);
+	}
+}
+
+//---------------------------------------------------------
+// Function: HasEffects
+bool effectChain::HasEffects()
+{
+	for (auto &e : m_effects) {
+		if (e.desc.bEnabled && e.program > 0)
+			return true;
+	}
+	return false;
+}
+
+//---------------------------------------------------------
+// Function: GetVersion
+int effectChain::GetVersion()
+{
+	return m_version;
+}
+
+//---------------------------------------------------------
+// Function: GetStatus
+std::string effectChain::GetStatus()
+{
+	std::string status;
+	int errors = 0;
+	for (auto &e : m_effects) {
+		if (e.bError)
+			errors++;
+		if (!e.desc.bEnabled || e.program == 0)
+			continue;
+		if (!status.empty())
+			status += ", ";
+		status += e.desc.name;
+	}
+	if (status.empty())
+		status = "none";
+	if (errors > 0)
+		status += " : " + std::to_string(errors) + (errors == 1 ? " error" : " errors");
+	return status;
+}
+
+//---------------------------------------------------------
+// Function: Release
+void effectChain::Release()
+{
+	for (auto &e : m_effects) {
+		if (e.program > 0) glDeleteProgram(e.program);
+		if (e.pending > 0) glDeleteProgram(e.pending);
+		if (e.pendingShader > 0) glDeleteShader(e.pendingShader);
+	}
+	m_effects.clear();
+	m_output.clear();
+	m_version++;
+}
+
+//---------------------------------------------------------
+// Function: Watch
+// Worker thread. A file that cannot be read, for example
+// while it is being written, is tried again at the next check.
+void effectChain::Watch(std::string folder)
+{
+	std::map<std::string, std::filesystem::file_time_type> times;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_bStop) {
+		lock.unlock();
+
+		std::vector<loaded> changes;
+		std::map<std::string, std::filesystem::file_time_type> found;
+		std::error_code ec;
+		for (auto &entry : std::filesystem::directory_iterator(folder, ec)) {
+			if (!entry.is_regular_file(ec) || entry.path().extension() != ".glsl")
+				continue;
+			std::string path = entry.path().string();
+			std::filesystem::file_time_type modified = entry.last_write_time(ec);
+			if (ec)
+				continue;
+			auto it = times.find(path);
+			if (it != times.end() && it->second == modified) {
+				found[path] = modified;
+				continue;
+			}
+			std::string text = spoutShaders::GetFileString(path.c_str());
+			if (text.empty()) {
+				if (it != times.end())
+					found[path] = std::filesystem::file_time_type(); // not removed
+				continue;
+			}
+			found[path] = modified;
+			changes.push_back({ path, text, Parse(text, path) });
+		}
+		for (auto &t : times) {
+			if (found.find(t.first) == found.end())
+				changes.push_back({ t.first, "", header() });
+		}
+		times.swap(found);
+
+		lock.lock();
+		for (auto &change : changes)
+			m_loaded.push_back(change);
+		m_wake.wait_for(lock, std::chrono::milliseconds(500), [this] { return m_bStop; });
+	}
+}
+
+//---------------------------------------------------------
+// Function: Parse
+// Header lines "// @key value"
+effectChain::header effectChain::Parse(const std::string &text, const std::string &path)
+{
+	header desc;
+	desc.name = std::filesystem::path(path).stem().string();
+
+	std::istringstream lines(text);
+	std::string line;
+	while (std::getline(lines, line)) {
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == std::string::npos || line.compare(pos, 4, "// @") != 0)
+			continue;
+		std::istringstream words(line.substr(pos + 4));
+		std::string key;
+		words >> key;
+		if (key == "effect") {
+			std::string name;
+			std::getline(words >> std::ws, name);
+			while (!name.empty() && isspace((unsigned char)name.back()))
+				name.pop_back();
+			if (!name.empty())
+				desc.name = name;
+		}
+		else if (key == "after") {
+			std::string stage;
+			words >> stage;
+			for (int i = 0; i < EFFECT_STAGES; i++) {
+				if (stage == GetStageName(i))
+					desc.stage = i;
+			}
+		}
+		else if (key == "order") {
+			words >> desc.order;
+		}
+		else if (key == "uniform") {
+			std::string name;
+			float value = 0.0f;
+			if (words >> name >> value && desc.uniforms.size() < 8)
+				desc.uniforms.push_back(value);
+		}
+		else if (key == "enabled") {
+			int enabled = 1;
+			words >> enabled;
+			desc.bEnabled = (enabled != 0);
+		}
+	}
+
+	return desc;
+}
+
+//---------------------------------------------------------
+// Function: Sort
+// By stage, then order, then name
+void effectChain::Sort()
+{
+	std::stable_sort(m_effects.begin(), m_effects.end(), [](const effect &a, const effect &b) {
+		if (a.desc.stage != b.desc.stage)
+			return a.desc.stage < b.desc.stage;
+		if (a.desc.order != b.desc.order)
+			return a.desc.order < b.desc.order;
+		return a.desc.name < b.desc.name;
+	});
+}
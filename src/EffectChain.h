@@ -0,0 +1,141 @@
+/*
+
+	EffectChain.h
+
+	Spout Video Player
+
+	User compute shader effects loaded from files.
+
+	Effect files "*.glsl" in the "shaders" data folder are compute
+	shaders in the same form as those in SpoutShaders.h, without the
+	version and work group size which are added for the frame size :
+
+		layout(rgba8, binding=0) uniform image2D src; // frame
+		layout(rgba8, binding=1) uniform writeonly image2D dst; // result
+		layout(location = 0) uniform float amount; // first @uniform
+
+	Work groups may extend beyond the image and the shader should
+	check the image size. Comment lines starting with "// @" describe
+	the effect :
+
+		// @effect  name shown (default the file name)
+		// @after   deinterlace, adjust, blur, sharpen or output (default)
+		// @order   order of effects after the same stage (default 0)
+		// @uniform name value - float uniforms at locations 0 - 7 in turn
+		// @enabled 0 to ignore the effect
+
+	A worker thread checks the folder twice a second and reads and
+	parses new or changed files. Programs are compiled by the render
+	thread, in parallel by the driver if it supports it, and a new
+	program replaces the old one only when it has linked. A file that
+	fails to compile keeps the last good program and the errors are
+	logged.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutShaders.h" // For effect programs
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+
+class effectChain {
+
+	public:
+
+		// Stage of the pipeline that an effect follows
+		enum { AFTER_DEINTERLACE, AFTER_ADJUST, AFTER_BLUR, AFTER_SHARPEN, AFTER_OUTPUT, EFFECT_STAGES };
+		static const char* GetStageName(int stage);
+
+		~effectChain();
+
+		// Start or stop watching a folder of effect files
+		bool Open(const std::string &folder);
+		void Close();
+		bool IsOpen();
+
+		// Take changed files from the worker and compile them.
+		// Returns true if the effects that run have changed.
+		bool Update(spoutShaders &shaders, unsigned int width, unsigned int height);
+
+		// Run the effects that follow a stage on the texture in place
+		void Process(spoutShaders &shaders, int stage, GLuint TextureID,
+			unsigned int width, unsigned int height);
+
+		// There are effects with programs
+		bool HasEffects();
+
+		// Changes each time the effects that run change
+		int GetVersion();
+
+		// Names of the effects in order and the number with errors
+		std::string GetStatus();
+
+		// Delete the programs and the work texture
+		void Release();
+
+	protected :
+
+		// Effect description from the file header
+		struct header {
+			std::string name;
+			int stage = AFTER_OUTPUT;
+			int order = 0;
+			bool bEnabled = true;
+			std::vector<float> uniforms;
+		};
+
+		struct effect {
+			std::string path;
+			header desc;
+			std::string source;
+			GLuint program = 0;        // last good program
+			unsigned int width = 0;    // size of the work groups of the program
+			unsigned int height = 0;
+			GLuint pending = 0;        // program being compiled
+			GLuint pendingShader = 0;
+			unsigned int pendingWidth = 0;
+			unsigned int pendingHeight = 0;
+			bool bError = false;       // the last source failed
+			bool bCompile = false;     // source not compiled yet
+		};
+		std::vector<effect> m_effects; // render thread only
+		ofTexture m_output;
+		int m_version = 0;
+
+		// Files read by the worker
+		struct loaded {
+			std::string path;
+			std::string source; // empty if removed
+			header desc;
+		};
+		std::vector<loaded> m_loaded;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::thread m_thread;
+		bool m_bStop = false;
+		std::string m_folder;
+
+		void Watch(std::string folder);
+		static header Parse(const std::string &text, const std::string &path);
+		void Sort();
+
+};
@@ -0,0 +1,134 @@
+/*
+
+	FrameReadback.cpp
+
+	Spout Video Player
+
+	Frame pixels read from a texture without waiting for the GPU.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "FrameReadback.h"
+
+frameReadback::~frameReadback() {
+	Release();
+}
+
+//---------------------------------------------------------
+// Function: Start
+void frameReadback::Start()
+{
+	for (auto &rb : m_ring) {
+		if (rb.fence)
+			glDeleteSync(rb.fence);
+		rb.fence = nullptr;
+	}
+	m_next = 0;
+	m_read = 0;
+}
+
+//---------------------------------------------------------
+// Function: Release
+void frameReadback::Release()
+{
+	Start();
+	for (auto &rb : m_ring) {
+		if (rb.buffer > 0)
+			glDeleteBuffers(1, &rb.buffer);
+		rb.buffer = 0;
+		rb.size = 0;
+	}
+}
+
+//---------------------------------------------------------
+// Function: Read
+// The copy to the buffer is queued and returns at once
+bool frameReadback::Read(ofTexture &texture)
+{
+	if (!texture.isAllocated())
+		return false;
+
+	// All the buffers are waiting to be read
+	readback &rb = m_ring[m_next];
+	if (rb.fence)
+		return false;
+
+	int width = (int)texture.getWidth();
+	int height = (int)texture.getHeight();
+	GLsizeiptr size = (GLsizeiptr)width*height*4;
+
+	if (rb.buffer == 0)
+		glGenBuffers(1, &rb.buffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.buffer);
+	if (rb.size != size) {
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+		rb.size = size;
+	}
+	rb.width = width;
+	rb.height = height;
+
+	GLenum target = texture.getTextureData().textureTarget;
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glBindTexture(target, texture.getTextureData().textureID);
+	glGetTexImage(target, 0, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+	glBindTexture(target, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	rb.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_next = (m_next + 1) % RING;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Update
+// Buffers are checked in the order they were used
+bool frameReadback::Update(ofPixels &pixels)
+{
+	int latest = -1;
+	while (m_ring[m_read].fence) {
+		readback &rb = m_ring[m_read];
+		GLenum status = glClientWaitSync(rb.fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			break;
+		glDeleteSync(rb.fence);
+		rb.fence = nullptr;
+		latest = m_read;
+		m_read = (m_read + 1) % RING;
+	}
+	if (latest < 0)
+		return false;
+
+	readback &rb = m_ring[latest];
+	if ((int)pixels.getWidth() != rb.width || (int)pixels.getHeight() != rb.height
+		|| pixels.getNumChannels() != 4)
+		pixels.allocate(rb.width, rb.height, OF_PIXELS_RGBA);
+
+	bool bRead = false;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.buffer);
+	void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, rb.size, GL_MAP_READ_BIT);
+	if (data) {
+		memcpy(pixels.getData(), data, (size_t)rb.size);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		bRead = true;
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	return bRead;
+}
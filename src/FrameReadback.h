@@ -0,0 +1,69 @@
+/*
+
+	FrameReadback.h
+
+	Spout Video Player
+
+	Frame pixels read from a texture without waiting for the GPU.
+
+	The texture is copied to a ring of pixel pack buffers with a fence
+	for each, in the same way as the levels readback (AutoLevels.h).
+	A buffer is mapped only when its fence has signalled, so the pixels
+	are those of a frame one or two cycles before. Used for NDI output
+	of frames that exist only in the fbo, e.g. deinterlaced, blended
+	slow motion or denoised frames and frames at the fixed output rate.
+	A texture is not read while all the buffers are waiting.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+
+class frameReadback {
+
+	public:
+
+		~frameReadback();
+
+		// Discard frames waiting, e.g. for a new source
+		void Start();
+		void Release();
+
+		// Copy a texture to the next free buffer
+		bool Read(ofTexture &texture);
+
+		// Pixels of the latest completed frame without waiting.
+		// Older completed frames are skipped.
+		// Returns false if no frame has completed.
+		bool Update(ofPixels &pixels);
+
+	protected :
+
+		static const int RING = 3;
+		struct readback {
+			GLuint buffer = 0;
+			GLsync fence = nullptr;
+			GLsizeiptr size = 0;
+			int width = 0;
+			int height = 0;
+		};
+		readback m_ring[RING];
+		int m_next = 0; // next buffer to use
+		int m_read = 0; // oldest buffer waiting
+
+};
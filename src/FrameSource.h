@@ -0,0 +1,64 @@
+/*
+
+	FrameSource.h
+
+	Spout Video Player
+
+	Frames played by the application instead of the movie decoder.
+
+	A source has a fixed number of frames of the same size.
+	The frames are uploaded to a texture at the source frame rate.
+	Frames are rgba or nv12, a full size Y plane followed by a half
+	size plane of interleaved U and V, converted on the GPU.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+class frameSource {
+
+	public:
+
+		virtual ~frameSource() {}
+
+		// Pixel format of the frame data
+		enum { FRAME_RGBA, FRAME_NV12 };
+
+		// Number of frames
+		virtual int GetFrames() = 0;
+
+		// Frame size
+		virtual int GetFrameWidth() = 0;
+		virtual int GetFrameHeight() = 0;
+
+		// Frame rate, zero if not known
+		virtual double GetFrameRate() = 0;
+
+		// Pixels of a frame or nullptr if not available yet
+		virtual const unsigned char* GetFrameData(int frame) = 0;
+
+		// FRAME_RGBA or FRAME_NV12
+		virtual int GetFrameFormat() { return FRAME_RGBA; }
+
+		// Hint that a frame will be needed soon
+		virtual void Prefetch(int /*frame*/) {}
+
+		// Frames are played with a step, e.g. for fast playback.
+		// Only every step frame is read ahead.
+		virtual void SetStep(int /*step*/) {}
+
+};
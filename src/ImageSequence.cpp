@@ -0,0 +1,389 @@
+/*
+
+	ImageSequence.cpp
+
+	Spout Video Player
+
+	Numbered image files played as a movie.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "ImageSequence.h"
+
+imageSequence::imageSequence() {
+}
+
+imageSequence::~imageSequence() {
+	Close();
+}
+
+//---------------------------------------------------------
+// Function: Open
+// Find the files with the same name and a different number
+bool imageSequence::Open(std::string path, double fps, int nThreads)
+{
+	Close();
+
+	if (!IsImageFile(path))
+		return false;
+
+	// Number at the end of the name
+	std::string folder = ofFilePath::getEnclosingDirectory(path, false);
+	std::string ext = ofToLower(ofFilePath::getFileExt(path));
+	std::string name = ofFilePath::getBaseName(path);
+	size_t pos = name.find_last_not_of("0123456789");
+	pos = (pos == std::string::npos) ? 0 : pos + 1;
+	if (pos >= name.length())
+		return false;
+	std::string prefix = name.substr(0, pos);
+
+	// Files with the same name and extension in numerical order
+	std::vector<std::pair<long long, std::string>> numbered;
+	ofDirectory dir(folder);
+	dir.allowExt(ext);
+	dir.listDir();
+	for (size_t i = 0; i < dir.size(); i++) {
+		std::string base = ofFilePath::getBaseName(dir.getName(i));
+		if (base.length() <= prefix.length() || base.compare(0, prefix.length(), prefix) != 0)
+			continue;
+		std::string number = base.substr(prefix.length());
+		if (number.find_first_not_of("0123456789") != std::string::npos)
+			continue;
+		numbered.push_back(std::make_pair(atoll(number.c_str()), dir.getPath(i)));
+	}
+	if (numbered.size() < 2)
+		return false;
+	std::sort(numbered.begin(), numbered.end());
+	for (auto &file : numbered)
+		m_files.push_back(file.second);
+
+	// The first frame sets the size
+	ofPixels first;
+	if (!Decode(0, first)) {
+		SpoutLogError("imageSequence::Open - could not decode %s", m_files[0].c_str());
+		m_files.clear();
+		return false;
+	}
+	m_width = (int)first.getWidth();
+	m_height = (int)first.getHeight();
+	m_fps = (fps > 0.0) ? fps : 30.0;
+
+	// Enough frames for every thread to decode ahead
+	m_pool.Start(nThreads);
+	int nSlots = m_pool.GetThreads()*2 + 2;
+	if (nSlots < 4)
+		nSlots = 4;
+	m_ring.resize(nSlots);
+	m_ring[0].frame = 0;
+	m_ring[0].bReady = true;
+	m_ring[0].pixels.swap(first);
+	Prefetch(0);
+
+	SpoutLogNotice("imageSequence::Open - %s (%d frames %dx%d, %d threads)",
+		m_files[0].c_str(), (int)m_files.size(), m_width, m_height, m_pool.GetThreads());
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Close
+void imageSequence::Close()
+{
+	// Wait for the decoders before the ring is removed
+	m_pool.Stop();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_ring.clear();
+	m_files.clear();
+	m_width = 0;
+	m_height = 0;
+}
+
+//---------------------------------------------------------
+// Function: IsOpen
+bool imageSequence::IsOpen()
+{
+	return !m_files.empty();
+}
+
+//---------------------------------------------------------
+// Function: GetFrames
+int imageSequence::GetFrames()
+{
+	return (int)m_files.size();
+}
+
+//---------------------------------------------------------
+// Function: GetFrameWidth
+int imageSequence::GetFrameWidth()
+{
+	return m_width;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameHeight
+int imageSequence::GetFrameHeight()
+{
+	return m_height;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameRate
+double imageSequence::GetFrameRate()
+{
+	return m_fps;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameData
+// Pixels of a decoded frame. The pointer remains valid
+// until Prefetch moves the ring past the frame.
+const unsigned char* imageSequence::GetFrameData(int frame)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto &s : m_ring) {
+		if (s.frame == frame && s.bReady)
+			return s.pixels.getData();
+	}
+	return nullptr;
+}
+
+//---------------------------------------------------------
+// Function: Prefetch
+// Decode the frames from the one given up to the size of the ring.
+// The slot of the frame before it is kept because that frame is
+// being played. Frames wrap to the start for a loop. For fast
+// playback only every step frame is decoded.
+void imageSequence::Prefetch(int first)
+{
+	int nFrames = (int)m_files.size();
+	if (nFrames == 0 || m_ring.empty())
+		return;
+
+	int step = (m_step < nFrames) ? m_step : 1;
+	first = ((first % nFrames) + nFrames) % nFrames;
+	int previous = ((first - step) % nFrames + nFrames) % nFrames;
+	int count = (int)m_ring.size() - 1;
+	if (count*step > nFrames)
+		count = nFrames / step;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (int i = 0; i < count; i++) {
+		int frame = (first + i*step) % nFrames;
+
+		bool bFound = false;
+		for (auto &s : m_ring) {
+			if (s.frame == frame) {
+				bFound = true;
+				break;
+			}
+		}
+		if (bFound)
+			continue;
+
+		// Re-use a slot with a frame that is no longer needed
+		for (int index = 0; index < (int)m_ring.size(); index++) {
+			slot &s = m_ring[index];
+			if (s.frame < 0 || !InWindow(s.frame, previous, count + 1, step)) {
+				s.frame = frame;
+				s.bReady = false;
+				m_pool.Submit([this, index, frame] { DecodeSlot(index, frame); });
+				break;
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: SetStep
+void imageSequence::SetStep(int step)
+{
+	m_step = step;
+	if (m_step < 1)
+		m_step = 1;
+}
+
+//---------------------------------------------------------
+// Function: GetThreads
+int imageSequence::GetThreads()
+{
+	return m_pool.GetThreads();
+}
+
+//---------------------------------------------------------
+// Function: GetReady
+// Number of frames decoded in the ring
+int imageSequence::GetReady()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	int nReady = 0;
+	for (auto &s : m_ring) {
+		if (s.bReady)
+			nReady++;
+	}
+	return nReady;
+}
+
+//---------------------------------------------------------
+// Function: Benchmark
+// Decode the first frames with 1, 2, 4 ... threads.
+// Returns a line for each test with frames per second
+// and the gain over one thread.
+std::string imageSequence::Benchmark(int maxThreads, int nFrames)
+{
+	std::string result;
+	if (m_files.empty())
+		return result;
+
+	if (nFrames > (int)m_files.size())
+		nFrames = (int)m_files.size();
+	if (maxThreads <= 0)
+		maxThreads = (int)std::thread::hardware_concurrency();
+	if (maxThreads < 1)
+		maxThreads = 1;
+
+	// Read the files once so that the first test is not slowed by the disk
+	{
+		workPool pool;
+		pool.Start(maxThreads);
+		for (int i = 0; i < nFrames; i++)
+			pool.Submit([this, i] { ofPixels pixels; Decode(i, pixels); });
+		pool.Wait();
+	}
+
+	char line[128]{};
+	sprintf_s(line, 128, "%d frames %dx%d\n", nFrames, m_width, m_height);
+	result = line;
+
+	double single = 0.0;
+	for (int threads = 1; ; threads *= 2) {
+		if (threads > maxThreads)
+			threads = maxThreads;
+
+		workPool pool;
+		pool.Start(threads);
+		uint64_t start = ofGetElapsedTimeMicros();
+		for (int i = 0; i < nFrames; i++)
+			pool.Submit([this, i] { ofPixels pixels; Decode(i, pixels); });
+		pool.Wait();
+		double seconds = (double)(ofGetElapsedTimeMicros() - start) / 1000000.0;
+		double fps = (seconds > 0.0) ? (double)nFrames / seconds : 0.0;
+		if (threads == 1)
+			single = fps;
+
+		sprintf_s(line, 128, "%2d threads : %7.1f fps (x%.2f)\n",
+			threads, fps, (single > 0.0) ? fps / single : 0.0);
+		result += line;
+		SpoutLogNotice("imageSequence::Benchmark - %2d threads %7.1f fps", threads, fps);
+
+		if (threads == maxThreads)
+			break;
+	}
+
+	return result;
+}
+
+//---------------------------------------------------------
+// Function: IsImageFile
+bool imageSequence::IsImageFile(std::string path)
+{
+	std::string ext = ofToLower(ofFilePath::getFileExt(path));
+	return (ext == "png" || ext == "tga" || ext == "exr"
+		|| ext == "tif" || ext == "tiff" || ext == "bmp"
+		|| ext == "jpg" || ext == "jpeg" || ext == "dds");
+}
+
+//---------------------------------------------------------
+// Function: LoadPixels
+// Load an image file as rgba.
+// Floating point exr is converted to 8 bit.
+bool imageSequence::LoadPixels(std::string path, ofPixels &pixels)
+{
+	bool bLoaded = false;
+	if (ofToLower(ofFilePath::getFileExt(path)) == "exr") {
+		ofFloatPixels floatPixels;
+		if (ofLoadImage(floatPixels, path)) {
+			pixels = floatPixels;
+			bLoaded = true;
+		}
+	}
+	else {
+		bLoaded = ofLoadImage(pixels, path);
+	}
+	if (!bLoaded)
+		return false;
+
+	if (pixels.getNumChannels() != 4)
+		pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Decode
+// Runs on the pool threads
+bool imageSequence::Decode(int frame, ofPixels &pixels)
+{
+	if (!LoadPixels(m_files[frame], pixels))
+		return false;
+
+	// All frames must be the size of the first
+	if (m_width > 0 && ((int)pixels.getWidth() != m_width || (int)pixels.getHeight() != m_height))
+		return false;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: DecodeSlot
+// Decode a frame into the ring. Runs on the pool threads.
+void imageSequence::DecodeSlot(int index, int frame)
+{
+	// The slot may have been re-used after a seek
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_ring[index].frame != frame || m_ring[index].bReady)
+			return;
+	}
+
+	ofPixels pixels;
+	if (!Decode(frame, pixels)) {
+		// A blank frame so that playback does not wait for it
+		SpoutLogWarning("imageSequence - could not decode %s", m_files[frame].c_str());
+		pixels.allocate(m_width, m_height, OF_PIXELS_RGBA);
+		pixels.set(0);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_ring[index].frame == frame) {
+		m_ring[index].pixels.swap(pixels);
+		m_ring[index].bReady = true;
+	}
+}
+
+//---------------------------------------------------------
+// Function: InWindow
+// The frame is one of count frames a step apart from the first,
+// allowing for wrap
+bool imageSequence::InWindow(int frame, int first, int count, int step)
+{
+	int nFrames = (int)m_files.size();
+	int distance = ((frame - first) % nFrames + nFrames) % nFrames;
+	return (distance % step == 0 && distance / step < count);
+}
@@ -0,0 +1,95 @@
+/*
+
+	ImageSequence.h
+
+	Spout Video Player
+
+	Numbered image files played as a movie.
+
+	The files are found from any one of them by the number at the end
+	of the name, for example "shot_0001.png", "shot_0002.png" ...
+	Frames ahead of the one being played are decoded by a thread pool
+	into a ring of frames. Alpha is retained.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutUtils.h" // For logging
+#include "FrameSource.h"
+#include "WorkPool.h"
+
+using namespace spoututils;
+
+class imageSequence : public frameSource {
+
+	public:
+
+		imageSequence();
+		~imageSequence();
+
+		// Find the numbered files and decode the first frame.
+		// Zero threads uses all but one of the processor cores.
+		bool Open(std::string path, double fps, int nThreads = 0);
+		void Close();
+		bool IsOpen();
+
+		// frameSource
+		int GetFrames();
+		int GetFrameWidth();
+		int GetFrameHeight();
+		double GetFrameRate();
+		const unsigned char* GetFrameData(int frame);
+		void Prefetch(int frame);
+		void SetStep(int step);
+
+		// Decoder threads and frames decoded ahead
+		int GetThreads();
+		int GetReady();
+
+		// Decode rate for 1, 2, 4 ... threads up to the maximum
+		std::string Benchmark(int maxThreads, int nFrames = 60);
+
+		// File has an image extension
+		static bool IsImageFile(std::string path);
+
+		// Load an image file as rgba
+		static bool LoadPixels(std::string path, ofPixels &pixels);
+
+	protected :
+
+		struct slot {
+			int frame = -1;      // frame assigned to the slot
+			bool bReady = false; // pixels decoded
+			ofPixels pixels;
+		};
+
+		std::vector<std::string> m_files;
+		std::vector<slot> m_ring;
+		std::mutex m_mutex; // ring access
+		workPool m_pool;
+		int m_width = 0;
+		int m_height = 0;
+		double m_fps = 30.0;
+		int m_step = 1; // frames between those played
+
+		bool Decode(int frame, ofPixels &pixels);
+		void DecodeSlot(int index, int frame);
+		bool InWindow(int frame, int first, int count, int step = 1);
+
+};
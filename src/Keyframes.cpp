@@ -0,0 +1,240 @@
+/*
+
+	Keyframes.cpp
+
+	Spout Video Player
+
+	Keyframed adjustments over the movie timeline.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "Keyframes.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+//---------------------------------------------------------
+// Function: GetParamName
+const char* keyframes::GetParamName(int param)
+{
+	switch (param) {
+		case KEY_BRIGHTNESS: return "brightness";
+		case KEY_CONTRAST:   return "contrast";
+		case KEY_SATURATION: return "saturation";
+		case KEY_GAMMA:      return "gamma";
+		case KEY_BLUR:       return "blur";
+		case KEY_SHARPNESS:  return "sharpness";
+		default: return "";
+	}
+}
+
+//---------------------------------------------------------
+// Function: Load
+// Lines that cannot be read are skipped
+bool keyframes::Load(const std::string &path)
+{
+	Clear();
+	m_path = path;
+
+	std::error_code ec;
+	m_modified = std::filesystem::last_write_time(path, ec);
+	std::ifstream file(path);
+	if (ec || !file.is_open())
+		return false;
+
+	std::vector<key> keys[KEY_PARAMS];
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream words(line);
+		std::string name, mode;
+		key k{};
+		if (line.empty() || line[0] == '#' || !(words >> k.time >> name >> k.value))
+			continue;
+		words >> mode;
+		k.bBezier = (mode == "bezier");
+		for (int i = 0; i < KEY_PARAMS; i++) {
+			if (name == GetParamName(i))
+				keys[i].push_back(k);
+		}
+	}
+
+	for (int i = 0; i < KEY_PARAMS; i++)
+		Build(m_tracks[i], keys[i]);
+	m_version++;
+
+	return IsLoaded();
+}
+
+//---------------------------------------------------------
+// Function: Clear
+void keyframes::Clear()
+{
+	for (auto &tr : m_tracks) {
+		tr.times.clear();
+		tr.segments.clear();
+		tr.cursor = 0;
+	}
+	m_path.clear();
+	m_modified = std::filesystem::file_time_type{};
+}
+
+//---------------------------------------------------------
+// Function: IsLoaded
+bool keyframes::IsLoaded()
+{
+	return GetKeys() > 0;
+}
+
+//---------------------------------------------------------
+// Function: CheckFile
+// A file created after the movie is opened is also loaded
+bool keyframes::CheckFile(uint64_t msec)
+{
+	if (m_path.empty() || msec - m_checked < 1000)
+		return false;
+	m_checked = msec;
+
+	std::error_code ec;
+	std::filesystem::file_time_type modified = std::filesystem::last_write_time(m_path, ec);
+	if (ec || modified == m_modified)
+		return false;
+
+	std::string path = m_path;
+	Load(path);
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: GetKeys
+int keyframes::GetKeys()
+{
+	size_t keys = 0;
+	for (auto &tr : m_tracks)
+		keys += tr.times.size();
+	return (int)keys;
+}
+
+//---------------------------------------------------------
+// Function: GetPath
+std::string keyframes::GetPath()
+{
+	return m_path;
+}
+
+//---------------------------------------------------------
+// Function: GetVersion
+int keyframes::GetVersion()
+{
+	return m_version;
+}
+
+//---------------------------------------------------------
+// Function: Evaluate
+void keyframes::Evaluate(double time, float values[KEY_PARAMS])
+{
+	for (int p = 0; p < KEY_PARAMS; p++) {
+
+		track &tr = m_tracks[p];
+		size_t n = tr.times.size();
+		if (n == 0)
+			continue;
+
+		// The same segment, the next one, or search
+		size_t i = tr.cursor;
+		if (time < tr.times[i] || (i + 1 < n && time >= tr.times[i + 1])) {
+			if (i + 1 < n && time >= tr.times[i + 1] && (i + 2 >= n || time < tr.times[i + 2])) {
+				i++;
+			}
+			else {
+				i = (size_t)(std::upper_bound(tr.times.begin(), tr.times.end(), time) - tr.times.begin());
+				if (i > 0) i--;
+			}
+			tr.cursor = i;
+		}
+
+		const segment &s = tr.segments[i];
+		float u = (float)((time - s.t0) * s.scale);
+		if (u <= 0.0f) {
+			values[p] = s.c0;
+		}
+		else {
+			if (u > 1.0f) u = 1.0f;
+			values[p] = ((s.c3*u + s.c2)*u + s.c1)*u + s.c0;
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: Build
+// Bezier control points are a third of the way along the segment
+// in the direction of the slope between the keys either side, or
+// flat at the first and last keys. As a cubic in u from 0 to 1 :
+//     c0 = v0, c1 = m0, c2 = 3(v1 - v0) - 2m0 - m1, c3 = 2(v0 - v1) + m0 + m1
+// where m0 and m1 are the slopes scaled by the segment length.
+void keyframes::Build(track &tr, std::vector<key> &keys)
+{
+	tr.times.clear();
+	tr.segments.clear();
+	tr.cursor = 0;
+
+	// The last key for the same time is used
+	std::stable_sort(keys.begin(), keys.end(),
+		[](const key &a, const key &b) { return a.time < b.time; });
+	std::vector<key> sorted;
+	for (auto &k : keys) {
+		if (!sorted.empty() && sorted.back().time == k.time)
+			sorted.back() = k;
+		else
+			sorted.push_back(k);
+	}
+
+	size_t n = sorted.size();
+	tr.times.reserve(n);
+	tr.segments.reserve(n);
+
+	auto slope = [&sorted, n](size_t i) {
+		if (i == 0 || i + 1 >= n)
+			return 0.0;
+		return (double)(sorted[i + 1].value - sorted[i - 1].value)
+			/ (sorted[i + 1].time - sorted[i - 1].time);
+	};
+
+	for (size_t i = 0; i < n; i++) {
+		segment s{};
+		s.t0 = sorted[i].time;
+		s.c0 = sorted[i].value;
+		if (i + 1 < n) {
+			double dt = sorted[i + 1].time - sorted[i].time;
+			double dv = sorted[i + 1].value - sorted[i].value;
+			s.scale = 1.0 / dt;
+			if (sorted[i].bBezier) {
+				double m0 = slope(i) * dt;
+				double m1 = slope(i + 1) * dt;
+				s.c1 = (float)m0;
+				s.c2 = (float)(3.0*dv - 2.0*m0 - m1);
+				s.c3 = (float)(-2.0*dv + m0 + m1);
+			}
+			else {
+				s.c1 = (float)dv;
+			}
+		}
+		tr.times.push_back(s.t0);
+		tr.segments.push_back(s);
+	}
+}
@@ -0,0 +1,107 @@
+/*
+
+	Keyframes.h
+
+	Spout Video Player
+
+	Keyframed adjustments over the movie timeline.
+
+	Keyframes for a movie are in a sidecar text file with the movie
+	name and ".keys" added, e.g. "clip.mp4.keys". Each line is :
+
+		time parameter value [linear|bezier]
+
+	time is in seconds from the start of the movie and the parameter
+	is brightness, contrast, saturation, gamma, blur or sharpness.
+	The interpolation is for the curve to the next key of the same
+	parameter, linear (default) or a smooth bezier with the slope
+	from the keys either side. Lines starting with '#' are comments.
+	Parameters with keys replace the Adjust dialog values. Before the
+	first key and after the last, the value of that key is held.
+
+	Each parameter has the key times in one array for search and the
+	curve as a cubic for each segment in another, so that a value is
+	a few multiplies. The segment of the last value is kept and the
+	next one checked, so that playback is constant time, and a seek
+	is a binary search.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+class keyframes {
+
+	public:
+
+		enum { KEY_BRIGHTNESS, KEY_CONTRAST, KEY_SATURATION, KEY_GAMMA,
+			KEY_BLUR, KEY_SHARPNESS, KEY_PARAMS };
+		static const char* GetParamName(int param);
+
+		// Load the keys of a sidecar file.
+		// Returns false if there is no file or no keys.
+		bool Load(const std::string &path);
+		void Clear();
+		bool IsLoaded();
+
+		// Load the file again if it has been modified.
+		// Checked once a second. Returns true if it was loaded.
+		bool CheckFile(uint64_t msec);
+
+		// Keys of all parameters
+		int GetKeys();
+		std::string GetPath();
+
+		// Changes each time the file is loaded
+		int GetVersion();
+
+		// Replace the values of the parameters that have keys
+		// with the values at the time (seconds)
+		void Evaluate(double time, float values[KEY_PARAMS]);
+
+	protected :
+
+		// Value at t is ((c3*u + c2)*u + c1)*u + c0, u = (t - t0)*scale
+		struct segment {
+			double t0;
+			double scale;
+			float c0, c1, c2, c3;
+		};
+
+		struct track {
+			std::vector<double> times;     // key times for search
+			std::vector<segment> segments; // a segment from each key
+			size_t cursor = 0;             // segment of the last value
+		};
+		track m_tracks[KEY_PARAMS];
+
+		std::string m_path;
+		std::filesystem::file_time_type m_modified{};
+		uint64_t m_checked = 0;
+		int m_version = 0;
+
+		struct key {
+			double time;
+			float value;
+			bool bBezier;
+		};
+		static void Build(track &tr, std::vector<key> &keys);
+
+};
@@ -0,0 +1,199 @@
+/*
+
+	LoopCache.cpp
+
+	Spout Video Player
+
+	Cache of the first frames of a movie for a seamless loop.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "LoopCache.h"
+
+//---------------------------------------------------------
+// Function: Allocate
+// Allocate rgba textures for the first frames of the movie
+// 8 frames of 1920x1080 use 64MB of video memory
+// and as much system memory if the pixels are kept for NDI
+void loopCache::Allocate(int nFrames, float width, float height)
+{
+	Release();
+
+	if (nFrames <= 0 || width <= 0 || height <= 0)
+		return;
+
+	m_width  = (unsigned int)width;
+	m_height = (unsigned int)height;
+	m_textures.resize(nFrames);
+	m_captured.resize(nFrames, false);
+	m_pixels.resize(nFrames);
+	for (int i = 0; i < nFrames; i++)
+		m_textures[i].allocate(m_width, m_height, GL_RGBA8);
+
+}
+
+//---------------------------------------------------------
+// Function: Release
+void loopCache::Release()
+{
+	for (auto &tex : m_textures)
+		tex.clear();
+	m_textures.clear();
+	m_captured.clear();
+	m_pixels.clear();
+	m_width = 0;
+	m_height = 0;
+	m_lastTime = 0.0;
+	m_nominal = 0.0;
+	m_jitter = 0.0;
+	m_maxJitter = 0.0;
+	m_loopFrames = 0;
+}
+
+//---------------------------------------------------------
+// Function: Capture
+// Copy the movie texture if the frame is one of the first frames.
+// Before any shaders are applied so that the cache has the
+// original frames. The decoded pixels are copied if given so that
+// a cached frame is not read back from the texture for NDI.
+bool loopCache::Capture(spoutShaders &shaders, int frame, GLuint TextureID, const ofPixels *pixels)
+{
+	if (frame < 0 || frame >= (int)m_textures.size() || m_captured[frame])
+		return false;
+
+	GLuint DestID = m_textures[frame].getTextureData().textureID;
+	m_captured[frame] = shaders.Copy(TextureID, DestID, m_width, m_height);
+	if (m_captured[frame] && pixels && pixels->isAllocated())
+		m_pixels[frame] = *pixels;
+	else
+		m_pixels[frame].clear();
+
+	return m_captured[frame];
+}
+
+//---------------------------------------------------------
+// Function: IsComplete
+// All frames have been captured.
+// Frames skipped by the decoder on the first pass
+// are captured on the next.
+bool loopCache::IsComplete()
+{
+	if (m_captured.empty())
+		return false;
+
+	for (auto captured : m_captured) {
+		if (!captured)
+			return false;
+	}
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: GetFrames
+int loopCache::GetFrames()
+{
+	return (int)m_textures.size();
+}
+
+//---------------------------------------------------------
+// Function: Restore
+// Copy a cached frame to the movie texture
+bool loopCache::Restore(spoutShaders &shaders, int frame, GLuint TextureID)
+{
+	if (frame < 0 || frame >= (int)m_textures.size() || !m_captured[frame])
+		return false;
+
+	GLuint SourceID = m_textures[frame].getTextureData().textureID;
+	return shaders.Copy(SourceID, TextureID, m_width, m_height);
+}
+
+//---------------------------------------------------------
+// Function: GetPixels
+// Decoded pixels of a cached frame for NDI
+// nullptr if the frame was captured without them
+const ofPixels *loopCache::GetPixels(int frame)
+{
+	if (frame < 0 || frame >= (int)m_pixels.size() || !m_captured[frame]
+		|| !m_pixels[frame].isAllocated())
+		return nullptr;
+
+	return &m_pixels[frame];
+}
+
+//---------------------------------------------------------
+// Function: FrameTime
+// Record the time of an output frame.
+// The deviation from the average frame interval is measured
+// for the frames either side of the loop point.
+void loopCache::FrameTime(double micros, bool bLoopPoint)
+{
+	double interval = (micros - m_lastTime) / 1000.0; // msec
+	m_lastTime = micros;
+	if (interval <= 0.0 || interval > 1000.0)
+		return; // first frame or after a pause
+
+	if (bLoopPoint) {
+		// Measure the tail frame, the splice and the cached head
+		m_loopFrames = 3;
+		m_jitter = 0.0;
+	}
+
+	if (m_loopFrames > 0) {
+		double deviation = fabs(interval - m_nominal);
+		if (deviation > m_jitter)
+			m_jitter = deviation;
+		m_loopFrames--;
+		if (m_loopFrames == 0) {
+			if (m_jitter > m_maxJitter)
+				m_maxJitter = m_jitter;
+			SpoutLogNotice("loopCache - loop point jitter %.3f msec (max %.3f msec)", m_jitter, m_maxJitter);
+		}
+	}
+	else {
+		// Average interval away from the loop point
+		if (m_nominal == 0.0) {
+			m_nominal = interval;
+		}
+		else {
+			m_nominal *= 0.98;
+			m_nominal += 0.02 * interval;
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: GetJitter
+double loopCache::GetJitter()
+{
+	return m_jitter;
+}
+
+//---------------------------------------------------------
+// Function: GetMaxJitter
+double loopCache::GetMaxJitter()
+{
+	return m_maxJitter;
+}
+
+//---------------------------------------------------------
+// Function: GetNominal
+double loopCache::GetNominal()
+{
+	return m_nominal;
+}
@@ -0,0 +1,79 @@
+/*
+
+	LoopCache.h
+
+	Spout Video Player
+
+	Cache of the first frames of a movie for a seamless loop.
+
+	The first frames are copied to textures as they are decoded.
+	At the end of the movie they are played from the cache while
+	the decoder seeks past them, so the seek is not visible.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutShaders.h" // For texture copy
+
+class loopCache {
+
+	public:
+
+		// Allocate textures for the first nFrames of the movie
+		void Allocate(int nFrames, float width, float height);
+		void Release();
+
+		// Copy a decoded movie frame if it is one of the first frames.
+		// The decoded pixels are kept as well if given, e.g. for NDI.
+		bool Capture(spoutShaders &shaders, int frame, GLuint TextureID, const ofPixels *pixels = nullptr);
+
+		// All frames have been captured
+		bool IsComplete();
+
+		// Number of frames cached
+		int GetFrames();
+
+		// Copy a cached frame to a texture
+		bool Restore(spoutShaders &shaders, int frame, GLuint TextureID);
+
+		// Decoded pixels of a cached frame, nullptr if not kept
+		const ofPixels *GetPixels(int frame);
+
+		// Loop point timing
+		void FrameTime(double micros, bool bLoopPoint);
+		double GetJitter();    // maximum deviation at the last loop point (msec)
+		double GetMaxJitter(); // maximum deviation at all loop points (msec)
+		double GetNominal();   // average frame interval (msec)
+
+	protected :
+
+		std::vector<ofTexture> m_textures;
+		std::vector<bool> m_captured;
+		std::vector<ofPixels> m_pixels;
+		unsigned int m_width = 0;
+		unsigned int m_height = 0;
+
+		// Frame intervals
+		double m_lastTime = 0.0;
+		double m_nominal = 0.0;
+		double m_jitter = 0.0;
+		double m_maxJitter = 0.0;
+		int m_loopFrames = 0; // frames still to measure after a loop point
+
+};
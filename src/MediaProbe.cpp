@@ -0,0 +1,171 @@
+/*
+
+	MediaProbe.cpp
+
+	Spout Video Player
+
+	Cache of the stream parameters of movies opened before.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "MediaProbe.h"
+#include <filesystem>
+#include <fstream>
+
+static const char probeMagic[4] = { 'S', 'V', 'P', '1' };
+
+//---------------------------------------------------------
+// Function: SetFolder
+void mediaProbe::SetFolder(std::string folder)
+{
+	m_folder = folder;
+}
+
+//---------------------------------------------------------
+// Function: Find
+bool mediaProbe::Find(std::string path, info &probe)
+{
+	if (m_folder.empty())
+		return false;
+
+	uint64_t size = 0;
+	int64_t modified = 0;
+	if (!GetFileStamp(path, size, modified))
+		return false;
+
+	std::ifstream file(GetCacheFile(path, "probe"), std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	header head{};
+	if (!file.read((char*)&head, sizeof(head))
+		|| memcmp(head.magic, probeMagic, 4) != 0
+		|| head.size != size || head.modified != modified
+		|| head.pathLength != (int)path.size()
+		|| head.width <= 0 || head.height <= 0 || head.duration <= 0.0f
+		|| head.thumbWidth < 0 || head.thumbWidth > THUMB_WIDTH
+		|| head.thumbHeight < 0 || head.thumbHeight > head.height)
+		return false;
+
+	// Another path with the same hash
+	std::string stored(head.pathLength, '\0');
+	if (!file.read(&stored[0], head.pathLength) || stored != path)
+		return false;
+
+	probe.width = head.width;
+	probe.height = head.height;
+	probe.frames = head.frames;
+	probe.duration = head.duration;
+	probe.thumbnail.clear();
+	if (head.thumbWidth > 0 && head.thumbHeight > 0) {
+		probe.thumbnail.allocate(head.thumbWidth, head.thumbHeight, OF_PIXELS_RGBA);
+		if (!file.read((char*)probe.thumbnail.getData(), probe.thumbnail.getTotalBytes()))
+			probe.thumbnail.clear();
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Store
+bool mediaProbe::Store(std::string path, const info &probe)
+{
+	if (m_folder.empty() || probe.width <= 0 || probe.height <= 0)
+		return false;
+
+	uint64_t size = 0;
+	int64_t modified = 0;
+	if (!GetFileStamp(path, size, modified))
+		return false;
+
+	// Reduce the thumbnail
+	ofPixels thumb;
+	if (probe.thumbnail.isAllocated() && probe.thumbnail.getNumChannels() == 4) {
+		int width = (int)probe.thumbnail.getWidth();
+		int height = (int)probe.thumbnail.getHeight();
+		if (width > THUMB_WIDTH) {
+			height = height*THUMB_WIDTH/width;
+			width = THUMB_WIDTH;
+		}
+		if (height > 0) {
+			thumb.allocate(width, height, OF_PIXELS_RGBA);
+			probe.thumbnail.resizeTo(thumb, OF_INTERPOLATE_BILINEAR);
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(m_folder, ec);
+
+	std::ofstream file(GetCacheFile(path, "probe"), std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		SpoutLogWarning("mediaProbe::Store - could not create probe file for %s", path.c_str());
+		return false;
+	}
+
+	header head{};
+	memcpy(head.magic, probeMagic, 4);
+	head.size = size;
+	head.modified = modified;
+	head.width = probe.width;
+	head.height = probe.height;
+	head.frames = probe.frames;
+	head.duration = probe.duration;
+	head.thumbWidth = (int)thumb.getWidth();
+	head.thumbHeight = (int)thumb.getHeight();
+	head.pathLength = (int)path.size();
+
+	file.write((const char*)&head, sizeof(head));
+	file.write(path.data(), path.size());
+	if (thumb.isAllocated())
+		file.write((const char*)thumb.getData(), thumb.getTotalBytes());
+
+	return file.good();
+}
+
+//---------------------------------------------------------
+// Function: GetCacheFile
+// FNV-1a hash of the path
+std::string mediaProbe::GetCacheFile(std::string path, std::string extension)
+{
+	if (m_folder.empty())
+		return "";
+
+	uint64_t hash = 14695981039346656037ULL;
+	for (unsigned char c : path) {
+		hash ^= (uint64_t)tolower(c);
+		hash *= 1099511628211ULL;
+	}
+
+	char name[32]{};
+	sprintf_s(name, 32, "%016llx.", (unsigned long long)hash);
+
+	return m_folder + "\\" + name + extension;
+}
+
+//---------------------------------------------------------
+// Function: GetFileStamp
+bool mediaProbe::GetFileStamp(std::string path, uint64_t &size, int64_t &modified)
+{
+	std::error_code ec;
+	size = (uint64_t)std::filesystem::file_size(path, ec);
+	if (ec)
+		return false;
+	modified = (int64_t)std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+	return !ec;
+}
@@ -0,0 +1,87 @@
+/*
+
+	MediaProbe.h
+
+	Spout Video Player
+
+	Cache of the stream parameters of movies opened before.
+
+	A probe file for each movie keeps the size, frame count and duration
+	found by the decoder and a thumbnail of the first frame. It is used
+	only if the movie file has the same path, size and modification time
+	as when it was stored. Probe files are in the "probe" folder next to
+	the executable, named by a hash of the movie path.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutUtils.h" // For logging
+
+using namespace spoututils;
+
+class mediaProbe {
+
+	public:
+
+		struct info {
+			int width = 0;
+			int height = 0;
+			int frames = 0;
+			float duration = 0.0f; // seconds
+			ofPixels thumbnail;    // rgba first frame
+		};
+
+		// Maximum thumbnail width
+		static const int THUMB_WIDTH = 320;
+
+		// Folder for the probe files
+		void SetFolder(std::string folder);
+
+		// Probe of a movie that has not changed since it was stored
+		bool Find(std::string path, info &probe);
+
+		// Store the probe of a movie.
+		// The thumbnail is reduced to THUMB_WIDTH.
+		bool Store(std::string path, const info &probe);
+
+		// File in the probe folder for other data of a movie,
+		// named by the same hash with the extension given
+		std::string GetCacheFile(std::string path, std::string extension);
+
+		// File size and modification time
+		static bool GetFileStamp(std::string path, uint64_t &size, int64_t &modified);
+
+	protected :
+
+		std::string m_folder;
+
+		struct header {
+			char magic[4];
+			uint64_t size;     // movie file size
+			int64_t modified;  // movie file time
+			int width;
+			int height;
+			int frames;
+			float duration;
+			int thumbWidth;
+			int thumbHeight;
+			int pathLength;    // followed by the path and thumbnail pixels
+		};
+
+};
@@ -0,0 +1,390 @@
+/*
+
+	RateConverter.cpp
+
+	Spout Video Player
+
+	Frame rate conversion to a fixed output rate.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "RateConverter.h"
+
+rateConverter::rateConverter() {
+}
+
+rateConverter::~rateConverter() {
+}
+
+//---------------------------------------------------------
+// Function: SetRate
+void rateConverter::SetRate(double fps)
+{
+	if (fps > 0.0)
+		m_rate = fps;
+}
+
+//---------------------------------------------------------
+// Function: GetRate
+double rateConverter::GetRate()
+{
+	return m_rate;
+}
+
+//---------------------------------------------------------
+// Function: SetMethod
+void rateConverter::SetMethod(int method)
+{
+	if (method >= 0 && method < FRC_METHODS)
+		m_method = method;
+}
+
+//---------------------------------------------------------
+// Function: GetMethod
+int rateConverter::GetMethod()
+{
+	return m_method;
+}
+
+//---------------------------------------------------------
+// Function: GetMethodName
+const char* rateConverter::GetMethodName(int method)
+{
+	switch (method) {
+		case FRC_REPEAT: return "repeat";
+		case FRC_BLEND:  return "blend";
+		case FRC_MOTION: return "motion";
+		default: return "";
+	}
+}
+
+//---------------------------------------------------------
+// Function: Start
+// The frames of the last source are not used again.
+// The output clock and frame count continue.
+void rateConverter::Start(double sourceFps)
+{
+	m_sourceFps = (sourceFps > 0.0) ? sourceFps : 30.0;
+	m_frames = 0;
+	m_vectorFrame = -1;
+	m_current = nullptr;
+	m_cadenceFrame = -1;
+	m_cadenceCount = 0;
+	m_cadence.clear();
+}
+
+//---------------------------------------------------------
+// Function: Release
+void rateConverter::Release()
+{
+	for (auto &tex : m_ring)
+		tex.clear();
+	m_output.clear();
+	m_vectors.clear();
+	m_width = 0;
+	m_height = 0;
+
+	for (auto &q : m_queries) {
+		if (q.id > 0)
+			glDeleteQueries(1, &q.id);
+		q.id = 0;
+		q.bPending = false;
+	}
+
+	Start(m_sourceFps);
+	m_outputTime = 0.0;
+	m_frameNumber = 0;
+	m_timestamp = 0.0;
+	m_dropped = 0;
+}
+
+//---------------------------------------------------------
+// Function: AddFrame
+// Copy a processed source frame to the ring.
+// The source clock follows the arrival of frames, averaged so
+// that the draw cycle does not add jitter, and is reset after
+// a pause, seek or decoder stall.
+void rateConverter::AddFrame(spoutShaders &shaders, GLuint TextureID, unsigned int width, unsigned int height)
+{
+	if (TextureID == 0 || width == 0 || height == 0)
+		return;
+
+	if (width != m_width || height != m_height) {
+		for (auto &tex : m_ring)
+			tex.allocate(width, height, GL_RGBA8);
+		m_output.allocate(width, height, GL_RGBA8);
+		m_vectors.allocate((width+15)/16, (height+15)/16, GL_RGBA8);
+		m_width = width;
+		m_height = height;
+		Start(m_sourceFps);
+	}
+
+	double now = (double)ofGetElapsedTimeMicros() / 1000000.0;
+	double period = 1.0 / m_sourceFps;
+	if (m_frames == 0) {
+		m_sourceStart = now;
+	}
+	else {
+		double error = now - (m_sourceStart + (double)m_frames*period);
+		if (fabs(error) > 2.0*period)
+			m_sourceStart += error;
+		else
+			m_sourceStart += error*0.05;
+	}
+	m_lastArrival = now;
+
+	GLuint DestID = m_ring[m_frames % RING].getTextureData().textureID;
+	shaders.Copy(TextureID, DestID, m_width, m_height);
+	m_frames++;
+}
+
+//---------------------------------------------------------
+// Function: SetSourceRate
+// Change the source frame rate, e.g. for a new playback speed.
+// The source clock continues from the last frame.
+void rateConverter::SetSourceRate(double fps)
+{
+	if (fps <= 0.0 || fps == m_sourceFps)
+		return;
+
+	m_sourceFps = fps;
+	if (m_frames > 0)
+		m_sourceStart = m_lastArrival - (double)(m_frames-1) / m_sourceFps;
+}
+
+//---------------------------------------------------------
+// Function: ReplaceFrame
+void rateConverter::ReplaceFrame(spoutShaders &shaders, GLuint TextureID)
+{
+	if (m_frames == 0 || TextureID == 0)
+		return;
+
+	GLuint DestID = m_ring[(m_frames-1) % RING].getTextureData().textureID;
+	shaders.Copy(TextureID, DestID, m_width, m_height);
+	m_vectorFrame = -1;
+}
+
+//---------------------------------------------------------
+// Function: Update
+// An output frame is due within half an output period of its time.
+// Output frames missed by a slow draw cycle are dropped so that
+// the output clock does not fall behind.
+bool rateConverter::Update(spoutShaders &shaders)
+{
+	ReadQueries();
+
+	if (m_frames == 0)
+		return false;
+
+	double now = (double)ofGetElapsedTimeMicros() / 1000000.0;
+	double period = 1.0 / m_rate;
+	if (m_outputTime == 0.0 || now - m_outputTime > 1.0)
+		m_outputTime = now; // start or after the window was moved
+	if (now < m_outputTime - period/2.0)
+		return false;
+	while (now >= m_outputTime + period/2.0) {
+		m_outputTime += period;
+		m_frameNumber++;
+		m_dropped++;
+	}
+
+	RenderAt(shaders, m_outputTime);
+
+	m_timestamp = (double)m_frameNumber / m_rate;
+	m_frameNumber++;
+	m_outputTime += period;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Present
+// Render the frame for the current time without the output clock,
+// e.g. to show slow motion at the draw rate.
+bool rateConverter::Present(spoutShaders &shaders)
+{
+	ReadQueries();
+
+	if (m_frames == 0)
+		return false;
+
+	RenderAt(shaders, (double)ofGetElapsedTimeMicros() / 1000000.0);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: RenderAt
+// The source frame position is one source frame behind
+// so that the frame after it has arrived.
+void rateConverter::RenderAt(spoutShaders &shaders, double time)
+{
+	double position = (time - 1.0/m_sourceFps - m_sourceStart) * m_sourceFps;
+	int64_t newest = m_frames - 1;
+	int64_t oldest = (m_frames > RING) ? m_frames - RING : 0;
+	if (position < (double)oldest)
+		position = (double)oldest;
+	if (position > (double)newest)
+		position = (double)newest;
+	int64_t frame = (int64_t)floor(position);
+
+	// Output frames for each source frame
+	if (frame != m_cadenceFrame) {
+		if (m_cadenceFrame >= 0) {
+			m_cadence.push_back(m_cadenceCount);
+			if (m_cadence.size() > 8)
+				m_cadence.pop_front();
+		}
+		m_cadenceFrame = frame;
+		m_cadenceCount = 0;
+	}
+	m_cadenceCount++;
+
+	Render(shaders, frame, (float)(position - (double)frame));
+}
+
+//---------------------------------------------------------
+// Function: GetTexture
+ofTexture &rateConverter::GetTexture()
+{
+	return m_current ? *m_current : m_output;
+}
+
+//---------------------------------------------------------
+// Function: GetTimestamp
+double rateConverter::GetTimestamp()
+{
+	return m_timestamp;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameNumber
+int64_t rateConverter::GetFrameNumber()
+{
+	return m_frameNumber;
+}
+
+//---------------------------------------------------------
+// Function: GetDropped
+int rateConverter::GetDropped()
+{
+	return m_dropped;
+}
+
+//---------------------------------------------------------
+// Function: GetCadence
+// The last four counts
+std::string rateConverter::GetCadence()
+{
+	std::string cadence;
+	size_t first = (m_cadence.size() > 4) ? m_cadence.size() - 4 : 0;
+	for (size_t i = first; i < m_cadence.size(); i++) {
+		if (!cadence.empty())
+			cadence += ":";
+		cadence += std::to_string(m_cadence[i]);
+	}
+	return cadence;
+}
+
+//---------------------------------------------------------
+// Function: GetGpuTime
+double rateConverter::GetGpuTime(int method)
+{
+	if (method < 0 || method >= FRC_METHODS)
+		return 0.0;
+	return m_gpuTime[method];
+}
+
+//---------------------------------------------------------
+// Function: Render
+// A source frame is used without change if it is at the output
+// time. The motion vectors are found once for each pair of frames.
+void rateConverter::Render(spoutShaders &shaders, int64_t frame, float amount)
+{
+	// Time the shaders if a query is free
+	query* q = nullptr;
+	for (auto &qr : m_queries) {
+		if (!qr.bPending) {
+			q = &qr;
+			break;
+		}
+	}
+	if (q) {
+		if (q->id == 0)
+			glGenQueries(1, &q->id);
+		glBeginQuery(GL_TIME_ELAPSED, q->id);
+	}
+
+	GLuint SourceID = m_ring[frame % RING].getTextureData().textureID;
+	if (m_method == FRC_REPEAT || amount < 0.001f || frame + 1 >= m_frames) {
+		m_current = &m_ring[frame % RING];
+	}
+	else {
+		GLuint Source2ID = m_ring[(frame+1) % RING].getTextureData().textureID;
+		GLuint DestID = m_output.getTextureData().textureID;
+		if (m_method == FRC_BLEND) {
+			shaders.Blend(SourceID, Source2ID, DestID, m_width, m_height, amount);
+		}
+		else {
+			GLuint VectorID = m_vectors.getTextureData().textureID;
+			if (m_vectorFrame != frame) {
+				shaders.MotionSearch(SourceID, Source2ID, VectorID, m_width, m_height);
+				m_vectorFrame = frame;
+			}
+			shaders.MotionInterpolate(SourceID, Source2ID, VectorID, DestID,
+				m_width, m_height, amount, 0.08f);
+		}
+		m_current = &m_output;
+	}
+
+	if (q) {
+		glEndQuery(GL_TIME_ELAPSED);
+		q->method = m_method;
+		q->bPending = true;
+	}
+}
+
+//---------------------------------------------------------
+// Function: ReadQueries
+// Results are read when available so that there is no wait
+void rateConverter::ReadQueries()
+{
+	for (auto &q : m_queries) {
+		if (!q.bPending)
+			continue;
+
+		GLint available = 0;
+		glGetQueryObjectiv(q.id, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			continue;
+
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(q.id, GL_QUERY_RESULT, &nanoseconds);
+		double msec = (double)nanoseconds / 1000000.0;
+		if (m_gpuTime[q.method] == 0.0) {
+			m_gpuTime[q.method] = msec;
+		}
+		else {
+			// damped average
+			m_gpuTime[q.method] *= 0.95;
+			m_gpuTime[q.method] += 0.05*msec;
+		}
+		q.bPending = false;
+	}
+}
@@ -0,0 +1,137 @@
+/*
+
+	RateConverter.h
+
+	Spout Video Player
+
+	Frame rate conversion to a fixed output rate.
+
+	Processed movie frames are kept in a ring of textures with times
+	on a source clock that follows the movie frame rate. Output frames
+	are produced at the fixed rate, one source frame behind, from the
+	two source frames either side of the output time. Methods are :
+
+	  Repeat - the source frame before the output time. Frames are
+	           repeated in a cadence, e.g. 2:3 for 24 fps to 60 fps.
+	  Blend  - linear mix of the two source frames.
+	  Motion - the two source frames moved along block motion
+	           vectors to the output time and mixed.
+
+	Each output frame has a time stamp on the output clock, the frame
+	number divided by the output rate. GPU time is measured for each
+	method with timer queries that are read when they are complete.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutShaders.h" // For blend and motion shaders
+
+class rateConverter {
+
+	public:
+
+		enum { FRC_REPEAT, FRC_BLEND, FRC_MOTION, FRC_METHODS };
+
+		rateConverter();
+		~rateConverter();
+
+		// Output frame rate
+		void SetRate(double fps);
+		double GetRate();
+
+		// Conversion method
+		void SetMethod(int method);
+		int GetMethod();
+		static const char* GetMethodName(int method);
+
+		// Clear the frames for a new source
+		void Start(double sourceFps);
+		void Release();
+
+		// Source frame rate, e.g. for a new playback speed
+		void SetSourceRate(double fps);
+
+		// Copy a new source frame
+		void AddFrame(spoutShaders &shaders, GLuint TextureID, unsigned int width, unsigned int height);
+
+		// Replace the last source frame, e.g. with new adjustments while paused
+		void ReplaceFrame(spoutShaders &shaders, GLuint TextureID);
+
+		// Produce an output frame if one is due.
+		// Returns true if there is a new output frame.
+		bool Update(spoutShaders &shaders);
+
+		// Produce the frame for the current time
+		// Returns false if there are no source frames.
+		bool Present(spoutShaders &shaders);
+
+		// The output frame
+		ofTexture &GetTexture();
+		double GetTimestamp();    // time on the output clock (seconds)
+		int64_t GetFrameNumber(); // output frames since start
+		int GetDropped();         // output frames missed by a slow draw cycle
+
+		// Output frames for each source frame, e.g. "2:3:2:3"
+		std::string GetCadence();
+
+		// Average GPU time of the method (msec)
+		double GetGpuTime(int method);
+
+	protected :
+
+		static const int RING = 3;
+		ofTexture m_ring[RING];  // last source frames
+		ofTexture m_output;      // blended or interpolated frame
+		ofTexture m_vectors;     // block motion vectors
+		ofTexture* m_current = nullptr; // output frame texture
+		unsigned int m_width = 0;
+		unsigned int m_height = 0;
+
+		double m_rate = 60.0;
+		int m_method = FRC_BLEND;
+		double m_sourceFps = 30.0;
+		double m_sourceStart = 0.0; // source clock time of frame 0 (seconds)
+		int64_t m_frames = 0;       // source frames added
+		double m_lastArrival = 0.0; // time of the last source frame (seconds)
+		int64_t m_vectorFrame = -1; // first frame of the motion vectors
+
+		double m_outputTime = 0.0;  // time the next output frame is due (seconds)
+		int64_t m_frameNumber = 0;
+		double m_timestamp = 0.0;
+		int m_dropped = 0;
+
+		// Output frames for each source frame
+		int64_t m_cadenceFrame = -1;
+		int m_cadenceCount = 0;
+		std::deque<int> m_cadence;
+
+		// GPU timer queries
+		struct query {
+			GLuint id = 0;
+			int method = 0;
+			bool bPending = false;
+		};
+		query m_queries[4];
+		double m_gpuTime[FRC_METHODS]{};
+
+		void RenderAt(spoutShaders &shaders, double time);
+		void Render(spoutShaders &shaders, int64_t frame, float amount);
+		void ReadQueries();
+
+};
@@ -0,0 +1,460 @@
+/*
+
+	RawMovie.cpp
+
+	Spout Video Player
+
+	Uncompressed rgba or nv12 movie container.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+				- nv12 frames
+
+*/
+#include "RawMovie.h"
+#include <cstring>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const char rawMagic[8] = { 'S', 'V', 'P', 'R', 'A', 'W', '1', 0 };
+static const uint32_t rawAlignment = 4096;
+
+// Bytes of pixel data for a frame, zero if the size
+// is not supported by the format
+static uint64_t FrameBytes(uint32_t width, uint32_t height, uint32_t format)
+{
+	if (width == 0 || height == 0)
+		return 0;
+	if (format == frameSource::FRAME_RGBA)
+		return (uint64_t)width * height * 4;
+	if (format == frameSource::FRAME_NV12 && (width % 4) == 0 && (height % 2) == 0)
+		return (uint64_t)width * height * 3 / 2;
+	return 0;
+}
+
+#ifdef _WIN32
+// PrefetchVirtualMemory is Windows 8 and later
+typedef struct {
+	PVOID  VirtualAddress;
+	SIZE_T NumberOfBytes;
+} rawMemoryRange;
+typedef BOOL(WINAPI* PrefetchVirtualMemoryPtr)(HANDLE, ULONG_PTR, rawMemoryRange*, ULONG);
+static PrefetchVirtualMemoryPtr pPrefetchVirtualMemory = nullptr;
+#endif
+
+//
+// Class: rawMovie
+//
+// Memory mapped reader
+//
+
+rawMovie::rawMovie() {
+#ifdef _WIN32
+	if (!pPrefetchVirtualMemory) {
+		HMODULE hKernel = GetModuleHandleA("kernel32.dll");
+		if (hKernel)
+			pPrefetchVirtualMemory = (PrefetchVirtualMemoryPtr)GetProcAddress(hKernel, "PrefetchVirtualMemory");
+	}
+#endif
+}
+
+rawMovie::~rawMovie() {
+	Close();
+}
+
+//---------------------------------------------------------
+// Function: Open
+// Map the file and read the header and frame index
+bool rawMovie::Open(std::string path)
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size{};
+	GetFileSizeEx(m_hFile, &size);
+	m_size = (uint64_t)size.QuadPart;
+	if (m_size < sizeof(rawHeader)) {
+		Close();
+		return false;
+	}
+	m_hMap = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m_hMap) {
+		Close();
+		return false;
+	}
+	m_data = (unsigned char*)MapViewOfFile(m_hMap, FILE_MAP_READ, 0, 0, 0);
+#else
+	m_fd = open(path.c_str(), O_RDONLY);
+	if (m_fd < 0)
+		return false;
+	struct stat st{};
+	fstat(m_fd, &st);
+	m_size = (uint64_t)st.st_size;
+	if (m_size < sizeof(rawHeader)) {
+		Close();
+		return false;
+	}
+	void* map = mmap(nullptr, (size_t)m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+	m_data = (map == MAP_FAILED) ? nullptr : (unsigned char*)map;
+	// Frames are read in order
+	if (m_data)
+		madvise(m_data, (size_t)m_size, MADV_SEQUENTIAL);
+#endif
+
+	if (!m_data) {
+		Close();
+		return false;
+	}
+
+	// Check the header and the index.
+	// Sizes are compared by subtraction so that a damaged
+	// header or offset cannot overflow past the file size.
+	memcpy(&m_header, m_data, sizeof(rawHeader));
+	uint64_t indexSize = (uint64_t)m_header.frames * sizeof(uint64_t);
+	uint64_t frameBytes = FrameBytes(m_header.width, m_header.height, m_header.format);
+	if (memcmp(m_header.magic, rawMagic, 8) != 0
+		|| m_header.version != 1
+		|| m_header.alignment == 0
+		|| frameBytes == 0
+		|| m_header.frameSize < frameBytes
+		|| m_header.frameSize > m_size
+		|| m_header.indexOffset > m_size
+		|| indexSize > m_size - m_header.indexOffset) {
+		Close();
+		return false;
+	}
+
+	// Frames start at the alignment for reads without the mapping
+	m_offsets.resize(m_header.frames);
+	memcpy(m_offsets.data(), m_data + m_header.indexOffset, (size_t)indexSize);
+	for (auto offset : m_offsets) {
+		if (offset % m_header.alignment != 0
+			|| offset > m_size - m_header.frameSize) {
+			Close();
+			return false;
+		}
+	}
+
+	m_prefetched = -1;
+	ReadAhead(0, m_readAhead);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Close
+void rawMovie::Close()
+{
+#ifdef _WIN32
+	if (m_data) UnmapViewOfFile(m_data);
+	if (m_hMap) CloseHandle(m_hMap);
+	if (m_hFile != INVALID_HANDLE_VALUE) CloseHandle(m_hFile);
+	m_hMap = NULL;
+	m_hFile = INVALID_HANDLE_VALUE;
+#else
+	if (m_data) munmap(m_data, (size_t)m_size);
+	if (m_fd >= 0) close(m_fd);
+	m_fd = -1;
+#endif
+	m_data = nullptr;
+	m_size = 0;
+	m_offsets.clear();
+	memset(&m_header, 0, sizeof(rawHeader));
+	m_prefetched = -1;
+}
+
+//---------------------------------------------------------
+// Function: IsOpen
+bool rawMovie::IsOpen()
+{
+	return (m_data != nullptr);
+}
+
+//---------------------------------------------------------
+// Function: GetFrames
+int rawMovie::GetFrames()
+{
+	return (int)m_offsets.size();
+}
+
+//---------------------------------------------------------
+// Function: GetFrameWidth
+int rawMovie::GetFrameWidth()
+{
+	return (int)m_header.width;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameHeight
+int rawMovie::GetFrameHeight()
+{
+	return (int)m_header.height;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameRate
+double rawMovie::GetFrameRate()
+{
+	if (m_header.fpsDen == 0)
+		return 0.0;
+	return (double)m_header.fpsNum / (double)m_header.fpsDen;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameData
+// Pointer to the frame pixels in the mapping.
+// Pages that have not been read ahead are read on access.
+const unsigned char* rawMovie::GetFrameData(int frame)
+{
+	if (!m_data || frame < 0 || frame >= (int)m_offsets.size())
+		return nullptr;
+	return m_data + m_offsets[frame];
+}
+
+//---------------------------------------------------------
+// Function: GetFrameOffset
+uint64_t rawMovie::GetFrameOffset(int frame)
+{
+	if (!m_data || frame < 0 || frame >= (int)m_offsets.size())
+		return 0;
+	return m_offsets[frame];
+}
+
+//---------------------------------------------------------
+// Function: GetFrameStride
+// Frame size padded to the alignment
+uint64_t rawMovie::GetFrameStride()
+{
+	if (!m_data || m_header.alignment == 0)
+		return m_header.frameSize;
+	return (m_header.frameSize + m_header.alignment - 1) / m_header.alignment * m_header.alignment;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameFormat
+int rawMovie::GetFrameFormat()
+{
+	return (int)m_header.format;
+}
+
+//---------------------------------------------------------
+// Function: Prefetch
+// Read ahead of the frame about to be played.
+// Only frames not already requested are read, and
+// only those that will be played at the current step.
+void rawMovie::Prefetch(int frame)
+{
+	if (!m_data || m_offsets.empty())
+		return;
+
+	// Start again after a seek or loop
+	if (frame > m_prefetched + m_step || frame < m_prefetched - m_readAhead*m_step)
+		m_prefetched = frame - m_step;
+
+	for (int i = 0; i < m_readAhead; i++) {
+		int next = frame + i*m_step;
+		if (next > m_prefetched)
+			ReadAhead(next, 1);
+	}
+}
+
+//---------------------------------------------------------
+// Function: SetStep
+void rawMovie::SetStep(int step)
+{
+	m_step = step;
+	if (m_step < 1)
+		m_step = 1;
+}
+
+//---------------------------------------------------------
+// Function: SetReadAhead
+void rawMovie::SetReadAhead(int frames)
+{
+	m_readAhead = frames;
+	if (m_readAhead < 1)
+		m_readAhead = 1;
+}
+
+//---------------------------------------------------------
+// Function: IsRawMovie
+bool rawMovie::IsRawMovie(std::string path)
+{
+	std::string ext = RAWMOVIE_EXTENSION;
+	if (path.length() < ext.length())
+		return false;
+	std::string end = path.substr(path.length() - ext.length());
+	std::transform(end.begin(), end.end(), end.begin(), ::tolower);
+	return (end == ext);
+}
+
+//---------------------------------------------------------
+// Function: ReadAhead
+// Ask the system to read frames into memory in the background.
+// Frames wrap to the start for a loop.
+void rawMovie::ReadAhead(int first, int count)
+{
+	int nFrames = (int)m_offsets.size();
+	if (nFrames == 0)
+		return;
+
+	for (int i = 0; i < count && i < nFrames; i++) {
+		int frame = (first + i) % nFrames;
+		unsigned char* address = m_data + m_offsets[frame];
+		size_t bytes = (size_t)m_header.frameSize;
+#ifdef _WIN32
+		if (pPrefetchVirtualMemory) {
+			rawMemoryRange range{ address, bytes };
+			pPrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+		}
+#else
+		madvise(address, bytes, MADV_WILLNEED);
+#endif
+		m_prefetched = first + i;
+	}
+}
+
+//
+// Class: rawWriter
+//
+// Writer for the converter
+//
+
+rawWriter::rawWriter() {
+}
+
+rawWriter::~rawWriter() {
+	Close();
+}
+
+//---------------------------------------------------------
+// Function: Create
+// Start a new file. The header is written again by Close.
+bool rawWriter::Create(std::string path, unsigned int width, unsigned int height,
+	unsigned int fpsNum, unsigned int fpsDen, unsigned int format)
+{
+	Close();
+
+	uint64_t frameBytes = FrameBytes(width, height, format);
+	if (frameBytes == 0 || fpsNum == 0 || fpsDen == 0)
+		return false;
+
+	m_file = fopen(path.c_str(), "wb");
+	if (!m_file)
+		return false;
+
+	memset(&m_header, 0, sizeof(rawHeader));
+	memcpy(m_header.magic, rawMagic, 8);
+	m_header.version = 1;
+	m_header.width = width;
+	m_header.height = height;
+	m_header.format = format;
+	m_header.fpsNum = fpsNum;
+	m_header.fpsDen = fpsDen;
+	m_header.alignment = rawAlignment;
+	m_header.frameSize = frameBytes;
+	m_offsets.clear();
+
+	m_position = 0;
+	if (fwrite(&m_header, sizeof(rawHeader), 1, m_file) != 1) {
+		fclose(m_file);
+		m_file = nullptr;
+		return false;
+	}
+	m_position = sizeof(rawHeader);
+
+	return Pad();
+}
+
+//---------------------------------------------------------
+// Function: AddFrame
+// Write a page aligned frame
+bool rawWriter::AddFrame(const unsigned char* data)
+{
+	if (!m_file || !data)
+		return false;
+
+	m_offsets.push_back(m_position);
+	if (fwrite(data, 1, (size_t)m_header.frameSize, m_file) != (size_t)m_header.frameSize)
+		return false;
+	m_position += m_header.frameSize;
+
+	return Pad();
+}
+
+//---------------------------------------------------------
+// Function: Close
+// Write the frame index and the final header
+bool rawWriter::Close()
+{
+	if (!m_file)
+		return false;
+
+	bool bResult = true;
+	m_header.frames = (uint32_t)m_offsets.size();
+	m_header.indexOffset = m_position;
+	if (!m_offsets.empty()) {
+		if (fwrite(m_offsets.data(), sizeof(uint64_t), m_offsets.size(), m_file) != m_offsets.size())
+			bResult = false;
+	}
+	rewind(m_file);
+	if (fwrite(&m_header, sizeof(rawHeader), 1, m_file) != 1)
+		bResult = false;
+	fclose(m_file);
+	m_file = nullptr;
+
+	return bResult;
+}
+
+//---------------------------------------------------------
+// Function: GetFrames
+unsigned int rawWriter::GetFrames()
+{
+	return (unsigned int)m_offsets.size();
+}
+
+//---------------------------------------------------------
+// Function: GetFrameSize
+unsigned int rawWriter::GetFrameSize()
+{
+	return (unsigned int)m_header.frameSize;
+}
+
+//---------------------------------------------------------
+// Function: Pad
+// Pad the file to the next page boundary
+bool rawWriter::Pad()
+{
+	uint64_t padding = (rawAlignment - (m_position % rawAlignment)) % rawAlignment;
+	if (padding > 0) {
+		static const unsigned char zeros[rawAlignment] = {};
+		if (fwrite(zeros, 1, (size_t)padding, m_file) != (size_t)padding)
+			return false;
+		m_position += padding;
+	}
+	return true;
+}
@@ -0,0 +1,156 @@
+/*
+
+	RawMovie.h
+
+	Spout Video Player
+
+	Uncompressed rgba or nv12 movie container.
+
+	The file is memory mapped and frames are uploaded directly from
+	the mapping, so there is no decode or copy before the upload.
+	Nv12 frames are 1.5 bytes per pixel instead of 4 and are converted
+	to rgba on the GPU. The width must be a multiple of 4 and the
+	height a multiple of 2.
+
+	File layout :
+
+	  0           header (rawHeader) padded to the alignment
+	  alignment   frames, each padded to the alignment
+	  indexOffset frame offset table (one 64 bit offset per frame)
+
+	The index is written after the frames so that a movie can be
+	converted from a stream without knowing the number of frames.
+
+	No Openframeworks dependency so that the container and the
+	rawtool converter and benchmark can be built on Linux.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "FrameSource.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// File name extension
+#define RAWMOVIE_EXTENSION ".svr"
+
+#pragma pack(push, 1)
+struct rawHeader {
+	char     magic[8];    // "SVPRAW1"
+	uint32_t version;     // 1
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;      // 0 - rgba 8 bit, 1 - nv12 8 bit (frameSource::FRAME_NV12)
+	uint32_t fpsNum;      // frame rate numerator
+	uint32_t fpsDen;      // frame rate denominator
+	uint32_t frames;      // number of frames
+	uint32_t alignment;   // frame alignment (page size)
+	uint64_t frameSize;   // bytes of pixel data per frame
+	uint64_t indexOffset; // file offset of the frame offset table
+};
+#pragma pack(pop)
+
+//
+// Memory mapped reader
+//
+class rawMovie : public frameSource {
+
+	public:
+
+		rawMovie();
+		~rawMovie();
+
+		bool Open(std::string path);
+		void Close();
+		bool IsOpen();
+
+		// frameSource
+		int GetFrames();
+		int GetFrameWidth();
+		int GetFrameHeight();
+		double GetFrameRate();
+		const unsigned char* GetFrameData(int frame);
+		int GetFrameFormat();
+		void Prefetch(int frame);
+		void SetStep(int step);
+
+		// Number of frames to read ahead (default 4)
+		void SetReadAhead(int frames);
+
+		// File offset and padded size of a frame for reads without
+		// the mapping, e.g. the uncached benchmark. 0 if not available.
+		uint64_t GetFrameOffset(int frame);
+		uint64_t GetFrameStride();
+
+		// File has the raw movie extension
+		static bool IsRawMovie(std::string path);
+
+	protected :
+
+		rawHeader m_header{};
+		std::vector<uint64_t> m_offsets;
+		unsigned char* m_data = nullptr;
+		uint64_t m_size = 0;
+		int m_readAhead = 4;
+		int m_prefetched = -1; // last frame read ahead
+		int m_step = 1;        // frames between those played
+
+#ifdef _WIN32
+		HANDLE m_hFile = INVALID_HANDLE_VALUE;
+		HANDLE m_hMap = NULL;
+#else
+		int m_fd = -1;
+#endif
+
+		void ReadAhead(int first, int count);
+
+};
+
+//
+// Writer for the converter
+//
+class rawWriter {
+
+	public:
+
+		rawWriter();
+		~rawWriter();
+
+		bool Create(std::string path, unsigned int width, unsigned int height,
+			unsigned int fpsNum, unsigned int fpsDen = 1,
+			unsigned int format = frameSource::FRAME_RGBA);
+		bool AddFrame(const unsigned char* data);
+		unsigned int GetFrameSize(); // bytes for each frame
+		bool Close();
+		unsigned int GetFrames();
+
+	protected :
+
+		FILE* m_file = nullptr;
+		rawHeader m_header{};
+		std::vector<uint64_t> m_offsets;
+		uint64_t m_position = 0;
+		bool Pad();
+
+};
@@ -0,0 +1,453 @@
+/*
+
+	ScrubThumbnails.cpp
+
+	Spout Video Player
+
+	Thumbnails over the timeline of a movie for the progress bar.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "ScrubThumbnails.h"
+#include "MediaProbe.h" // For the file stamp
+#include <filesystem>
+#include <fstream>
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#pragma comment(lib, "mfplat.lib")
+#pragma comment(lib, "mfreadwrite.lib")
+#pragma comment(lib, "mfuuid.lib")
+
+static const char thumbsMagic[4] = { 'S', 'V', 'T', '2' };
+
+struct thumbsHeader {
+	char magic[4];
+	uint64_t size;    // movie file size
+	int64_t modified; // movie file time
+	int width;        // thumbnail size
+	int height;
+	int thumbs;
+	int pathLength;   // followed by the path and the atlas pixels
+};
+
+template <class T> static void SafeRelease(T** pp)
+{
+	if (*pp) {
+		(*pp)->Release();
+		*pp = nullptr;
+	}
+}
+
+scrubThumbnails::~scrubThumbnails()
+{
+	Close();
+}
+
+//---------------------------------------------------------
+// Function: Open
+void scrubThumbnails::Open(std::string path, int width, int height, std::string cachefile)
+{
+	Close();
+
+	if (path.empty() || width <= 0 || height <= 0)
+		return;
+
+	m_width = THUMB_WIDTH;
+	m_height = THUMB_WIDTH*height/width;
+	if (m_height < 2) m_height = 2;
+	if (m_height > THUMB_WIDTH) m_height = THUMB_WIDTH;
+	m_height &= ~1; // Even for the video processor
+
+	m_job = std::make_shared<job>();
+	m_job->path = path;
+	m_job->cachefile = cachefile;
+	m_job->width = m_width;
+	m_job->height = m_height;
+	m_job->pixels.allocate(COLUMNS*m_width, (THUMBS/COLUMNS)*m_height, OF_PIXELS_RGBA);
+	m_job->pixels.set(0);
+
+	std::thread(&scrubThumbnails::Extract, m_job).detach();
+}
+
+//---------------------------------------------------------
+// Function: Close
+// The thread keeps the job until it ends
+void scrubThumbnails::Close()
+{
+	if (m_job) {
+		m_job->bStop = true;
+		m_job.reset();
+	}
+
+	m_atlas.clear();
+	for (int i = 0; i < THUMBS; i++)
+		m_bUploaded[i] = false;
+}
+
+//---------------------------------------------------------
+// Function: Update
+// New thumbnails are copied to the texture from the atlas pixels
+void scrubThumbnails::Update()
+{
+	if (!m_job)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_job->mutex);
+	ofPixels &pixels = m_job->pixels;
+	int atlasWidth = (int)pixels.getWidth();
+	if (!m_atlas.isAllocated())
+		m_atlas.allocate(atlasWidth, (int)pixels.getHeight(), GL_RGBA8);
+
+	GLenum target = m_atlas.getTextureData().textureTarget;
+	bool bBound = false;
+	for (int i = 0; i < THUMBS; i++) {
+		if (!m_job->bReady[i] || m_bUploaded[i])
+			continue;
+		if (!bBound) {
+			glBindTexture(target, m_atlas.getTextureData().textureID);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, atlasWidth);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			bBound = true;
+		}
+		int x = (i % COLUMNS)*m_width;
+		int y = (i / COLUMNS)*m_height;
+		glTexSubImage2D(target, 0, x, y, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE,
+			pixels.getData() + ((size_t)y*atlasWidth + x)*4);
+		m_bUploaded[i] = true;
+	}
+	if (bBound) {
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glBindTexture(target, 0);
+	}
+}
+
+//---------------------------------------------------------
+// Function: Draw
+bool scrubThumbnails::Draw(float position, float x, float y)
+{
+	if (!m_atlas.isAllocated())
+		return false;
+
+	int thumb = (int)(position*(float)THUMBS);
+	if (thumb < 0) thumb = 0;
+	if (thumb >= THUMBS) thumb = THUMBS-1;
+
+	// Nearest thumbnail available
+	int found = -1;
+	for (int d = 0; d < THUMBS && found < 0; d++) {
+		if (thumb - d >= 0 && m_bUploaded[thumb - d])
+			found = thumb - d;
+		else if (thumb + d < THUMBS && m_bUploaded[thumb + d])
+			found = thumb + d;
+	}
+	if (found < 0)
+		return false;
+
+	m_atlas.drawSubsection(x, y, (float)m_width, (float)m_height,
+		(float)((found % COLUMNS)*m_width), (float)((found / COLUMNS)*m_height),
+		(float)m_width, (float)m_height);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: GetWidth
+int scrubThumbnails::GetWidth()
+{
+	return m_width;
+}
+
+//---------------------------------------------------------
+// Function: GetHeight
+int scrubThumbnails::GetHeight()
+{
+	return m_height;
+}
+
+//---------------------------------------------------------
+// Function: Extract
+// Runs on the thread with COM and Media Foundation
+// started and shut down by the thread itself
+void scrubThumbnails::Extract(std::shared_ptr<job> work)
+{
+	if (LoadFile(*work))
+		return;
+
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
+
+	HRESULT hr = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+	if (FAILED(hr))
+		return;
+	if (SUCCEEDED(MFStartup(MF_VERSION, MFSTARTUP_NOSOCKET))) {
+		if (Decode(*work) && !work->bStop)
+			SaveFile(*work);
+		MFShutdown();
+	}
+	CoUninitialize();
+}
+
+//---------------------------------------------------------
+// Function: Decode
+// After a seek the source reader delivers the key frame before
+// the position first, so that only key frames are decoded.
+// If the video processor cannot scale, frames are reduced here.
+// Returns true if all the thumbnails were extracted.
+bool scrubThumbnails::Decode(job &work)
+{
+	IMFAttributes* attributes = nullptr;
+	IMFSourceReader* reader = nullptr;
+	IMFMediaType* type = nullptr;
+	IMFMediaType* current = nullptr;
+	const DWORD stream = (DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM;
+
+	wchar_t wpath[MAX_PATH]{};
+	MultiByteToWideChar(CP_ACP, 0, work.path.c_str(), -1, wpath, MAX_PATH);
+
+	HRESULT hr = MFCreateAttributes(&attributes, 1);
+	if (SUCCEEDED(hr))
+		hr = attributes->SetUINT32(MF_SOURCE_READER_ENABLE_ADVANCED_VIDEO_PROCESSING, TRUE);
+	if (SUCCEEDED(hr))
+		hr = MFCreateSourceReaderFromURL(wpath, attributes, &reader);
+	if (SUCCEEDED(hr))
+		hr = reader->SetStreamSelection((DWORD)MF_SOURCE_READER_ALL_STREAMS, FALSE);
+	if (SUCCEEDED(hr))
+		hr = reader->SetStreamSelection(stream, TRUE);
+
+	// 32 bit BGRX at the thumbnail size, or at the movie size
+	if (SUCCEEDED(hr))
+		hr = MFCreateMediaType(&type);
+	if (SUCCEEDED(hr))
+		hr = type->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Video);
+	if (SUCCEEDED(hr))
+		hr = type->SetGUID(MF_MT_SUBTYPE, MFVideoFormat_RGB32);
+	if (SUCCEEDED(hr)) {
+		MFSetAttributeSize(type, MF_MT_FRAME_SIZE, (UINT32)work.width, (UINT32)work.height);
+		if (FAILED(reader->SetCurrentMediaType(stream, NULL, type))) {
+			type->DeleteItem(MF_MT_FRAME_SIZE);
+			hr = reader->SetCurrentMediaType(stream, NULL, type);
+		}
+	}
+
+	UINT32 width = 0, height = 0;
+	LONG stride = 0;
+	if (SUCCEEDED(hr))
+		hr = reader->GetCurrentMediaType(stream, &current);
+	if (SUCCEEDED(hr))
+		hr = MFGetAttributeSize(current, MF_MT_FRAME_SIZE, &width, &height);
+	if (SUCCEEDED(hr))
+		stride = (LONG)MFGetAttributeUINT32(current, MF_MT_DEFAULT_STRIDE, width*4);
+
+	LONGLONG duration = 0;
+	if (SUCCEEDED(hr)) {
+		PROPVARIANT var;
+		PropVariantInit(&var);
+		hr = reader->GetPresentationAttribute((DWORD)MF_SOURCE_READER_MEDIASOURCE, MF_PD_DURATION, &var);
+		if (SUCCEEDED(hr))
+			duration = (LONGLONG)var.uhVal.QuadPart; // 100 nsec units
+		PropVariantClear(&var);
+	}
+
+	if (FAILED(hr) || width == 0 || height == 0 || duration <= 0) {
+		SpoutLogWarning("scrubThumbnails::Decode - could not read %s", work.path.c_str());
+		SafeRelease(&current);
+		SafeRelease(&type);
+		SafeRelease(&reader);
+		SafeRelease(&attributes);
+		return false;
+	}
+
+	ofPixels frame, thumb;
+	frame.allocate(width, height, OF_PIXELS_RGBA);
+	thumb.allocate(work.width, work.height, OF_PIXELS_RGBA);
+	size_t pitch = (size_t)abs(stride);
+
+	int extracted = 0;
+	for (int i = 0; i < THUMBS && !work.bStop; i++) {
+
+		WaitForIdle(work);
+		if (work.bStop)
+			break;
+
+		PROPVARIANT position;
+		PropVariantInit(&position);
+		position.vt = VT_I8;
+		position.hVal.QuadPart = duration*(2*i + 1)/(2*THUMBS);
+		if (FAILED(reader->SetCurrentPosition(GUID_NULL, position)))
+			continue;
+
+		// Skip stream ticks and gaps
+		IMFSample* sample = nullptr;
+		for (int tries = 0; tries < 10 && !sample && !work.bStop; tries++) {
+			DWORD flags = 0;
+			if (FAILED(reader->ReadSample(stream, 0, NULL, &flags, NULL, &sample))
+				|| (flags & MF_SOURCE_READERF_ENDOFSTREAM))
+				break;
+		}
+		if (!sample)
+			continue;
+
+		IMFMediaBuffer* buffer = nullptr;
+		BYTE* data = nullptr;
+		DWORD length = 0;
+		if (SUCCEEDED(sample->ConvertToContiguousBuffer(&buffer))
+			&& SUCCEEDED(buffer->Lock(&data, NULL, &length))) {
+			if ((size_t)length >= pitch*height) {
+				// Bottom up for a negative stride. BGRX to rgba.
+				for (UINT32 y = 0; y < height; y++) {
+					const BYTE* src = data + pitch*((stride < 0) ? (height - 1 - y) : y);
+					unsigned char* dst = frame.getData() + (size_t)y*width*4;
+					for (UINT32 x = 0; x < width; x++) {
+						dst[x*4 + 0] = src[x*4 + 2];
+						dst[x*4 + 1] = src[x*4 + 1];
+						dst[x*4 + 2] = src[x*4 + 0];
+						dst[x*4 + 3] = 255;
+					}
+				}
+				if ((int)width == work.width && (int)height == work.height)
+					thumb = frame;
+				else
+					frame.resizeTo(thumb, OF_INTERPOLATE_BILINEAR);
+
+				std::lock_guard<std::mutex> lock(work.mutex);
+				thumb.pasteInto(work.pixels, (i % COLUMNS)*work.width, (i / COLUMNS)*work.height);
+				work.bReady[i] = true;
+				extracted++;
+			}
+			buffer->Unlock();
+		}
+		SafeRelease(&buffer);
+		SafeRelease(&sample);
+	}
+
+	SafeRelease(&current);
+	SafeRelease(&type);
+	SafeRelease(&reader);
+	SafeRelease(&attributes);
+
+	return (extracted == THUMBS);
+}
+
+//---------------------------------------------------------
+// Function: WaitForIdle
+// Wait while more than half of the processor time is used,
+// for at most 5 seconds so that thumbnails are still made.
+void scrubThumbnails::WaitForIdle(job &work)
+{
+	for (int i = 0; i < 50 && !work.bStop; i++) {
+		FILETIME idle0, kernel0, user0, idle1, kernel1, user1;
+		if (!GetSystemTimes(&idle0, &kernel0, &user0))
+			return;
+		Sleep(100);
+		if (!GetSystemTimes(&idle1, &kernel1, &user1))
+			return;
+
+		auto ticks = [](const FILETIME &t0, const FILETIME &t1) {
+			ULARGE_INTEGER a{}, b{};
+			a.LowPart = t0.dwLowDateTime; a.HighPart = t0.dwHighDateTime;
+			b.LowPart = t1.dwLowDateTime; b.HighPart = t1.dwHighDateTime;
+			return (double)(b.QuadPart - a.QuadPart);
+		};
+		// Kernel time includes idle time
+		double total = ticks(kernel0, kernel1) + ticks(user0, user1);
+		if (total <= 0.0 || ticks(idle0, idle1)/total > 0.5)
+			return;
+	}
+}
+
+//---------------------------------------------------------
+// Function: LoadFile
+// Thumbnails saved for the same movie file and size
+bool scrubThumbnails::LoadFile(job &work)
+{
+	uint64_t size = 0;
+	int64_t modified = 0;
+	if (work.cachefile.empty() || !mediaProbe::GetFileStamp(work.path, size, modified))
+		return false;
+
+	std::ifstream file(work.cachefile, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	thumbsHeader head{};
+	if (!file.read((char*)&head, sizeof(head))
+		|| memcmp(head.magic, thumbsMagic, 4) != 0
+		|| head.size != size || head.modified != modified
+		|| head.width != work.width || head.height != work.height || head.thumbs != THUMBS
+		|| head.pathLength != (int)work.path.size())
+		return false;
+
+	// Another path with the same hash
+	std::string stored(head.pathLength, '\0');
+	if (!file.read(&stored[0], head.pathLength) || stored != work.path)
+		return false;
+
+	ofPixels pixels;
+	pixels.allocate(COLUMNS*work.width, (THUMBS/COLUMNS)*work.height, OF_PIXELS_RGBA);
+	if (!file.read((char*)pixels.getData(), pixels.getTotalBytes()))
+		return false;
+
+	std::lock_guard<std::mutex> lock(work.mutex);
+	work.pixels.swap(pixels);
+	for (int i = 0; i < THUMBS; i++)
+		work.bReady[i] = true;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: SaveFile
+// The atlas is copied so that the player is not held by the write
+bool scrubThumbnails::SaveFile(job &work)
+{
+	uint64_t size = 0;
+	int64_t modified = 0;
+	if (work.cachefile.empty() || !mediaProbe::GetFileStamp(work.path, size, modified))
+		return false;
+
+	ofPixels pixels;
+	{
+		std::lock_guard<std::mutex> lock(work.mutex);
+		pixels = work.pixels;
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(std::filesystem::path(work.cachefile).parent_path(), ec);
+
+	std::ofstream file(work.cachefile, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		SpoutLogWarning("scrubThumbnails::SaveFile - could not create %s", work.cachefile.c_str());
+		return false;
+	}
+
+	thumbsHeader head{};
+	memcpy(head.magic, thumbsMagic, 4);
+	head.size = size;
+	head.modified = modified;
+	head.width = work.width;
+	head.height = work.height;
+	head.thumbs = THUMBS;
+	head.pathLength = (int)work.path.size();
+
+	file.write((const char*)&head, sizeof(head));
+	file.write(work.path.data(), work.path.size());
+	file.write((const char*)pixels.getData(), pixels.getTotalBytes());
+
+	return file.good();
+}
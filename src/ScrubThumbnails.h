@@ -0,0 +1,105 @@
+/*
+
+	ScrubThumbnails.h
+
+	Spout Video Player
+
+	Thumbnails over the timeline of a movie for the progress bar.
+
+	A thread reads the movie with a Media Foundation source reader of its
+	own. For each of the evenly spaced positions it seeks and decodes only
+	the key frame before the position, scaled to the thumbnail size by the
+	video processor, into one atlas. The reader is independent of the
+	DirectShow players, which share their COM initialisation and are opened
+	and closed on the decoder thread only (see DecoderThread.h). The thread runs at idle priority and waits
+	while the processors are busy so that playback is not affected.
+
+	The thread works on a job shared with the player. Close does not wait
+	for it. The job is marked to stop and the thread ends by itself when
+	the call it is in returns, for example the open of a slow network file.
+
+	When all the thumbnails have been extracted, the atlas is saved in the
+	probe cache folder (see MediaProbe.h) and read from there the next time
+	if the movie has not changed. Thumbnails are uploaded to the atlas
+	texture as they become available.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutUtils.h" // For logging
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace spoututils;
+
+class scrubThumbnails {
+
+	public:
+
+		static const int THUMBS = 100;
+		static const int COLUMNS = 10;
+		static const int THUMB_WIDTH = 160;
+
+		~scrubThumbnails();
+
+		// Start for a movie of the given size.
+		// The atlas is saved in the cache file if there is one.
+		void Open(std::string path, int width, int height, std::string cachefile);
+		void Close();
+
+		// Upload the thumbnails extracted since the last update
+		void Update();
+
+		// Draw the thumbnail nearest to a movie position (0 - 1).
+		// Returns false if there are none yet.
+		bool Draw(float position, float x, float y);
+
+		// Thumbnail size
+		int GetWidth();
+		int GetHeight();
+
+	protected :
+
+		// State shared with the thread, which may end after Close
+		struct job {
+			std::string path;
+			std::string cachefile;
+			int width = 0;
+			int height = 0;
+			std::atomic<bool> bStop{false};
+			std::mutex mutex;
+			ofPixels pixels;         // atlas written by the thread
+			bool bReady[THUMBS]{};   // thumbnail in pixels
+		};
+		std::shared_ptr<job> m_job;
+
+		int m_width = 0;
+		int m_height = 0;
+		bool m_bUploaded[THUMBS]{}; // thumbnail in m_atlas
+		ofTexture m_atlas;
+
+		static void Extract(std::shared_ptr<job> work);
+		static bool Decode(job &work);
+		static void WaitForIdle(job &work);
+		static bool LoadFile(job &work);
+		static bool SaveFile(job &work);
+
+};
@@ -61,6 +61,7 @@
 //			21.11.23	- Add defines for : GL_MAX_COMPUTE_WORK_GROUP_COUNT, GL_MAX_COMPUTE_WORK_GROUP_SIZE
 //						  GL_ATTACHED_SHADERS, GL_INFO_LOG_LENGTH
 //						  Add glGetProgramInfoLog, glGetShaderInfoLog, glGetIntegeri_v
+//			19.10.26	- Add glBindBufferBase, GL_SHADER_STORAGE_BUFFER, GL_BUFFER_UPDATE_BARRIER_BIT
 //
 
 	Copyright (c) 2014-2024, Lynn Jarvis. All rights reserved.
@@ -182,6 +183,7 @@ glDispatchComputePROC    glDispatchCompute  = NULL;
 glDeleteProgramPROC      glDeleteProgram    = NULL;
 glDeleteShaderPROC       glDeleteShader     = NULL;
 glMemoryBarrierPROC      glMemoryBarrier    = NULL;
+glBindBufferBasePROC     glBindBufferBase   = NULL;
 glActiveTexturePROC      glActiveTexture    = NULL;
 glUniform1iPROC          glUniform1i        = NULL;
 glUniform1fPROC          glUniform1f        = NULL;
@@ -473,6 +475,7 @@ bool loadComputeShaderExtensions()
 	glDeleteProgram    = (glDeleteProgramPROC)wglGetProcAddress("glDeleteProgram");
 	glDeleteShader     = (glDeleteShaderPROC)wglGetProcAddress("glDeleteShader");
 	glMemoryBarrier    = (glMemoryBarrierPROC)wglGetProcAddress("glMemoryBarrier");
+	glBindBufferBase   = (glBindBufferBasePROC)wglGetProcAddress("glBindBufferBase");
 	glActiveTexture    = (glActiveTexturePROC)wglGetProcAddress("glActiveTexture");
 	glUniform1i        = (glUniform1iPROC)wglGetProcAddress("glUniform1i");
 	glUniform1f        = (glUniform1fPROC)wglGetProcAddress("glUniform1f");
@@ -511,6 +514,7 @@ bool loadComputeShaderExtensions()
 		&& glUniform1f != NULL
 		&& glDeleteShader != NULL
 		&& glMemoryBarrier != NULL
+		&& glBindBufferBase != NULL
 		&& glGetUniformLocation != NULL
 		&& glTextureStorage2D != NULL
 		&& glCreateTextures != NULL
@@ -738,6 +738,29 @@ typedef void   (APIENTRY* glMemoryBarrierPROC) (GLbitfield barriers);
 #define GL_ALL_BARRIER_BITS 0xFFFFFFFF
 #endif
 
+#ifndef GL_BUFFER_UPDATE_BARRIER_BIT
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#endif
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+
+#ifndef GL_DYNAMIC_COPY
+#define GL_DYNAMIC_COPY 0x88EA
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// Shader storage buffer binding
+typedef void   (APIENTRY* glBindBufferBasePROC) (GLenum target, GLuint index, GLuint buffer);
+
 extern glCreateProgramPROC		glCreateProgram;
 extern glCreateShaderPROC       glCreateShader;
 extern glShaderSourcePROC       glShaderSource;
@@ -755,6 +778,7 @@ extern glDispatchComputePROC    glDispatchCompute;
 extern glDeleteProgramPROC      glDeleteProgram;
 extern glDeleteShaderPROC       glDeleteShader;
 extern glMemoryBarrierPROC      glMemoryBarrier;
+extern glBindBufferBasePROC     glBindBufferBase;
 
 typedef void (APIENTRY* glActiveTexturePROC)(GLenum texture);
 extern glActiveTexturePROC      glActiveTexture;
@@ -34,6 +34,17 @@
 	20.10.23 - SetGLformat - add missing GL_RGBA8
 	09.11.23 - Add contrast adaptive sharpen
 			   Code cleanup
+	19.10.26 - Add image hash
+			   Add blend, block motion search and motion interpolation
+			   ComputeShader - optional second and third source images
+			   Add motion adaptive deinterlace
+			   Add temporal denoise combined with image adjust
+			   Add nv12 to rgba conversion
+			   Add histogram, waveform and vectorscope
+			   Add luminance levels for auto levels
+			   Add user effects from shader files
+			   GetFileString - public and static
+			   ComputeShader - uniforms 4 and 5
 
 */
 
@@ -64,6 +75,21 @@ spoutShaders::~spoutShaders() {
 	if (m_sharpenProgram  > 0) glDeleteProgram(m_sharpenProgram);
 	if (m_casProgram      > 0) glDeleteProgram(m_casProgram);
 	if (m_kuwaharaProgram > 0) glDeleteProgram(m_kuwaharaProgram);
+	if (m_hashProgram     > 0) glDeleteProgram(m_hashProgram);
+	for (int i = 0; i < HASH_RING; i++) {
+		if (m_hashFence[i]) glDeleteSync(m_hashFence[i]);
+		if (m_hashBuffer[i] > 0) glDeleteBuffers(1, &m_hashBuffer[i]);
+	}
+	if (m_scopeProgram    > 0) glDeleteProgram(m_scopeProgram);
+	if (m_scopeDrawProgram > 0) glDeleteProgram(m_scopeDrawProgram);
+	if (m_scopeBuffer     > 0) glDeleteBuffers(1, &m_scopeBuffer);
+	if (m_levelsProgram   > 0) glDeleteProgram(m_levelsProgram);
+	if (m_blendProgram    > 0) glDeleteProgram(m_blendProgram);
+	if (m_searchProgram   > 0) glDeleteProgram(m_searchProgram);
+	if (m_interpProgram   > 0) glDeleteProgram(m_interpProgram);
+	if (m_deintProgram    > 0) glDeleteProgram(m_deintProgram);
+	if (m_denoiseProgram  > 0) glDeleteProgram(m_denoiseProgram);
+	if (m_yuvProgram      > 0) glDeleteProgram(m_yuvProgram);
 
 }
 
@@ -163,6 +189,247 @@ bool spoutShaders::AdaptiveSharpen(GLuint SourceID,
 		SourceID, 0, width, height, caswidth, caslevel);
 }
 
+//---------------------------------------------------------
+// Function: Hash
+//     64 bit hash of the image pixels
+//     Used to find if an image has changed.
+//     The shader writes to the next buffer of a ring and
+//     a fence follows, so the caller does not wait here.
+//     A result that was not read is discarded.
+bool spoutShaders::Hash(GLuint SourceID, unsigned int width, unsigned int height)
+{
+	if (!glBindBufferBase)
+		return false;
+
+	int i = m_hashNext;
+	if (m_hashFence[i]) {
+		glDeleteSync(m_hashFence[i]);
+		m_hashFence[i] = nullptr;
+	}
+
+	GLuint result[2] = { 0, 0 };
+	if (m_hashBuffer[i] == 0) {
+		glGenBuffers(1, &m_hashBuffer[i]);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_hashBuffer[i]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(result), result, GL_DYNAMIC_READ);
+	}
+	else {
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_hashBuffer[i]);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(result), result);
+	}
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_hashBuffer[i]);
+
+	bool bResult = ComputeShader(m_hashstr, m_hashProgram, SourceID, 0, width, height);
+	if (bResult) {
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		m_hashFence[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_hashLast = i;
+		m_hashNext = (i + 1) % HASH_RING;
+		// Start the shader before the result is polled
+		glFlush();
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	return bResult;
+}
+
+//---------------------------------------------------------
+// Function: HashResult
+//     Result of the last hash
+//     The fence is polled without waiting. If the shader has not
+//     completed, false is returned and the result can be read later
+//     until the next hash is queued.
+bool spoutShaders::HashResult(uint64_t &hash)
+{
+	if (m_hashLast < 0 || !m_hashFence[m_hashLast])
+		return false;
+
+	int i = m_hashLast;
+	GLenum status = glClientWaitSync(m_hashFence[i], 0, 0);
+	if (status == GL_TIMEOUT_EXPIRED)
+		return false;
+	m_hashLast = -1;
+	glDeleteSync(m_hashFence[i]);
+	m_hashFence[i] = nullptr;
+	if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		return false;
+
+	bool bResult = false;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_hashBuffer[i]);
+	GLuint* data = (GLuint*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, 2*sizeof(GLuint), GL_MAP_READ_BIT);
+	if (data) {
+		hash = ((uint64_t)data[0] << 32) | (uint64_t)data[1];
+		glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		bResult = true;
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	return bResult;
+}
+
+//---------------------------------------------------------
+// Function: Scopes
+//     Histogram, waveform and vectorscope of the source image
+//     DestID - 768x256 overlay image
+//     step   - pixels between the samples in x and y
+//     The counts are cleared by the overlay pass so that
+//     the buffer is only uploaded when it is created.
+bool spoutShaders::Scopes(GLuint SourceID, GLuint DestID,
+	unsigned int width, unsigned int height, unsigned int step)
+{
+	if (!glBindBufferBase || DestID == 0 || step == 0)
+		return false;
+
+	unsigned int gridx = width / step;
+	unsigned int gridy = height / step;
+	if (gridx == 0 || gridy == 0)
+		return false;
+
+	if (m_scopeBuffer == 0) {
+		std::vector<GLuint> counts(1024 + 256*256 + 128*128, 0);
+		glGenBuffers(1, &m_scopeBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_scopeBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, counts.size()*sizeof(GLuint), counts.data(), GL_DYNAMIC_COPY);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_scopeBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_scopeBuffer);
+
+	bool bResult = ComputeShader(m_scopestr, m_scopeProgram, SourceID, 0,
+		gridx, gridy, (float)step);
+	if (bResult) {
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		bResult = ComputeShader(m_scopedrawstr, m_scopeDrawProgram, DestID, 0,
+			256, 256, (float)(gridx*gridy));
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	return bResult;
+}
+
+//---------------------------------------------------------
+// Function: Levels
+//     Luminance minimum, maximum, sum and count of samples
+//     BufferID - storage buffer for four unsigned integers
+//     step     - pixels between the samples in x and y
+//     The buffer is initialized and the shader dispatched but
+//     the result is not read here. The caller maps the buffer
+//     when a fence shows that the shader has completed.
+bool spoutShaders::Levels(GLuint SourceID, GLuint BufferID,
+	unsigned int width, unsigned int height, unsigned int step)
+{
+	if (!glBindBufferBase || BufferID == 0 || step == 0)
+		return false;
+
+	unsigned int gridx = width / step;
+	unsigned int gridy = height / step;
+	if (gridx == 0 || gridy == 0)
+		return false;
+
+	GLuint result[4] = { 255, 0, 0, 0 };
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, BufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(result), result, GL_STREAM_READ);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, BufferID);
+
+	bool bResult = ComputeShader(m_levelsstr, m_levelsProgram, SourceID, 0,
+		gridx, gridy, (float)step);
+	if (bResult)
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	return bResult;
+}
+
+//---------------------------------------------------------
+// Function: Blend
+//     Mix of two images
+//     amount - 0 first image > 1 second image
+bool spoutShaders::Blend(GLuint SourceID, GLuint Source2ID, GLuint DestID,
+	unsigned int width, unsigned int height, float amount)
+{
+	return ComputeShader(m_blendstr, m_blendProgram, SourceID, DestID,
+		width, height, amount, -1.0, -1.0, -1.0, Source2ID);
+}
+
+//---------------------------------------------------------
+// Function: MotionSearch
+//     Motion vectors for 16x16 blocks of the second image
+//     VectorID - texture of (width+15)/16 x (height+15)/16
+bool spoutShaders::MotionSearch(GLuint SourceID, GLuint Source2ID, GLuint VectorID,
+	unsigned int width, unsigned int height)
+{
+	return ComputeShader(m_searchstr, m_searchProgram, SourceID, VectorID,
+		(width+15)/16, (height+15)/16, -1.0, -1.0, -1.0, -1.0, Source2ID);
+}
+
+//---------------------------------------------------------
+// Function: MotionInterpolate
+//     Image between two images using vectors from MotionSearch
+//     amount    - 0 first image > 1 second image
+//     threshold - mean block difference above which
+//                 the images are blended (0.05 - 0.1 typical)
+bool spoutShaders::MotionInterpolate(GLuint SourceID, GLuint Source2ID, GLuint VectorID, GLuint DestID,
+	unsigned int width, unsigned int height, float amount, float threshold)
+{
+	return ComputeShader(m_interpstr, m_interpProgram, SourceID, DestID,
+		width, height, amount, threshold, -1.0, -1.0, Source2ID, VectorID);
+}
+
+//---------------------------------------------------------
+// Function: Deinterlace
+//     Motion adaptive deinterlace of the source frame
+//     PrevID, NextID - frames before and after the source
+//     parity  - field lines kept, 0 even (top) 1 odd (bottom)
+//     bSecond - the field is the second in time of the frame
+//     Dest must be a different texture to the source
+bool spoutShaders::Deinterlace(GLuint SourceID, GLuint PrevID, GLuint NextID, GLuint DestID,
+	unsigned int width, unsigned int height, int parity, bool bSecond)
+{
+	return ComputeShader(m_deintstr, m_deintProgram, SourceID, DestID,
+		width, height, (float)parity, bSecond ? 1.0f : 0.0f, -1.0, -1.0, PrevID, NextID);
+}
+
+//---------------------------------------------------------
+// Function: YuvToRgba
+//     Convert an nv12 frame to rgba
+//     SourceID   - nv12 bytes as an rgba texture width/4 x height*3/2
+//     DestID     - rgba texture width x height
+//     matrix     - 0 BT.601, 1 BT.709, 2 BT.2020
+//     bFullRange - full range rather than limited (video) range
+//     Width must be a multiple of 4 and height a multiple of 2
+bool spoutShaders::YuvToRgba(GLuint SourceID, GLuint DestID,
+	unsigned int width, unsigned int height, int matrix, bool bFullRange)
+{
+	if ((width % 4) != 0 || (height % 2) != 0)
+		return false;
+
+	return ComputeShader(m_yuvstr, m_yuvProgram, SourceID, DestID,
+		width, height, (float)matrix, bFullRange ? 1.0f : 0.0f);
+}
+
+//---------------------------------------------------------
+// Function: DenoiseAdjust
+//     Temporal denoise followed by image adjust
+//     HistoryID - denoised previous frame, same size as the source
+//     strength  - 0 - 1 (0 copies the source to the history)
+//     bUpdate   - keep the result in the history
+//     Dest can be the source
+bool spoutShaders::DenoiseAdjust(GLuint SourceID, GLuint HistoryID, GLuint DestID,
+	unsigned int width, unsigned int height, float strength, bool bUpdate,
+	float brightness, float contrast,
+	float saturation, float gamma)
+{
+	return ComputeShader(m_denoisestr, m_denoiseProgram, HistoryID, DestID,
+		width, height, brightness, contrast, saturation, gamma, SourceID, 0,
+		strength, bUpdate ? 1.0f : 0.0f);
+}
+
 //---------------------------------------------------------
 // Function: SetGLformat
 // Set OpenGL format for shaders
@@ -207,6 +474,16 @@ void spoutShaders::SetGLformat(GLint glformat)
 		if (m_sharpenProgram  > 0) glDeleteProgram(m_sharpenProgram);
 		if (m_casProgram      > 0) glDeleteProgram(m_casProgram);
 		if (m_kuwaharaProgram > 0) glDeleteProgram(m_kuwaharaProgram);
+		if (m_hashProgram     > 0) glDeleteProgram(m_hashProgram);
+		if (m_blendProgram    > 0) glDeleteProgram(m_blendProgram);
+		if (m_searchProgram   > 0) glDeleteProgram(m_searchProgram);
+		if (m_interpProgram   > 0) glDeleteProgram(m_interpProgram);
+		if (m_deintProgram    > 0) glDeleteProgram(m_deintProgram);
+		if (m_denoiseProgram  > 0) glDeleteProgram(m_denoiseProgram);
+		if (m_yuvProgram      > 0) glDeleteProgram(m_yuvProgram);
+		if (m_scopeProgram    > 0) glDeleteProgram(m_scopeProgram);
+		if (m_scopeDrawProgram > 0) glDeleteProgram(m_scopeDrawProgram);
+		if (m_levelsProgram   > 0) glDeleteProgram(m_levelsProgram);
 
 		m_copyProgram     = 0;
 		m_flipProgram     = 0;
@@ -218,6 +495,16 @@ void spoutShaders::SetGLformat(GLint glformat)
 		m_sharpenProgram  = 0;
 		m_casProgram      = 0;
 		m_kuwaharaProgram = 0;
+		m_hashProgram     = 0;
+		m_blendProgram    = 0;
+		m_searchProgram   = 0;
+		m_interpProgram   = 0;
+		m_deintProgram    = 0;
+		m_denoiseProgram  = 0;
+		m_yuvProgram      = 0;
+		m_scopeProgram    = 0;
+		m_scopeDrawProgram = 0;
+		m_levelsProgram   = 0;
 
 		// No notice for GL_RGBA -> GL_RGBA8
 		if (glformat != GL_RGBA) {
@@ -258,9 +545,12 @@ void spoutShaders::CheckShaderFormat(std::string &shaderstr)
 // Function: ComputeShader
 //    Apply compute shader on source to dest
 //    or to read/write source with provided uniforms
+//    Optional read only sources are bound to units 2 and 3
+//    and optional uniforms 4 and 5 follow them
 bool spoutShaders::ComputeShader(std::string &shaderstr, GLuint &program,
 	GLuint SourceID, GLuint DestID, unsigned int width, unsigned int height,
-	float uniform0, float uniform1, float uniform2, float uniform3)
+	float uniform0, float uniform1, float uniform2, float uniform3,
+	GLuint Source2ID, GLuint Source3ID, float uniform4, float uniform5)
 {
 	if (shaderstr.empty() || SourceID == 0) {
 		SpoutLogWarning("spoutShaders::ComputeShader - no shader or texture");
@@ -292,14 +582,24 @@ bool spoutShaders::ComputeShader(std::string &shaderstr, GLuint &program,
 	glBindImageTexture(0, SourceID, 0, GL_FALSE, 0, GL_READ_WRITE, m_GLformat);
 	if(DestID > 0)
 	  glBindImageTexture(1, DestID, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_GLformat);
+	if(Source2ID > 0)
+	  glBindImageTexture(2, Source2ID, 0, GL_FALSE, 0, GL_READ_ONLY, m_GLformat);
+	if(Source3ID > 0)
+	  glBindImageTexture(3, Source3ID, 0, GL_FALSE, 0, GL_READ_ONLY, m_GLformat);
 	if (uniform0 != -1.0) glUniform1f(0, uniform0);
 	if (uniform1 != -1.0) glUniform1f(1, uniform1);
 	if (uniform2 != -1.0) glUniform1f(2, uniform2);
 	if (uniform3 != -1.0) glUniform1f(3, uniform3);
+	if (uniform4 != -1.0) glUniform1f(4, uniform4);
+	if (uniform5 != -1.0) glUniform1f(5, uniform5);
 	glDispatchCompute(width / nWgX, height / nWgY, 1);
 	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_WRITE, m_GLformat);
 	glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_GLformat);
+	if(Source2ID > 0)
+	  glBindImageTexture(2, 0, 0, GL_FALSE, 0, GL_READ_ONLY, m_GLformat);
+	if(Source3ID > 0)
+	  glBindImageTexture(3, 0, 0, GL_FALSE, 0, GL_READ_ONLY, m_GLformat);
 	glUseProgram(0);
 
 	return true;
@@ -372,6 +672,140 @@ unsigned int spoutShaders::CreateComputeShader(std::string shader, unsigned int
 	return 0;
 }
 
+//---------------------------------------------------------
+// Function: CreateEffect
+// The shader text has no version or work group size. These are added
+// for the image size as for the shaders above. The link status is not
+// checked here so that parallel compilation does not wait.
+GLuint spoutShaders::CreateEffect(std::string shaderstr, unsigned int width, unsigned int height,
+	GLuint &shader)
+{
+	shader = 0;
+	if (shaderstr.empty() || width == 0 || height == 0 || !glCreateProgram)
+		return 0;
+
+	// Compile with driver threads if available
+	if (m_parallelCompile < 0) {
+		typedef void (APIENTRY* glMaxShaderCompilerThreadsKHRPROC) (GLuint count);
+		glMaxShaderCompilerThreadsKHRPROC glMaxShaderCompilerThreadsKHR
+			= (glMaxShaderCompilerThreadsKHRPROC)wglGetProcAddress("glMaxShaderCompilerThreadsKHR");
+		if (glMaxShaderCompilerThreadsKHR) {
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF); // driver default
+			m_parallelCompile = 1;
+		}
+		else {
+			m_parallelCompile = 0;
+		}
+	}
+
+	// Format names from the first layout so that comments before it are ignored
+	size_t pos = shaderstr.find("layout(");
+	if (pos != std::string::npos) {
+		std::string body = shaderstr.substr(pos);
+		CheckShaderFormat(body);
+		shaderstr = shaderstr.substr(0, pos) + body;
+	}
+
+	unsigned int nWgX = width / (unsigned int)ceil((float)width / 32.0f);
+	unsigned int nWgY = nWgX * height / width;
+	if (nWgY == 0) nWgY = 1;
+
+	std::string source = "#version 440\n";
+	source += "layout(local_size_x = ";
+	source += std::to_string(nWgX);
+	source += ", local_size_y = ";
+	source += std::to_string(nWgY);
+	source += ", local_size_z = 1) in;\n";
+	source += shaderstr;
+
+	GLuint program = glCreateProgram();
+	if (program == 0)
+		return 0;
+	shader = glCreateShader(GL_COMPUTE_SHADER);
+	if (shader == 0) {
+		glDeleteProgram(program);
+		return 0;
+	}
+	const char* str = source.c_str();
+	glShaderSource(shader, 1, &str, NULL);
+	glCompileShader(shader);
+	glAttachShader(program, shader);
+	glLinkProgram(program);
+
+	return program;
+}
+
+//---------------------------------------------------------
+// Function: EffectStatus
+int spoutShaders::EffectStatus(GLuint &program, GLuint &shader, std::string &log)
+{
+	if (program == 0)
+		return -1;
+
+	GLint status = 0;
+	if (m_parallelCompile > 0) {
+		glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &status);
+		if (status == 0)
+			return 0;
+	}
+
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status != 0) {
+		// Deleted with the program
+		if (shader > 0)
+			glDeleteShader(shader);
+		shader = 0;
+		return 1;
+	}
+
+	// Compile errors are in the shader log and link errors in the program log
+	char errors[2048]{};
+	GLsizei length = 0;
+	if (shader > 0)
+		glGetShaderInfoLog(shader, 2048, &length, errors);
+	if (length == 0)
+		glGetProgramInfoLog(program, 2048, &length, errors);
+	log.assign(errors, length);
+
+	if (shader > 0) {
+		glDetachShader(program, shader);
+		glDeleteShader(shader);
+	}
+	glDeleteProgram(program);
+	shader = 0;
+	program = 0;
+
+	return -1;
+}
+
+//---------------------------------------------------------
+// Function: Effect
+//     Source image binding 0, destination binding 1
+//     The work groups are the same as for CreateEffect.
+bool spoutShaders::Effect(GLuint program, GLuint SourceID, GLuint DestID,
+	unsigned int width, unsigned int height, const std::vector<float> &uniforms)
+{
+	if (program == 0 || SourceID == 0 || DestID == 0 || width == 0 || height == 0)
+		return false;
+
+	unsigned int nWgX = width / (unsigned int)ceil((float)width / 32.0f);
+	unsigned int nWgY = nWgX * height / width;
+	if (nWgY == 0) nWgY = 1;
+
+	glUseProgram(program);
+	glBindImageTexture(0, SourceID, 0, GL_FALSE, 0, GL_READ_WRITE, m_GLformat);
+	glBindImageTexture(1, DestID, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_GLformat);
+	for (size_t i = 0; i < uniforms.size(); i++)
+		glUniform1f((GLint)i, uniforms[i]);
+	glDispatchCompute((width + nWgX - 1) / nWgX, (height + nWgY - 1) / nWgY, 1);
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_WRITE, m_GLformat);
+	glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_GLformat);
+	glUseProgram(0);
+
+	return true;
+}
+
 //---------------------------------------------------------
 // Function: GetFileString
 // Load complete shader source from file
@@ -98,6 +98,64 @@ class SPOUT_DLLEXP spoutShaders {
 		bool Kuwahara(GLuint SourceID, GLuint DestID,
 			unsigned int width, unsigned int height, float amount);
 
+		// 64 bit hash of the image pixels. The result is written to
+		// a ring of buffers with a fence and read by HashResult.
+		bool Hash(GLuint SourceID, unsigned int width, unsigned int height);
+
+		// Result of the last hash. False without waiting if the shader has not completed.
+		bool HashResult(uint64_t &hash);
+
+		// Histogram, waveform and vectorscope of the image
+		// drawn to a 768x256 overlay image
+		bool Scopes(GLuint SourceID, GLuint DestID,
+			unsigned int width, unsigned int height, unsigned int step);
+
+		// Minimum, maximum and sum of the luminance of the image
+		// added to a storage buffer that is read by the caller
+		bool Levels(GLuint SourceID, GLuint BufferID,
+			unsigned int width, unsigned int height, unsigned int step);
+
+		// Mix of two images
+		bool Blend(GLuint SourceID, GLuint Source2ID, GLuint DestID,
+			unsigned int width, unsigned int height, float amount);
+
+		// Block motion vectors from one image to the next
+		bool MotionSearch(GLuint SourceID, GLuint Source2ID, GLuint VectorID,
+			unsigned int width, unsigned int height);
+
+		// Image between two images using the block motion vectors
+		bool MotionInterpolate(GLuint SourceID, GLuint Source2ID, GLuint VectorID, GLuint DestID,
+			unsigned int width, unsigned int height, float amount, float threshold);
+
+		// Motion adaptive deinterlace
+		bool Deinterlace(GLuint SourceID, GLuint PrevID, GLuint NextID, GLuint DestID,
+			unsigned int width, unsigned int height, int parity, bool bSecond);
+
+		// Nv12 frame packed in an rgba texture to rgba
+		bool YuvToRgba(GLuint SourceID, GLuint DestID,
+			unsigned int width, unsigned int height, int matrix, bool bFullRange);
+
+		// Temporal denoise with a history image and image adjust in one pass
+		bool DenoiseAdjust(GLuint SourceID, GLuint HistoryID, GLuint DestID,
+			unsigned int width, unsigned int height, float strength, bool bUpdate,
+			float brightness, float contrast,
+			float saturation, float gamma);
+
+		// User effects from shader files
+		// Compile and link a program. The driver may compile in parallel
+		// and the program is not ready until EffectStatus returns 1.
+		GLuint CreateEffect(std::string shaderstr, unsigned int width, unsigned int height,
+			GLuint &shader);
+		// 1 linked, 0 still compiling, -1 failed with the errors in the log.
+		// The shader is deleted when complete and both are deleted for failure.
+		int EffectStatus(GLuint &program, GLuint &shader, std::string &log);
+		// Run an effect program with float uniforms at locations from 0
+		bool Effect(GLuint program, GLuint SourceID, GLuint DestID,
+			unsigned int width, unsigned int height, const std::vector<float> &uniforms);
+
+		// Text of a file, e.g. a shader
+		static std::string GetFileString(const char* filepath);
+
 		// Shader format
 		void SetGLformat(GLint glformat);
 		void CheckShaderFormat(std::string &shaderstr);
@@ -113,6 +171,22 @@ class SPOUT_DLLEXP spoutShaders {
 		GLuint m_sharpenProgram = 0;
 		GLuint m_casProgram     = 0;
 		GLuint m_kuwaharaProgram = 0;
+		GLuint m_hashProgram    = 0;
+		static const int HASH_RING = 3;
+		GLuint m_hashBuffer[HASH_RING]{}; // Shader storage buffers for the hash results
+		GLsync m_hashFence[HASH_RING]{};
+		int m_hashNext = 0;  // next buffer to use
+		int m_hashLast = -1; // buffer of the last hash not read
+		GLuint m_scopeProgram   = 0;
+		GLuint m_scopeDrawProgram = 0;
+		GLuint m_scopeBuffer    = 0; // Shader storage buffer for the scope counts
+		GLuint m_levelsProgram  = 0;
+		GLuint m_blendProgram   = 0;
+		GLuint m_searchProgram  = 0;
+		GLuint m_interpProgram  = 0;
+		GLuint m_deintProgram   = 0;
+		GLuint m_denoiseProgram = 0;
+		GLuint m_yuvProgram     = 0;
 
 	protected :
 
@@ -120,10 +194,12 @@ class SPOUT_DLLEXP spoutShaders {
 			GLuint SourceID, GLuint DestID, 
 			unsigned int width, unsigned int height,
 			float uniform0 = -1.0, float uniform1 = -1.0,
-			float uniform2 = -1.0, float uniform3 = -1.0);
+			float uniform2 = -1.0, float uniform3 = -1.0,
+			GLuint Source2ID = 0, GLuint Source3ID = 0,
+			float uniform4 = -1.0, float uniform5 = -1.0);
 		GLuint CreateComputeShader(std::string shader, unsigned int nWgX, unsigned int nWgY);
-		std::string GetFileString(const char* filepath);
 		GLint m_GLformat = GL_RGBA8;
+		int m_parallelCompile = -1; // GL_KHR_parallel_shader_compile, -1 not checked
 		std::string m_GLformatName = "rgba8";
 
 		//
@@ -464,6 +540,476 @@ class SPOUT_DLLEXP spoutShaders {
 			"	}\n"
 		"}\n";
 
+		//
+		// Image hash
+		// Each pixel is mixed with its position and summed and combined
+		// by exclusive or within the work group. One atomic for each
+		// result is then used for the work group. Invocations step by the
+		// dispatch size so that every pixel is included.
+		//
+		std::string m_hashstr = "layout(rgba8, binding=0) uniform readonly image2D src;\n"
+			"layout(std430, binding=0) buffer hashbuffer { uint hsum; uint hxor; };\n"
+			"shared uint gsum;\n"
+			"shared uint gxor;\n"
+			"uint mixbits(uint h) {\n"
+			"	h ^= h >> 16;\n"
+			"	h *= 0x85EBCA6Bu;\n"
+			"	h ^= h >> 13;\n"
+			"	h *= 0xC2B2AE35u;\n"
+			"	h ^= h >> 16;\n"
+			"	return h;\n"
+			"}\n"
+		"void main() {\n"
+			"	if (gl_LocalInvocationIndex == 0u) {\n"
+			"		gsum = 0u;\n"
+			"		gxor = 0u;\n"
+			"	}\n"
+			"	barrier();\n"
+			"	uvec2 size = uvec2(imageSize(src));\n"
+			"	uvec2 stride = gl_NumWorkGroups.xy * gl_WorkGroupSize.xy;\n"
+			"	uint s = 0u;\n"
+			"	uint x = 0u;\n"
+			"	for (uint py = gl_GlobalInvocationID.y; py < size.y; py += stride.y) {\n"
+			"		for (uint px = gl_GlobalInvocationID.x; px < size.x; px += stride.x) {\n"
+			"			uint c = packUnorm4x8(imageLoad(src, ivec2(px, py)));\n"
+			"			uint h = mixbits(c ^ ((py * size.x + px) * 0x9E3779B9u));\n"
+			"			s += h;\n"
+			"			x ^= mixbits(h + 0x7F4A7C15u);\n"
+			"		}\n"
+			"	}\n"
+			"	atomicAdd(gsum, s);\n"
+			"	atomicXor(gxor, x);\n"
+			"	barrier();\n"
+			"	if (gl_LocalInvocationIndex == 0u) {\n"
+			"		atomicAdd(hsum, gsum);\n"
+			"		atomicXor(hxor, gxor);\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Levels
+		// Luminance of the pixels on a grid of every step pixels, each the
+		// average of a 2x2 block to reduce noise. Each invocation finds the
+		// minimum, maximum and sum for its samples. These are reduced in
+		// shared memory for the work group and one atomic for each result
+		// is then used for the buffer : minimum, maximum, sum and count
+		// of levels 0 - 255.
+		//
+		std::string m_levelsstr = "layout(rgba8, binding=0) uniform readonly image2D src;\n"
+			"layout(std430, binding=0) buffer levelsbuffer { uint lmin; uint lmax; uint lsum; uint lcount; };\n"
+			"layout(location = 0) uniform float step;\n"
+			"shared uint gmin;\n"
+			"shared uint gmax;\n"
+			"shared uint gsum;\n"
+			"shared uint gcount;\n"
+		"void main() {\n"
+			"	if (gl_LocalInvocationIndex == 0u) {\n"
+			"		gmin = 255u;\n"
+			"		gmax = 0u;\n"
+			"		gsum = 0u;\n"
+			"		gcount = 0u;\n"
+			"	}\n"
+			"	barrier();\n"
+			"	ivec2 size = imageSize(src);\n"
+			"	int s = int(step);\n"
+			"	ivec2 grid = size / s;\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	uint vmin = 255u;\n"
+			"	uint vmax = 0u;\n"
+			"	uint vsum = 0u;\n"
+			"	uint vcount = 0u;\n"
+			"	for (int gy = int(gl_GlobalInvocationID.y); gy < grid.y; gy += stride.y) {\n"
+			"		for (int gx = int(gl_GlobalInvocationID.x); gx < grid.x; gx += stride.x) {\n"
+			"			ivec2 pos = ivec2(gx, gy) * s + s / 2;\n"
+			"			ivec2 pos1 = min(pos + 1, size - 1);\n"
+			"			vec3 c = imageLoad(src, pos).rgb + imageLoad(src, ivec2(pos1.x, pos.y)).rgb\n"
+			"				+ imageLoad(src, ivec2(pos.x, pos1.y)).rgb + imageLoad(src, pos1).rgb;\n"
+			"			float luma = dot(clamp(c * 0.25, 0.0, 1.0), vec3(0.2125, 0.7154, 0.0721));\n"
+			"			uint level = uint(luma * 255.0 + 0.5);\n"
+			"			vmin = min(vmin, level);\n"
+			"			vmax = max(vmax, level);\n"
+			"			vsum += level;\n"
+			"			vcount++;\n"
+			"		}\n"
+			"	}\n"
+			"	if (vcount > 0u) {\n"
+			"		atomicMin(gmin, vmin);\n"
+			"		atomicMax(gmax, vmax);\n"
+			"		atomicAdd(gsum, vsum);\n"
+			"		atomicAdd(gcount, vcount);\n"
+			"	}\n"
+			"	barrier();\n"
+			"	if (gl_LocalInvocationIndex == 0u && gcount > 0u) {\n"
+			"		atomicMin(lmin, gmin);\n"
+			"		atomicMax(lmax, gmax);\n"
+			"		atomicAdd(lsum, gsum);\n"
+			"		atomicAdd(lcount, gcount);\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Scopes
+		// Counts of the pixels on a grid of every step pixels are added
+		// to a storage buffer :
+		//     0      luma, red, green and blue histograms of 256 levels
+		//     1024   waveform of luma level for 256 columns (level*256 + column)
+		//     66560  vectorscope of BT.709 Cb, Cr in 128x128 bins (Cr*128 + Cb)
+		// The histograms are counted in shared memory for the work group
+		// and added to the buffer once. The waveform and vectorscope
+		// have too many bins for shared memory.
+		//
+		std::string m_scopestr = "layout(rgba8, binding=0) uniform readonly image2D src;\n"
+			"layout(std430, binding=0) buffer scopebuffer { uint scope[]; };\n"
+			"layout(location = 0) uniform float step;\n"
+			"shared uint ghist[1024];\n"
+		"void main() {\n"
+			"	uint groupsize = gl_WorkGroupSize.x * gl_WorkGroupSize.y;\n"
+			"	for (uint i = gl_LocalInvocationIndex; i < 1024u; i += groupsize)\n"
+			"		ghist[i] = 0u;\n"
+			"	barrier();\n"
+			"	ivec2 size = imageSize(src);\n"
+			"	int s = int(step);\n"
+			"	ivec2 grid = size / s;\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	for (int gy = int(gl_GlobalInvocationID.y); gy < grid.y; gy += stride.y) {\n"
+			"		for (int gx = int(gl_GlobalInvocationID.x); gx < grid.x; gx += stride.x) {\n"
+			"			ivec2 pos = ivec2(gx, gy) * s + s / 2;\n"
+			"			vec3 c = clamp(imageLoad(src, pos).rgb, 0.0, 1.0);\n"
+			"			float luma = dot(c, vec3(0.2126, 0.7152, 0.0722));\n"
+			"			uvec4 level = uvec4(vec4(luma, c) * 255.0 + 0.5);\n"
+			"			atomicAdd(ghist[level.x], 1u);\n"
+			"			atomicAdd(ghist[256u + level.y], 1u);\n"
+			"			atomicAdd(ghist[512u + level.z], 1u);\n"
+			"			atomicAdd(ghist[768u + level.w], 1u);\n"
+			"			uint column = uint(pos.x * 256 / size.x);\n"
+			"			atomicAdd(scope[1024u + level.x * 256u + column], 1u);\n"
+			"			vec2 cbcr = vec2((c.b - luma) / 1.8556, (c.r - luma) / 1.5748);\n"
+			"			uvec2 bin = uvec2(clamp((cbcr + 0.5) * 128.0, 0.0, 127.0));\n"
+			"			atomicAdd(scope[66560u + bin.y * 128u + bin.x], 1u);\n"
+			"		}\n"
+			"	}\n"
+			"	barrier();\n"
+			"	for (uint i = gl_LocalInvocationIndex; i < 1024u; i += groupsize) {\n"
+			"		if (ghist[i] > 0u)\n"
+			"			atomicAdd(scope[i], ghist[i]);\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Scope overlay
+		// The counts are drawn side by side with a translucent background :
+		//     0 - 255    histograms
+		//     256 - 511  waveform
+		//     512 - 767  vectorscope
+		// Each count is read by one invocation only and is cleared for the
+		// next frame. Brightness and height are the square root of the count
+		// relative to an even spread of the samples, so that the overlay does
+		// not depend on the grid size.
+		//
+		std::string m_scopedrawstr = "layout(rgba8, binding=0) uniform writeonly image2D dst;\n"
+			"layout(std430, binding=0) buffer scopebuffer { uint scope[]; };\n"
+			"layout(location = 0) uniform float samples;\n"
+		"void main() {\n"
+			"	uvec2 stride = gl_NumWorkGroups.xy * gl_WorkGroupSize.xy;\n"
+			"	vec4 background = vec4(0.0, 0.0, 0.0, 0.6);\n"
+			"	vec4 graticule = vec4(0.35, 0.35, 0.35, 0.8);\n"
+			"	for (uint j = gl_GlobalInvocationID.y; j < 256u; j += stride.y) {\n"
+			"		for (uint i = gl_GlobalInvocationID.x; i < 256u; i += stride.x) {\n"
+			// Waveform
+			"			uint count = scope[1024u + j*256u + i];\n"
+			"			scope[1024u + j*256u + i] = 0u;\n"
+			"			float v = clamp(sqrt(float(count) * 65536.0 / samples) / 8.0, 0.0, 1.0);\n"
+			"			vec4 c = ((j % 64u) == 0u) ? graticule : background;\n"
+			"			imageStore(dst, ivec2(256u + i, 255u - j), mix(c, vec4(0.3, 1.0, 0.3, 1.0), v));\n"
+			// Vectorscope, each bin 2x2 pixels
+			"			if (i < 128u && j < 128u) {\n"
+			"				count = scope[66560u + j*128u + i];\n"
+			"				scope[66560u + j*128u + i] = 0u;\n"
+			"				v = clamp(sqrt(float(count) * 16384.0 / samples) / 8.0, 0.0, 1.0);\n"
+			"				vec2 cbcr = (vec2(i, j) + 0.5) / 128.0 - 0.5;\n"
+			"				float r = 0.5 + 1.5748 * cbcr.y;\n"
+			"				float b = 0.5 + 1.8556 * cbcr.x;\n"
+			"				vec4 hue = vec4(clamp(vec3(r, (0.5 - 0.2126*r - 0.0722*b) / 0.7152, b), 0.0, 1.0), 1.0);\n"
+			"				for (uint dy = 0u; dy < 2u; dy++) {\n"
+			"					for (uint dx = 0u; dx < 2u; dx++) {\n"
+			"						vec2 d = vec2(2u*i + dx, 2u*j + dy) - 127.5;\n"
+			"						float radius = length(d);\n"
+			"						c = (abs(radius - 64.0) < 0.7 || abs(radius - 127.0) < 0.7\n"
+			"							|| abs(d.x) < 0.6 || abs(d.y) < 0.6) ? graticule : background;\n"
+			"						imageStore(dst, ivec2(512u + 2u*i + dx, 255u - (2u*j + dy)), mix(c, hue, v));\n"
+			"					}\n"
+			"				}\n"
+			"			}\n"
+			// Histograms, a column for each level
+			"			if (j == 0u) {\n"
+			"				vec4 h = vec4(scope[i], scope[256u + i], scope[512u + i], scope[768u + i]);\n"
+			"				scope[i] = 0u;\n"
+			"				scope[256u + i] = 0u;\n"
+			"				scope[512u + i] = 0u;\n"
+			"				scope[768u + i] = 0u;\n"
+			"				h = clamp(sqrt(h * 256.0 / samples) / 4.0, 0.0, 1.0) * 255.0;\n"
+			"				for (uint y = 0u; y < 256u; y++) {\n"
+			"					c = ((i % 64u) == 0u) ? graticule : background;\n"
+			"					vec3 bars = vec3(greaterThan(h.yzw, vec3(y)));\n"
+			"					if (any(greaterThan(bars, vec3(0.0))))\n"
+			"						c = vec4(max(c.rgb, bars * 0.8), 0.9);\n"
+			"					if (h.x > float(y))\n"
+			"						c = vec4(mix(c.rgb, vec3(1.0), 0.5), 0.9);\n"
+			"					imageStore(dst, ivec2(i, 255u - y), c);\n"
+			"				}\n"
+			"			}\n"
+			"		}\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Blend
+		// Linear mix from the first image to the second
+		//
+		std::string m_blendstr = "layout(rgba8, binding=0) uniform readonly image2D src;\n"
+			"layout(rgba8, binding=1) uniform writeonly image2D dst;\n"
+			"layout(rgba8, binding=2) uniform readonly image2D src2;\n"
+			"layout(location = 0) uniform float amount;\n"
+		"void main() {\n"
+			"	ivec2 size = imageSize(dst);\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	for (int y = int(gl_GlobalInvocationID.y); y < size.y; y += stride.y) {\n"
+			"		for (int x = int(gl_GlobalInvocationID.x); x < size.x; x += stride.x) {\n"
+			"			ivec2 pos = ivec2(x, y);\n"
+			"			imageStore(dst, pos, mix(imageLoad(src, pos), imageLoad(src2, pos), amount));\n"
+			"		}\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Block motion search
+		// One invocation for each 16x16 block of the second image finds
+		// the offset to the best match in the first image within 15 pixels.
+		// Three step search on luminance, every second pixel.
+		// The offset is stored as (v+128)/255 with the mean difference.
+		//
+		std::string m_searchstr = "layout(rgba8, binding=0) uniform readonly image2D src;\n"
+			"layout(rgba8, binding=1) uniform writeonly image2D dst;\n"
+			"layout(rgba8, binding=2) uniform readonly image2D src2;\n"
+			"float luma(vec4 c) {\n"
+			"	return dot(c.rgb, vec3(0.299, 0.587, 0.114));\n"
+			"}\n"
+			"float sad(ivec2 block, ivec2 offset, ivec2 size) {\n"
+			"	float s = 0.0;\n"
+			"	for (int j = 0; j < 16; j += 2) {\n"
+			"		for (int i = 0; i < 16; i += 2) {\n"
+			"			ivec2 p = min(block + ivec2(i, j), size - 1);\n"
+			"			ivec2 q = clamp(p + offset, ivec2(0), size - 1);\n"
+			"			s += abs(luma(imageLoad(src2, p)) - luma(imageLoad(src, q)));\n"
+			"		}\n"
+			"	}\n"
+			"	return s / 64.0;\n"
+			"}\n"
+		"void main() {\n"
+			"	ivec2 size = imageSize(src);\n"
+			"	ivec2 blocks = imageSize(dst);\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	for (int by = int(gl_GlobalInvocationID.y); by < blocks.y; by += stride.y) {\n"
+			"		for (int bx = int(gl_GlobalInvocationID.x); bx < blocks.x; bx += stride.x) {\n"
+			"			ivec2 block = ivec2(bx, by) * 16;\n"
+			"			ivec2 best = ivec2(0);\n"
+			"			float bestsad = sad(block, best, size);\n"
+			"			for (int step = 8; step >= 1; step /= 2) {\n"
+			"				ivec2 centre = best;\n"
+			"				for (int j = -1; j <= 1; j++) {\n"
+			"					for (int i = -1; i <= 1; i++) {\n"
+			"						if (i == 0 && j == 0) continue;\n"
+			"						ivec2 v = centre + ivec2(i, j) * step;\n"
+			"						float s = sad(block, v, size);\n"
+			"						if (s < bestsad) {\n"
+			"							bestsad = s;\n"
+			"							best = v;\n"
+			"						}\n"
+			"					}\n"
+			"				}\n"
+			"			}\n"
+			"			imageStore(dst, ivec2(bx, by), vec4((vec2(best) + 128.0) / 255.0, bestsad, 1.0));\n"
+			"		}\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Motion interpolation
+		// Each pixel is taken along the vector of its block from both
+		// images and mixed. Blocks without a good match are blended.
+		//
+		std::string m_interpstr = "layout(rgba8, binding=0) uniform readonly image2D src;\n"
+			"layout(rgba8, binding=1) uniform writeonly image2D dst;\n"
+			"layout(rgba8, binding=2) uniform readonly image2D src2;\n"
+			"layout(rgba8, binding=3) uniform readonly image2D vectors;\n"
+			"layout(location = 0) uniform float amount;\n"
+			"layout(location = 1) uniform float threshold;\n"
+		"void main() {\n"
+			"	ivec2 size = imageSize(dst);\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	for (int y = int(gl_GlobalInvocationID.y); y < size.y; y += stride.y) {\n"
+			"		for (int x = int(gl_GlobalInvocationID.x); x < size.x; x += stride.x) {\n"
+			"			ivec2 pos = ivec2(x, y);\n"
+			"			vec4 mv = imageLoad(vectors, pos / 16);\n"
+			"			vec2 v = (mv.z > threshold) ? vec2(0.0) : round(mv.xy * 255.0 - 128.0);\n"
+			"			ivec2 p0 = clamp(pos + ivec2(round(v * amount)), ivec2(0), size - 1);\n"
+			"			ivec2 p1 = clamp(pos - ivec2(round(v * (1.0 - amount))), ivec2(0), size - 1);\n"
+			"			imageStore(dst, pos, mix(imageLoad(src, p0), imageLoad(src2, p1), amount));\n"
+			"		}\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Deinterlace (yadif)
+		// Lines of the field are kept. The others are interpolated from
+		// the lines above and below along the best edge direction, and
+		// limited by the difference from the same field of the frames
+		// either side in time. See deinterlaceCpu for the reference.
+		//
+		std::string m_deintstr = "layout(rgba8, binding=0) uniform readonly image2D cur;\n"
+			"layout(rgba8, binding=1) uniform writeonly image2D dst;\n"
+			"layout(rgba8, binding=2) uniform readonly image2D prev;\n"
+			"layout(rgba8, binding=3) uniform readonly image2D next;\n"
+			"layout(location = 0) uniform float parity;\n"
+			"layout(location = 1) uniform float second;\n"
+			"ivec2 size;\n"
+			"bool bSecond;\n"
+			"ivec2 at(int x, int y) {\n"
+			"	if (y < 0) y = -y;\n"
+			"	if (y >= size.y) y = 2*(size.y - 1) - y;\n"
+			"	return clamp(ivec2(x, y), ivec2(0), size - 1);\n"
+			"}\n"
+			"ivec4 C(int x, int y) { return ivec4(imageLoad(cur, at(x, y)) * 255.0 + 0.5); }\n"
+			"ivec4 P(int x, int y) { return ivec4(imageLoad(prev, at(x, y)) * 255.0 + 0.5); }\n"
+			"ivec4 N(int x, int y) { return ivec4(imageLoad(next, at(x, y)) * 255.0 + 0.5); }\n"
+			"ivec4 P2(int x, int y) { return bSecond ? C(x, y) : P(x, y); }\n"
+			"ivec4 N2(int x, int y) { return bSecond ? N(x, y) : C(x, y); }\n"
+			"ivec4 score(int x, int y, int j) {\n"
+			"	return abs(C(x-1+j, y-1) - C(x-1-j, y+1))\n"
+			"		+ abs(C(x+j, y-1) - C(x-j, y+1))\n"
+			"		+ abs(C(x+1+j, y-1) - C(x+1-j, y+1));\n"
+			"}\n"
+		"void main() {\n"
+			"	size = imageSize(dst);\n"
+			"	bSecond = (second > 0.5);\n"
+			"	int field = int(parity);\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	for (int y = int(gl_GlobalInvocationID.y); y < size.y; y += stride.y) {\n"
+			"		for (int x = int(gl_GlobalInvocationID.x); x < size.x; x += stride.x) {\n"
+			"			ivec2 pos = ivec2(x, y);\n"
+			"			if (((y ^ field) & 1) == 0) {\n"
+			"				imageStore(dst, pos, imageLoad(cur, pos));\n"
+			"				continue;\n"
+			"			}\n"
+			"			ivec4 c = C(x, y-1);\n"
+			"			ivec4 e = C(x, y+1);\n"
+			"			ivec4 p2 = P2(x, y);\n"
+			"			ivec4 n2 = N2(x, y);\n"
+			"			ivec4 d = (p2 + n2) >> 1;\n"
+			"			ivec4 diff = max(max(abs(p2 - n2) >> 1,\n"
+			"				(abs(P(x, y-1) - c) + abs(P(x, y+1) - e)) >> 1),\n"
+			"				(abs(N(x, y-1) - c) + abs(N(x, y+1) - e)) >> 1);\n"
+			"			ivec4 pred = (c + e) >> 1;\n"
+			"			ivec4 best = abs(C(x-1, y-1) - C(x-1, y+1)) + abs(c - e)\n"
+			"				+ abs(C(x+1, y-1) - C(x+1, y+1)) - 1;\n"
+			"			for (int dir = -1; dir <= 1; dir += 2) {\n"
+			"				ivec4 m = ivec4(1);\n"
+			"				for (int j = dir; abs(j) <= 2; j += dir) {\n"
+			"					ivec4 s = score(x, y, j);\n"
+			"					m *= ivec4(lessThan(s, best));\n"
+			"					best += m * (s - best);\n"
+			"					pred += m * (((C(x+j, y-1) + C(x-j, y+1)) >> 1) - pred);\n"
+			"				}\n"
+			"			}\n"
+			"			ivec4 b = (P2(x, y-2) + N2(x, y-2)) >> 1;\n"
+			"			ivec4 f = (P2(x, y+2) + N2(x, y+2)) >> 1;\n"
+			"			ivec4 hi = max(max(d - e, d - c), min(b - c, f - e));\n"
+			"			ivec4 lo = min(min(d - e, d - c), max(b - c, f - e));\n"
+			"			diff = max(max(diff, lo), -hi);\n"
+			"			imageStore(dst, pos, vec4(clamp(pred, d - diff, d + diff)) / 255.0);\n"
+			"		}\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Nv12 to rgba
+		// The source is the nv12 frame uploaded as rgba texels
+		// of 4 bytes, width/4 by height*3/2. The Y plane is followed by
+		// the UV plane, so one texel has 4 luma samples of a line or
+		// the U and V samples for 4 pixels of two lines. Each invocation
+		// converts a block of 4x2 pixels with one chroma texel.
+		// Matrix 0 BT.601, 1 BT.709, 2 BT.2020
+		// Range 0 limited (16-235, 16-240), 1 full
+		//
+		std::string m_yuvstr = "layout(rgba8, binding=0) uniform readonly image2D src;\n"
+			"layout(rgba8, binding=1) uniform writeonly image2D dst;\n"
+			"layout(location = 0) uniform float matrix;\n"
+			"layout(location = 1) uniform float fullrange;\n"
+		"void main() {\n"
+			"	ivec2 size = imageSize(dst);\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	vec2 k = (matrix < 0.5) ? vec2(0.299, 0.114) : ((matrix < 1.5) ? vec2(0.2126, 0.0722) : vec2(0.2627, 0.0593));\n"
+			"	float kg = 1.0 - k.x - k.y;\n"
+			"	float yoffset = (fullrange > 0.5) ? 0.0 : 16.0/255.0;\n"
+			"	float yscale  = (fullrange > 0.5) ? 1.0 : 255.0/219.0;\n"
+			"	float cscale  = (fullrange > 0.5) ? 1.0 : 255.0/224.0;\n"
+			"	for (int by = int(gl_GlobalInvocationID.y); by < size.y/2; by += stride.y) {\n"
+			"		for (int bx = int(gl_GlobalInvocationID.x); bx < size.x/4; bx += stride.x) {\n"
+			"			vec4 uv = (imageLoad(src, ivec2(bx, size.y + by)) - 128.0/255.0) * cscale;\n"
+			"			for (int row = 0; row < 2; row++) {\n"
+			"				vec4 luma = (imageLoad(src, ivec2(bx, by*2 + row)) - yoffset) * yscale;\n"
+			"				for (int i = 0; i < 4; i++) {\n"
+			"					vec2 c = (i < 2) ? uv.xy : uv.zw;\n"
+			"					float r = luma[i] + 2.0*(1.0 - k.x)*c.y;\n"
+			"					float b = luma[i] + 2.0*(1.0 - k.y)*c.x;\n"
+			"					float g = (luma[i] - k.x*r - k.y*b) / kg;\n"
+			"					imageStore(dst, ivec2(bx*4 + i, by*2 + row), vec4(r, g, b, 1.0));\n"
+			"				}\n"
+			"			}\n"
+			"		}\n"
+			"	}\n"
+		"}\n";
+
+		//
+		// Temporal denoise and adjust
+		// Recursive filter of each pixel with the history where the
+		// difference is within the noise, so that moving areas are not
+		// blurred. The result is kept in the history and adjusted as
+		// for brightness, contrast, saturation and gamma, so the
+		// denoise adds only the history read to the adjust pass.
+		//
+		std::string m_denoisestr = "layout(rgba8, binding=0) uniform image2D history;\n" // Read/Write
+			"layout(rgba8, binding=1) uniform writeonly image2D dst;\n"
+			"layout(rgba8, binding=2) uniform readonly image2D src;\n"
+			"layout(location = 0) uniform float brightness;\n"
+			"layout(location = 1) uniform float contrast;\n"
+			"layout(location = 2) uniform float saturation;\n"
+			"layout(location = 3) uniform float gamma;\n"
+			"layout(location = 4) uniform float strength;\n"
+			"layout(location = 5) uniform float update;\n"
+		"void main() {\n"
+			"	ivec2 size = imageSize(dst);\n"
+			"	ivec2 stride = ivec2(gl_NumWorkGroups.xy * gl_WorkGroupSize.xy);\n"
+			"	float threshold = 0.04 + 0.16 * strength;\n"
+			"	for (int y = int(gl_GlobalInvocationID.y); y < size.y; y += stride.y) {\n"
+			"		for (int x = int(gl_GlobalInvocationID.x); x < size.x; x += stride.x) {\n"
+			"			ivec2 pos = ivec2(x, y);\n"
+			"			vec4 c1 = imageLoad(src, pos);\n"
+			"			vec4 h = imageLoad(history, pos);\n"
+			"			float k = 0.9 * strength * (1.0 - smoothstep(0.5 * threshold, threshold, distance(c1.rgb, h.rgb)));\n"
+			"			vec3 c2 = mix(c1.rgb, h.rgb, k);\n"
+			"			if (update > 0.5)\n"
+			"				imageStore(history, pos, vec4(c2, c1.a));\n"
+			"			c2 = pow(c2, vec3(1.0 / gamma));\n"
+			"			float luminance = dot(c2, vec3(0.2125, 0.7154, 0.0721));\n"
+			"			c2 = mix(vec3(luminance), c2, vec3(saturation));\n"
+			"			c2 = (c2 - 0.5) * contrast + 0.5;\n"
+			"			c2 += brightness;\n"
+			"			imageStore(dst, pos, vec4(c2, c1.a));\n"
+			"		}\n"
+			"	}\n"
+		"}\n";
+
 };
 
 #endif
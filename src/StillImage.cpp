@@ -0,0 +1,132 @@
+/*
+
+	StillImage.cpp
+
+	Spout Video Player
+
+	A single image played as a movie.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "StillImage.h"
+#include "ImageSequence.h" // For image load
+
+//---------------------------------------------------------
+// Function: Open
+bool stillImage::Open(std::string path)
+{
+	Close();
+
+	if (!imageSequence::IsImageFile(path))
+		return false;
+
+	if (!imageSequence::LoadPixels(path, m_pixels))
+		return false;
+
+	std::error_code ec;
+	m_modified = std::filesystem::last_write_time(path, ec);
+	m_checked = ofGetElapsedTimeMillis();
+	m_path = path;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Close
+void stillImage::Close()
+{
+	m_path.clear();
+	m_pixels.clear();
+}
+
+//---------------------------------------------------------
+// Function: IsOpen
+bool stillImage::IsOpen()
+{
+	return m_pixels.isAllocated();
+}
+
+//---------------------------------------------------------
+// Function: GetFrames
+int stillImage::GetFrames()
+{
+	return IsOpen() ? 1 : 0;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameWidth
+int stillImage::GetFrameWidth()
+{
+	return (int)m_pixels.getWidth();
+}
+
+//---------------------------------------------------------
+// Function: GetFrameHeight
+int stillImage::GetFrameHeight()
+{
+	return (int)m_pixels.getHeight();
+}
+
+//---------------------------------------------------------
+// Function: GetFrameRate
+// There is no frame rate
+double stillImage::GetFrameRate()
+{
+	return 0.0;
+}
+
+//---------------------------------------------------------
+// Function: GetFrameData
+const unsigned char* stillImage::GetFrameData(int frame)
+{
+	if (frame != 0 || !m_pixels.isAllocated())
+		return nullptr;
+	return m_pixels.getData();
+}
+
+//---------------------------------------------------------
+// Function: CheckFile
+// The file is checked once a second. An image that cannot be
+// loaded, for example while it is being written, is tried again
+// at the next check.
+bool stillImage::CheckFile()
+{
+	if (m_path.empty())
+		return false;
+
+	uint64_t now = ofGetElapsedTimeMillis();
+	if (now - m_checked < 1000)
+		return false;
+	m_checked = now;
+
+	std::error_code ec;
+	std::filesystem::file_time_type modified = std::filesystem::last_write_time(m_path, ec);
+	if (ec || modified == m_modified)
+		return false;
+
+	ofPixels pixels;
+	if (!imageSequence::LoadPixels(m_path, pixels))
+		return false;
+
+	m_pixels.swap(pixels);
+	m_modified = modified;
+	SpoutLogNotice("stillImage::CheckFile - reloaded %s", m_path.c_str());
+
+	return true;
+}
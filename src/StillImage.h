@@ -0,0 +1,63 @@
+/*
+
+	StillImage.h
+
+	Spout Video Player
+
+	A single image played as a movie.
+
+	The image is processed and sent once and again only if the
+	file or the adjustments change. The file is checked for
+	changes once a second so that it can be replaced while shown.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutUtils.h" // For logging
+#include "FrameSource.h"
+
+using namespace spoututils;
+
+class stillImage : public frameSource {
+
+	public:
+
+		bool Open(std::string path);
+		void Close();
+		bool IsOpen();
+
+		// frameSource
+		int GetFrames();
+		int GetFrameWidth();
+		int GetFrameHeight();
+		double GetFrameRate();
+		const unsigned char* GetFrameData(int frame);
+
+		// Load the image again if the file has been modified.
+		// Returns true if a new image was loaded.
+		bool CheckFile();
+
+	protected :
+
+		std::string m_path;
+		ofPixels m_pixels;
+		std::filesystem::file_time_type m_modified{};
+		uint64_t m_checked = 0; // time of the last check (msec)
+
+};
@@ -0,0 +1,307 @@
+/*
+
+	SyncClock.cpp
+
+	Spout Video Player
+
+	Media time shared between player instances on one machine.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "SyncClock.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+static const uint32_t syncMagic = 0x31535653; // "SVS1"
+
+// Spin wait hint for a read retry
+static inline void SpinPause()
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	_mm_pause();
+#else
+	std::this_thread::yield();
+#endif
+}
+
+// Thresholds in frames and the slew limits
+static const double holdFrames = 0.25; // start to slew
+static const double doneFrames = 0.0625; // stop
+static const double skipFrames = 3.0;
+static const double slewTime = 1.0;   // seconds to remove an offset
+static const double slewMax = 0.05;   // speed change
+static const double skipWait = 1.0;   // seconds between skips
+static const double staleTime = 1.0;  // master not publishing
+
+syncClock::syncClock() {
+}
+
+syncClock::~syncClock() {
+	Close();
+}
+
+//---------------------------------------------------------
+// Function: Open
+bool syncClock::Open(bool bMaster, const std::string &name)
+{
+	Close();
+
+#ifdef _WIN32
+	m_hMap = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+		0, (DWORD)sizeof(shared), name.c_str());
+	if (!m_hMap)
+		return false;
+	m_shared = (shared*)MapViewOfFile(m_hMap, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(shared));
+#else
+	std::string shmname = "/" + name;
+	m_fd = shm_open(shmname.c_str(), O_CREAT | O_RDWR, 0666);
+	if (m_fd < 0)
+		return false;
+	if (ftruncate(m_fd, sizeof(shared)) != 0) {
+		Close();
+		return false;
+	}
+	void* map = mmap(nullptr, sizeof(shared), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	m_shared = (map == MAP_FAILED) ? nullptr : (shared*)map;
+#endif
+
+	if (!m_shared) {
+		Close();
+		return false;
+	}
+
+	m_bMaster = bMaster;
+	if (m_bMaster)
+		m_shared->magic = syncMagic;
+	m_lastSkip = -1.0e9;
+	m_bSlewing = false;
+	ResetStats();
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Close
+void syncClock::Close()
+{
+#ifdef _WIN32
+	if (m_shared)
+		UnmapViewOfFile(m_shared);
+	if (m_hMap)
+		CloseHandle(m_hMap);
+	m_hMap = NULL;
+#else
+	if (m_shared)
+		munmap(m_shared, sizeof(shared));
+	if (m_fd >= 0)
+		close(m_fd);
+	m_fd = -1;
+#endif
+	m_shared = nullptr;
+	m_bMaster = false;
+}
+
+//---------------------------------------------------------
+// Function: IsOpen
+bool syncClock::IsOpen()
+{
+	return (m_shared != nullptr);
+}
+
+//---------------------------------------------------------
+// Function: IsMaster
+bool syncClock::IsMaster()
+{
+	return (m_shared && m_bMaster);
+}
+
+//---------------------------------------------------------
+// Function: Clock
+double syncClock::Clock()
+{
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//---------------------------------------------------------
+// Function: Publish
+void syncClock::Publish(double mediaTime, double duration, double fps, double speed, bool bPaused)
+{
+	if (!IsMaster())
+		return;
+
+	state data{};
+	data.clock = Clock();
+	data.mediaTime = mediaTime;
+	data.duration = duration;
+	data.fps = fps;
+	data.speed = speed;
+	data.bPaused = bPaused ? 1 : 0;
+
+	uint32_t sequence = m_shared->sequence.load(std::memory_order_relaxed);
+	m_shared->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(&m_shared->data, &data, sizeof(state));
+	m_shared->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+//---------------------------------------------------------
+// Function: Read
+// Retried if the master was writing
+int syncClock::Read(state &master)
+{
+	if (!m_shared || m_shared->magic != syncMagic)
+		return READ_NONE;
+
+	for (int i = 0; i < 100; i++) {
+		// The master is writing. Pause briefly, then give
+		// up the time slice in case it has been preempted.
+		if (i > 0) {
+			if (i < 16)
+				SpinPause();
+			else
+				std::this_thread::yield();
+		}
+		uint32_t before = m_shared->sequence.load(std::memory_order_acquire);
+		if (before & 1)
+			continue;
+		memcpy(&master, &m_shared->data, sizeof(state));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_shared->sequence.load(std::memory_order_relaxed) == before)
+			return (Clock() - master.clock < staleTime) ? READ_OK : READ_STALE;
+	}
+	return READ_BUSY;
+}
+
+//---------------------------------------------------------
+// Function: Predict
+double syncClock::Predict(const state &master)
+{
+	double time = master.mediaTime;
+	if (!master.bPaused)
+		time += (Clock() - master.clock)*master.speed;
+	if (master.duration > 0.0)
+		time = fmod(time, master.duration);
+	return time;
+}
+
+//---------------------------------------------------------
+// Function: Offset
+double syncClock::Offset(const state &master, double mediaTime)
+{
+	double offset = mediaTime - Predict(master);
+	if (master.duration > 0.0) {
+		if (offset > master.duration/2.0)
+			offset -= master.duration;
+		else if (offset < -master.duration/2.0)
+			offset += master.duration;
+	}
+	return offset;
+}
+
+//---------------------------------------------------------
+// Function: Correct
+// Proportional to the offset so that the speed returns
+// to normal as the offset is removed. An offset that remains
+// while slewing is the clock drift times the slew time.
+int syncClock::Correct(double offset, double fps, double &rate)
+{
+	rate = 1.0;
+	if (fps <= 0.0)
+		return SYNC_HOLD;
+
+	double frames = fabs(offset)*fps;
+	if (frames > skipFrames) {
+		double now = Clock();
+		if (now - m_lastSkip >= skipWait) {
+			m_lastSkip = now;
+			m_skips++;
+			return SYNC_SKIP;
+		}
+	}
+	// Slew from a quarter frame until within a sixteenth
+	if (frames <= (m_bSlewing ? doneFrames : holdFrames)) {
+		m_bSlewing = false;
+		return SYNC_HOLD;
+	}
+	m_bSlewing = true;
+
+	double change = -offset/slewTime;
+	if (change > slewMax) change = slewMax;
+	if (change < -slewMax) change = -slewMax;
+	rate = 1.0 + change;
+	m_slews++;
+	return SYNC_SLEW;
+}
+
+//---------------------------------------------------------
+// Function: Record
+void syncClock::Record(double offset, double fps)
+{
+	if (m_count == 0 || offset < m_min) m_min = offset;
+	if (m_count == 0 || offset > m_max) m_max = offset;
+	m_count++;
+	m_sum += offset;
+	m_sumSq += offset*offset;
+	if (fps > 0.0 && fabs(offset)*fps <= 1.0)
+		m_within++;
+}
+
+//---------------------------------------------------------
+// Function: Report
+// Offsets in msec
+std::string syncClock::Report()
+{
+	if (m_count == 0)
+		return "no offsets";
+
+	double mean = m_sum/(double)m_count;
+	double rms = sqrt(m_sumSq/(double)m_count);
+	char text[256]{};
+	snprintf(text, 256, "offset mean %+.2f rms %.2f min %+.2f max %+.2f msec, %.1f%% within a frame, %d cycles slewing, %d skips (%lld frames)",
+		mean*1000.0, rms*1000.0, m_min*1000.0, m_max*1000.0,
+		100.0*(double)m_within/(double)m_count, m_slews, m_skips, (long long)m_count);
+	return text;
+}
+
+//---------------------------------------------------------
+// Function: ResetStats
+void syncClock::ResetStats()
+{
+	m_count = 0;
+	m_sum = 0.0;
+	m_sumSq = 0.0;
+	m_min = 0.0;
+	m_max = 0.0;
+	m_within = 0;
+	m_skips = 0;
+	m_slews = 0;
+}
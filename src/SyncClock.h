@@ -0,0 +1,143 @@
+/*
+
+	SyncClock.h
+
+	Spout Video Player
+
+	Media time shared between player instances on one machine.
+
+	One instance is the master and publishes its media time with the
+	time it was taken on the monotonic clock, which is the same for
+	all processes. Other instances read it, predict the master media
+	time now and correct their own playback :
+
+	  within a quarter frame  - no change
+	  up to three frames      - slew, play up to 5% faster or slower
+	                            in proportion to the offset until it
+	                            is within a sixteenth of a frame
+	  more than three frames  - skip, seek to the master time
+	                            (at most once a second)
+
+	The clock is a small block of named shared memory written with a
+	sequence count, odd while it is written, so that a reader never
+	sees part of an update and the master never waits. The block is
+	not removed when the master closes so that a master started again
+	is found by the other instances.
+
+	Offsets are collected for statistics of each instance. There are
+	no dependencies so that the clock can be tested with several
+	processes without the player (see tools/rawtool "sync").
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+class syncClock {
+
+	public:
+
+		enum { SYNC_HOLD, SYNC_SLEW, SYNC_SKIP };
+		enum { READ_OK, READ_NONE, READ_STALE, READ_BUSY };
+
+		// Media time published by the master
+		struct state {
+			double clock = 0.0;     // time published (monotonic seconds)
+			double mediaTime = 0.0; // seconds from the start of the media
+			double duration = 0.0;  // media length (seconds)
+			double fps = 30.0;      // media frame rate
+			double speed = 1.0;     // playback speed
+			int32_t bPaused = 0;
+			int32_t reserved = 0;
+		};
+
+		syncClock();
+		~syncClock();
+
+		// Open the shared clock as the master or to follow it
+		bool Open(bool bMaster, const std::string &name = "SpoutVideoPlayerSync");
+		void Close();
+		bool IsOpen();
+		bool IsMaster();
+
+		// Monotonic clock for all processes (seconds)
+		static double Clock();
+
+		// Master
+		void Publish(double mediaTime, double duration, double fps, double speed, bool bPaused);
+
+		// Follower. Returns READ_OK, READ_NONE if there is no master,
+		// READ_STALE if it has not published for a second, or READ_BUSY
+		// if it was writing for all the retries. A busy master is still
+		// there and the last correction can be kept.
+		int Read(state &master);
+
+		// Master media time now
+		static double Predict(const state &master);
+
+		// Local minus master media time (seconds). Offsets
+		// across the end of a loop are the shorter way round.
+		static double Offset(const state &master, double mediaTime);
+
+		// Correction for an offset. rate is the speed
+		// multiplier for the next cycle (1 to hold).
+		int Correct(double offset, double fps, double &rate);
+
+		// Offset statistics since the last report
+		void Record(double offset, double fps);
+		std::string Report();
+		void ResetStats();
+
+	protected :
+
+		struct shared {
+			uint32_t magic;
+			std::atomic<uint32_t> sequence; // odd while written
+			state data;
+		};
+		static_assert(std::atomic<uint32_t>::is_always_lock_free,
+			"The sequence is shared between processes");
+
+		shared* m_shared = nullptr;
+		bool m_bMaster = false;
+		double m_lastSkip = -1.0e9;
+		bool m_bSlewing = false;
+
+#ifdef _WIN32
+		HANDLE m_hMap = NULL;
+#else
+		int m_fd = -1;
+#endif
+
+		// Statistics
+		int64_t m_count = 0;
+		double m_sum = 0.0;
+		double m_sumSq = 0.0;
+		double m_min = 0.0;
+		double m_max = 0.0;
+		int64_t m_within = 0; // within one frame
+		int m_skips = 0;
+		int m_slews = 0;
+
+};
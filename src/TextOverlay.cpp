@@ -0,0 +1,126 @@
+/*
+
+	TextOverlay.cpp
+
+	Spout Video Player
+
+	Text overlay with a mesh cache for each line.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "TextOverlay.h"
+
+//---------------------------------------------------------
+// Function: SetFont
+void textOverlay::SetFont(ofTrueTypeFont* font)
+{
+	m_font = font;
+	Clear();
+}
+
+//---------------------------------------------------------
+// Function: SetInterval
+void textOverlay::SetInterval(double msec)
+{
+	if (msec >= 0.0)
+		m_interval = msec;
+}
+
+//---------------------------------------------------------
+// Function: Begin
+bool textOverlay::Begin()
+{
+	double now = (double)ofGetElapsedTimeMillis();
+	if (m_lastTime >= 0.0 && now - m_lastTime < m_interval)
+		return false;
+
+	m_lastTime = now;
+	m_count = 0;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: Add
+void textOverlay::Add(const char* str, float x, float y)
+{
+	if (!m_font || !str)
+		return;
+
+	if (m_count == m_lines.size())
+		m_lines.emplace_back();
+
+	line &l = m_lines[m_count++];
+	if (l.mesh.getNumVertices() > 0 && l.text == str && l.x == x && l.y == y)
+		return;
+
+	l.text = str;
+	l.x = x;
+	l.y = y;
+	l.mesh = m_font->getStringMesh(l.text, x, y);
+	m_bChanged = true;
+}
+
+//---------------------------------------------------------
+// Function: End
+void textOverlay::End()
+{
+	if (m_count < m_lines.size()) {
+		m_lines.resize(m_count);
+		m_bChanged = true;
+	}
+
+	if (!m_bChanged)
+		return;
+
+	// Indices of each line are offset by the vertices before it
+	m_mesh.clear();
+	m_mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+	for (auto &l : m_lines)
+		m_mesh.append(l.mesh);
+	m_bChanged = false;
+}
+
+//---------------------------------------------------------
+// Function: Draw
+// The current colour is used with alpha blending
+// for the glyph edges as for ofTrueTypeFont.
+void textOverlay::Draw()
+{
+	if (!m_font || m_mesh.getNumVertices() == 0)
+		return;
+
+	ofBlendMode mode = ofGetStyle().blendingMode;
+	ofEnableAlphaBlending();
+	m_font->getFontTexture().bind();
+	m_mesh.draw();
+	m_font->getFontTexture().unbind();
+	ofEnableBlendMode(mode);
+}
+
+//---------------------------------------------------------
+// Function: Clear
+void textOverlay::Clear()
+{
+	m_lines.clear();
+	m_mesh.clear();
+	m_count = 0;
+	m_bChanged = false;
+	m_lastTime = -1.0;
+}
@@ -0,0 +1,78 @@
+/*
+
+	TextOverlay.h
+
+	Spout Video Player
+
+	Text overlay with a mesh cache for each line.
+
+	The information lines are formatted at a fixed rate, by default
+	4 times a second, and drawn from the cache in between. The glyph
+	quads of a line are made from the font atlas only when its text
+	or position changes. All lines are joined in one mesh and drawn
+	with the font texture in a single draw call.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+
+class textOverlay {
+
+	public:
+
+		// Font for the glyph meshes and atlas texture
+		void SetFont(ofTrueTypeFont* font);
+
+		// Time between refreshes (msec)
+		void SetInterval(double msec);
+
+		// Start a refresh if one is due.
+		// Returns false if the cached lines are to be drawn.
+		bool Begin();
+
+		// Add a line of a refresh
+		void Add(const char* str, float x, float y);
+
+		// End a refresh. Lines not added are removed.
+		void End();
+
+		// Draw all lines
+		void Draw();
+
+		// Remove all lines and refresh on the next Begin
+		void Clear();
+
+	protected :
+
+		struct line {
+			std::string text;
+			float x = 0.0f;
+			float y = 0.0f;
+			ofMesh mesh;
+		};
+		std::vector<line> m_lines;
+		size_t m_count = 0;       // lines added in this refresh
+		bool m_bChanged = false;  // m_mesh to be joined again
+		ofMesh m_mesh;            // all lines
+
+		ofTrueTypeFont* m_font = nullptr;
+		double m_interval = 250.0;
+		double m_lastTime = -1.0; // last refresh (msec)
+
+};
@@ -0,0 +1,142 @@
+/*
+
+	UiAssets.cpp
+
+	Spout Video Player
+
+	Splash image and play bar icons loaded in the background.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "UiAssets.h"
+
+uiAssets::~uiAssets()
+{
+	m_pool.Stop();
+}
+
+//---------------------------------------------------------
+// Function: Start
+void uiAssets::Start(int iconSize)
+{
+	Release();
+
+	// In the order of the icon enum
+	const char* icons[ICONS] = { "reverse", "back", "play", "pause", "forward",
+		"fastforward", "stop", "full_screen", "speaker", "speaker_mute" };
+
+	m_iconSize = iconSize;
+	m_bStarted = true;
+	m_pending = ICONS + 1;
+	m_pool.Start(4);
+
+	std::string path = ofToDataPath("images/SpoutVideoPlayer.png", true);
+	m_pool.Submit([this, path]() { Decode(path, m_splashPixels, 0); });
+	for (int i = 0; i < ICONS; i++) {
+		path = ofToDataPath(std::string("icons/") + icons[i] + ".png", true);
+		m_pool.Submit([this, path, i]() { Decode(path, m_iconPixels[i], m_iconSize); });
+	}
+}
+
+//---------------------------------------------------------
+// Function: Decode
+// Runs on the pool threads. An image without a texture
+// can be loaded and resized on any thread.
+void uiAssets::Decode(std::string path, ofPixels &pixels, int size)
+{
+	ofImage image;
+	image.setUseTexture(false);
+	if (image.load(path)) {
+		image.setImageType(OF_IMAGE_COLOR_ALPHA);
+		if (size > 0)
+			image.resize(size, size);
+		pixels = image.getPixels();
+	}
+	else {
+		SpoutLogWarning("uiAssets::Decode - could not load %s", path.c_str());
+	}
+	m_pending--;
+}
+
+//---------------------------------------------------------
+// Function: Upload
+bool uiAssets::Upload()
+{
+	if (m_bUploaded)
+		return true;
+	if (!m_bStarted || m_pending > 0)
+		return false;
+
+	m_pool.Stop();
+
+	if (m_splashPixels.isAllocated())
+		m_splash.loadData(m_splashPixels);
+
+	// Icons that could not be loaded are left clear
+	ofPixels atlas;
+	atlas.allocate(m_iconSize*ICONS, m_iconSize, OF_PIXELS_RGBA);
+	atlas.set(0);
+	for (int i = 0; i < ICONS; i++) {
+		if (m_iconPixels[i].isAllocated())
+			m_iconPixels[i].pasteInto(atlas, i*m_iconSize, 0);
+	}
+	m_atlas.loadData(atlas);
+
+	m_splashPixels.clear();
+	for (auto &pixels : m_iconPixels)
+		pixels.clear();
+
+	m_bUploaded = true;
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: DrawSplash
+void uiAssets::DrawSplash(float x, float y, float width, float height)
+{
+	if (Upload() && m_splash.isAllocated())
+		m_splash.draw(x, y, width, height);
+}
+
+//---------------------------------------------------------
+// Function: DrawIcon
+void uiAssets::DrawIcon(int icon, float x, float y)
+{
+	if (icon < 0 || icon >= ICONS || !Upload())
+		return;
+
+	float size = (float)m_iconSize;
+	m_atlas.drawSubsection(x, y, size, size, (float)icon*size, 0.0f, size, size);
+}
+
+//---------------------------------------------------------
+// Function: Release
+void uiAssets::Release()
+{
+	m_pool.Stop();
+	m_pending = 0;
+	m_bStarted = false;
+	m_bUploaded = false;
+	m_splashPixels.clear();
+	for (auto &pixels : m_iconPixels)
+		pixels.clear();
+	m_splash.clear();
+	m_atlas.clear();
+}
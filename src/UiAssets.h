@@ -0,0 +1,77 @@
+/*
+
+	UiAssets.h
+
+	Spout Video Player
+
+	Splash image and play bar icons loaded in the background.
+
+	The images are decoded on worker threads while the application
+	starts, and the icons are resized to the play bar size there.
+	Nothing is uploaded until the window first needs it, and then
+	the splash image and one atlas of all the icons are uploaded
+	together. Icons are drawn from the atlas.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutUtils.h" // For logging
+#include "WorkPool.h"
+
+using namespace spoututils;
+
+class uiAssets {
+
+	public:
+
+		enum { ICON_REVERSE, ICON_BACK, ICON_PLAY, ICON_PAUSE, ICON_FORWARD,
+			ICON_FASTFORWARD, ICON_STOP, ICON_FULLSCREEN, ICON_SOUND, ICON_MUTE, ICONS };
+
+		~uiAssets();
+
+		// Start decoding the images.
+		// Icons are resized to iconSize x iconSize.
+		void Start(int iconSize);
+
+		// Upload the textures if the images have been decoded.
+		// Returns false while they are not available.
+		bool Upload();
+
+		// Draw if uploaded
+		void DrawSplash(float x, float y, float width, float height);
+		void DrawIcon(int icon, float x, float y);
+
+		void Release();
+
+	protected :
+
+		workPool m_pool;
+		std::atomic<int> m_pending{0}; // images not decoded
+		bool m_bStarted = false;
+		bool m_bUploaded = false;
+		int m_iconSize = 0;
+
+		ofPixels m_splashPixels;
+		ofPixels m_iconPixels[ICONS];
+		ofTexture m_splash;
+		ofTexture m_atlas; // icons side by side
+
+		void Decode(std::string path, ofPixels &pixels, int size);
+
+};
@@ -0,0 +1,150 @@
+/*
+
+	VideoScopes.cpp
+
+	Spout Video Player
+
+	Histogram, waveform and vectorscope of the processed frame.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "VideoScopes.h"
+
+videoScopes::~videoScopes() {
+	Release();
+}
+
+//---------------------------------------------------------
+// Function: SetInterval
+void videoScopes::SetInterval(double msec)
+{
+	m_interval = msec;
+	if (m_interval < 0.0)
+		m_interval = 0.0;
+}
+
+//---------------------------------------------------------
+// Function: Update
+// The grid has about 480 columns for any frame size.
+bool videoScopes::Update(spoutShaders &shaders, GLuint TextureID,
+	unsigned int width, unsigned int height)
+{
+	ReadQuery();
+
+	if (TextureID == 0 || width == 0 || height == 0)
+		return false;
+
+	double now = ofGetElapsedTimeMillis();
+	if (m_bReady && now - m_lastTime < m_interval)
+		return false;
+	m_lastTime = now;
+
+	if (!m_overlay.isAllocated())
+		m_overlay.allocate(768, 256, GL_RGBA8);
+
+	m_step = width / 480;
+	if (m_step < 1)
+		m_step = 1;
+
+	// Time the update if the last result has been read
+	bool bTimed = false;
+	if (!m_bPending) {
+		if (m_query == 0)
+			glGenQueries(1, &m_query);
+		glBeginQuery(GL_TIME_ELAPSED, m_query);
+		bTimed = true;
+	}
+
+	m_bReady = shaders.Scopes(TextureID, m_overlay.getTextureData().textureID,
+		width, height, m_step);
+
+	if (bTimed) {
+		glEndQuery(GL_TIME_ELAPSED);
+		m_bPending = true;
+	}
+
+	return m_bReady;
+}
+
+//---------------------------------------------------------
+// Function: Draw
+void videoScopes::Draw(float x, float y, float width, float height)
+{
+	if (!m_bReady)
+		return;
+
+	ofEnableAlphaBlending();
+	ofSetColor(255);
+	m_overlay.draw(x, y, width, height);
+	ofDisableAlphaBlending();
+}
+
+//---------------------------------------------------------
+// Function: Release
+void videoScopes::Release()
+{
+	m_overlay.clear();
+	m_bReady = false;
+	if (m_query > 0)
+		glDeleteQueries(1, &m_query);
+	m_query = 0;
+	m_bPending = false;
+	m_gpuTime = 0.0;
+}
+
+//---------------------------------------------------------
+// Function: GetStep
+unsigned int videoScopes::GetStep()
+{
+	return m_step;
+}
+
+//---------------------------------------------------------
+// Function: GetGpuTime
+double videoScopes::GetGpuTime()
+{
+	return m_gpuTime;
+}
+
+//---------------------------------------------------------
+// Function: ReadQuery
+// The result is read when available so that there is no wait
+void videoScopes::ReadQuery()
+{
+	if (!m_bPending)
+		return;
+
+	GLint available = 0;
+	glGetQueryObjectiv(m_query, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+		return;
+
+	GLuint64 nanoseconds = 0;
+	glGetQueryObjectui64v(m_query, GL_QUERY_RESULT, &nanoseconds);
+	double msec = (double)nanoseconds / 1000000.0;
+	if (m_gpuTime == 0.0) {
+		m_gpuTime = msec;
+	}
+	else {
+		// damped average
+		m_gpuTime *= 0.9;
+		m_gpuTime += 0.1*msec;
+	}
+	m_bPending = false;
+}
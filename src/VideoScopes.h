@@ -0,0 +1,77 @@
+/*
+
+	VideoScopes.h
+
+	Spout Video Player
+
+	Histogram, waveform and vectorscope of the processed frame.
+
+	The scopes are computed by compute shaders from the frame that is
+	sent, after the adjustments, and drawn as an overlay in the window.
+	The overlay is never part of the frame sent. To keep the cost low,
+	pixels are sampled on a grid of about 480 columns and the scopes
+	are updated at most every 50 msec. GPU time is measured with a
+	timer query that is read when it is complete.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include "ofMain.h"
+#include "SpoutGL\SpoutShaders.h" // For the scope shaders
+
+class videoScopes {
+
+	public:
+
+		~videoScopes();
+
+		// Minimum time between updates (msec)
+		void SetInterval(double msec);
+
+		// Analyse a new frame if the interval has passed.
+		// Returns true if the overlay was updated.
+		bool Update(spoutShaders &shaders, GLuint TextureID,
+			unsigned int width, unsigned int height);
+
+		// Draw the overlay, histograms, waveform and vectorscope
+		// side by side with an aspect ratio of 3:1.
+		void Draw(float x, float y, float width, float height);
+
+		void Release();
+
+		// Pixels between samples of the last update
+		unsigned int GetStep();
+
+		// Average GPU time of an update (msec)
+		double GetGpuTime();
+
+	protected :
+
+		ofTexture m_overlay; // 768x256
+		bool m_bReady = false;
+		double m_interval = 50.0;
+		double m_lastTime = 0.0;
+		unsigned int m_step = 1;
+
+		GLuint m_query = 0;
+		bool m_bPending = false;
+		double m_gpuTime = 0.0;
+
+		void ReadQuery();
+
+};
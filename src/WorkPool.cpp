@@ -0,0 +1,162 @@
+/*
+
+	WorkPool.cpp
+
+	Spout Video Player
+
+	Thread pool with a task queue for each thread.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "WorkPool.h"
+
+workPool::workPool() {
+}
+
+workPool::~workPool() {
+	Stop();
+}
+
+//---------------------------------------------------------
+// Function: Start
+void workPool::Start(int nThreads)
+{
+	Stop();
+
+	if (nThreads <= 0) {
+		nThreads = (int)std::thread::hardware_concurrency() - 1;
+		if (nThreads < 1)
+			nThreads = 1;
+	}
+
+	m_bStop = false;
+	m_next = 0;
+	for (int i = 0; i < nThreads; i++)
+		m_queues.push_back(std::make_unique<queue>());
+	for (int i = 0; i < nThreads; i++)
+		m_threads.push_back(std::thread(&workPool::Run, this, i));
+}
+
+//---------------------------------------------------------
+// Function: Stop
+void workPool::Stop()
+{
+	if (m_threads.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStop = true;
+	}
+	m_work.notify_all();
+
+	for (auto &thread : m_threads)
+		thread.join();
+	m_threads.clear();
+	m_queues.clear();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_queued = 0;
+	m_pending = 0;
+	m_idle.notify_all();
+}
+
+//---------------------------------------------------------
+// Function: GetThreads
+int workPool::GetThreads()
+{
+	return (int)m_threads.size();
+}
+
+//---------------------------------------------------------
+// Function: Submit
+// Tasks are added to the thread queues in turn
+void workPool::Submit(std::function<void()> task)
+{
+	if (m_queues.empty())
+		return;
+
+	queue &q = *m_queues[m_next % m_queues.size()];
+	m_next++;
+	{
+		std::lock_guard<std::mutex> lock(q.mutex);
+		q.tasks.push_back(std::move(task));
+	}
+
+	// Counted with the lock held so that a waiting thread is not missed
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queued++;
+		m_pending++;
+	}
+	m_work.notify_one();
+}
+
+//---------------------------------------------------------
+// Function: Wait
+void workPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_idle.wait(lock, [this] { return m_pending == 0; });
+}
+
+//---------------------------------------------------------
+// Function: Run
+// Thread function
+void workPool::Run(int index)
+{
+	std::function<void()> task;
+	while (!m_bStop) {
+		if (Take(index, task)) {
+			task();
+			task = nullptr;
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_pending == 0)
+				m_idle.notify_all();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_work.wait(lock, [this] { return m_bStop || m_queued > 0; });
+	}
+}
+
+//---------------------------------------------------------
+// Function: Take
+// Oldest task of this thread or the newest task of another
+bool workPool::Take(int index, std::function<void()> &task)
+{
+	int nQueues = (int)m_queues.size();
+	for (int i = 0; i < nQueues; i++) {
+		queue &q = *m_queues[(index + i) % nQueues];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if (q.tasks.empty())
+			continue;
+		if (i == 0) {
+			task = std::move(q.tasks.front());
+			q.tasks.pop_front();
+		}
+		else {
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+		}
+		m_queued--;
+		return true;
+	}
+	return false;
+}
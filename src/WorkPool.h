@@ -0,0 +1,83 @@
+/*
+
+	WorkPool.h
+
+	Spout Video Player
+
+	Thread pool with a task queue for each thread.
+
+	Tasks are added to the queues in turn. A thread takes tasks
+	from the front of its own queue and, when that is empty, takes
+	from the back of the other queues so that no thread is idle
+	while there is work to do.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class workPool {
+
+	public:
+
+		workPool();
+		~workPool();
+
+		// Start the threads. Zero uses all but one of the processor cores.
+		void Start(int nThreads = 0);
+
+		// Stop the threads. Tasks not started are discarded.
+		void Stop();
+
+		// Number of threads running
+		int GetThreads();
+
+		// Add a task
+		void Submit(std::function<void()> task);
+
+		// Wait until all tasks are finished
+		void Wait();
+
+	protected :
+
+		struct queue {
+			std::deque<std::function<void()>> tasks;
+			std::mutex mutex;
+		};
+
+		std::vector<std::unique_ptr<queue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::mutex m_mutex;
+		std::condition_variable m_work; // tasks queued or stop
+		std::condition_variable m_idle; // all tasks finished
+		std::atomic<int> m_queued{0};   // tasks in the queues
+		int m_pending = 0;              // tasks not finished
+		unsigned int m_next = 0;        // queue for the next task
+		std::atomic<bool> m_bStop{false};
+
+		void Run(int index);
+		bool Take(int index, std::function<void()> &task);
+
+};
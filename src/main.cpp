@@ -41,7 +41,19 @@
 //========================================================================
 int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPSTR lpCmdLine, _In_ int nShowCmd) {
 
-    ofSetupOpenGL(800, 450, OF_WINDOW); // <-------- setup the GL context
+    // Headless server mode "-headless 1" has a hidden window
+    // for the GL context and no menu or preview (see ofApp::setup)
+    bool bHeadless = (lpCmdLine && strstr(lpCmdLine, "-headless 1") != NULL);
+    if (bHeadless) {
+        ofGLFWWindowSettings settings;
+        settings.setSize(320, 180);
+        settings.visible = false;
+        settings.decorated = false;
+        ofCreateWindow(settings);
+    }
+    else {
+        ofSetupOpenGL(800, 450, OF_WINDOW); // <-------- setup the GL context
+    }
 	// this kicks off the running of my app
 	// can be OF_WINDOW or OF_FULLSCREEN
 	// pass in width and height too:
@@ -50,6 +62,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     // Allow for app lpCmdLine
     ofApp* app = new ofApp();
     app->lpCmdLine = lpCmdLine;
+    app->bHeadless = bHeadless;
     ofRunApp(app); // start the app
 
 }
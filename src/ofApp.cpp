@@ -78,6 +78,102 @@
 	04.03.24	- Rebuild VS 2022 /MT x64 for Openframeworks 12.0
 				  with updated ofxNDI, ofxWinMenu, SpoutGL, SpoutLibrary and NDI 5.6.0
 				  Version 2.002
+	19.10.26	- Add seamless loop option
+				  The first frames are cached and played at the end of the movie
+				  while the decoder seeks past them. Loop point jitter is measured.
+				- Add memory cache option
+				  Decoded frames are kept in memory after the first pass and
+				  played without decoding. Least recently used clips are removed
+				  to keep within the cache size.
+				- Add uncompressed raw movie (.svr) playback
+				  Frames are uploaded directly from a memory mapped file.
+				  See tools/rawtool for the converter and read benchmark.
+				- Add image sequence playback
+				  Numbered image files are decoded ahead by a thread pool.
+				  Frame rate and threads set by the ini file.
+				  Command line "-benchmark 1" shows decode rate for each thread count.
+				- Add still image playback
+				  An image is processed and sent again only when it or the
+				  adjustments change. NDI is refreshed at a low rate (ini stillndirate).
+				- Keep the original of the current frame
+				  Adjustments are processed and sent again while paused.
+				- Add "Skip repeated frames" option (Output menu)
+				  A compute shader hash finds frames that are the same as the
+				  last one sent. They are not sent again. NDI is refreshed
+				  at the stillndirate. The number of frames skipped is shown.
+				  The shaders are not run again for a repeated frame, the last
+				  output is copied back. The hash fence is polled without waiting.
+				  Off by default (ini skiprepeated).
+				- Add "Fixed output rate" option (Output menu)
+				  Frames are sent at the ini frcrate by repeat, blend or
+				  block motion interpolation. Cadence, time stamp and
+				  GPU time of each method are shown.
+				- Add variable speed playback 0.1 - 8 ('+' / '-' keys, command line "-speed")
+				  Slow motion frames are blended between the movie frames.
+				  Fast speeds read or decode only the frames shown and
+				  the frames skipped are counted.
+				- Add motion adaptive deinterlace (View menu)
+				  Single or double rate with top or bottom field first,
+				  before the adjustments. See DeinterlaceCpu for the
+				  CPU reference and tools/rawtool for a headless test.
+				- Add nv12 raw movies (rawtool convert "nv12")
+				  Native YUV 4:2:0 planes are uploaded at 1.5 bytes per pixel
+				  and converted on the GPU with BT.601, BT.709 or BT.2020 and
+				  limited or full range (View menu, ini yuvmatrix, yuvfullrange).
+				- Add temporal denoise (Adjust dialog)
+				  Motion masked recursive filter with a history texture in
+				  the same shader pass as the adjustments. Command line
+				  "-denoisebench 1" shows quality and GPU time on a synthetic
+				  noisy sequence. See also tools/rawtool "denoise".
+				  Deinterlaced, slow motion and denoised frames are sent by
+				  NDI from the fbo with an asynchronous readback (FrameReadback.h).
+				- Add histogram, waveform and vectorscope (View menu "Scopes")
+				  Compute shaders sample the processed frame on a grid of about
+				  480 columns at most every 50 msec. The overlay is drawn in the
+				  window and is not sent.
+				- Add auto levels (View menu "Auto levels")
+				  Minimum, maximum and mean luminance from a reduction compute
+				  shader are read back with fences without waiting, damped, and
+				  replace brightness, contrast and gamma of the adjustments.
+				- Add user effects (View menu "Effects")
+				  Compute shader files in "data/shaders" with a header for the
+				  name, pipeline position and uniforms. Files are watched and
+				  recompiled when saved and a failed compile keeps the last
+				  good program. See EffectChain.h and shaders/vignette.glsl.
+				- Add keyframed adjustments from a sidecar file "movie.keys"
+				  Linear or bezier curves for brightness, contrast, saturation,
+				  gamma, blur and sharpness at the time of each frame.
+				  See Keyframes.h for the file format.
+				- Add headless server mode with command line "-headless 1"
+				  A hidden window for the GL context, no menu, preview or
+				  controls. Frames are decoded, processed and sent.
+				  Messages are logged to SpoutVideoPlayer.log.
+				- Add command line "-drawbench 1" to log the CPU and GPU
+				  time of the draw cycle. Startup time is always logged.
+				- Add window preview options (View menu "Preview")
+				  Off, reduced rate (ini previewinterval) or half size.
+				  The preview is not drawn while the window is minimized.
+				- Draw the control bar into iconFbo only when a button
+				  changes. The movie progress is drawn for each frame.
+				- Information text is formatted 4 times a second and drawn
+				  from cached glyph meshes in one draw call (TextOverlay.h)
+				- Decode the splash image and icons on worker threads and
+				  upload them with the icons in one atlas when first shown.
+				  Load the font and NDI version when first used.
+				  Log the time from the start to the first frame sent.
+				- Add a cache of movie stream parameters and first frame
+				  thumbnails (MediaProbe.h). A movie opened before is set up
+				  immediately and the decoder is opened by a thread (DecoderThread.h)
+				  while the thumbnail is sent.
+				- Add thumbnails over the movie timeline shown when the mouse
+				  is over the progress bar (ScrubThumbnails.h). Key frames are
+				  extracted at idle priority by a Media Foundation source reader
+				  and the thumbnails are saved in the probe folder.
+				- Add scheduled playback from a cue file (CueList.h).
+				  Command line "-cues file". The decoder of the next cue
+				  is opened and seeked before the cue time.
+				- Add sync of instances to the media time of a master
+				  (SyncClock.h). Command line "-sync master" or "-sync follow".
 
 */
 #include "ofApp.h"
@@ -115,6 +211,14 @@ void ofApp::setup(){
 	g_hInstance = GetModuleHandle(NULL);
 	g_hWnd = ofGetWin32Window();
 
+	// Headless server mode has a hidden window (see main.cpp).
+	// Messages are logged to a file instead of shown and the
+	// frame rate is not held to the display refresh.
+	if (bHeadless) {
+		EnableSpoutLogFile("SpoutVideoPlayer.log");
+		SpoutLogNotice("ofApp::setup - headless mode");
+		ofSetVerticalSync(false);
+	}
 
 	// Debug console window so printf works
 	// Note use of WinMain in main.cpp and 
@@ -144,10 +248,10 @@ void ofApp::setup(){
 			}
 		}
 	}
-	ofSetWindowTitle(title); // show it on the title bar
+	if (!bHeadless)
+		ofSetWindowTitle(title); // show it on the title bar
 
-	// Load a font rather than the default
-	myFont.load("fonts/verdana.ttf", 12, true, true);
+	// A font rather than the default is loaded when first used (see LoadFont)
 
 	// Main window handle
 	hWnd = WindowFromDC(wglGetCurrentDC());
@@ -156,7 +260,8 @@ void ofApp::setup(){
 	pThis = this;
 
 	// Set a custom window icon
-	SetClassLongPtrA(hWnd, GCLP_HICON, (LONG_PTR)LoadIconA(GetModuleHandle(NULL), MAKEINTRESOURCEA(IDI_SPOUTICON)));
+	if (!bHeadless)
+		SetClassLongPtrA(hWnd, GCLP_HICON, (LONG_PTR)LoadIconA(GetModuleHandle(NULL), MAKEINTRESOURCEA(IDI_SPOUTICON)));
 
 	// Disable escape key exit so we can exit fullscreen with Escape (see keyPressed)
 	ofSetEscapeQuitsApp(false);
@@ -165,7 +270,9 @@ void ofApp::setup(){
 	// Create a menu using ofxWinMenu
 	//
 
-	// A new menu object with a pointer to this class
+	// A new menu object with a pointer to this class.
+	// In headless mode it holds the menu item states
+	// for the ini file but is not set to the window.
 	menu = new ofxWinMenu(this, hWnd);
 
 	// Register an ofApp function that is called when a menu item is selected.
@@ -194,10 +301,32 @@ void ofApp::setup(){
 	//
 	hPopup = menu->AddPopupMenu(hMenu, "View");
 	menu->AddPopupItem(hPopup, "Adjust", false, false);
+	menu->AddPopupItem(hPopup, "Auto levels", false); // Not checked
+	menu->AddPopupItem(hPopup, "Effects", false); // Not checked
+	bDeinterlace = false; // Progressive movie
+	menu->AddPopupItem(hPopup, "Deinterlace", false);  // Not checked
+	menu->AddPopupItem(hPopup, "    Double rate", false);
+	menu->AddPopupItem(hPopup, "    Bottom field first", false);
+	menu->EnablePopupItem("    Double rate", false); // Until "Deinterlace" is checked
+	menu->EnablePopupItem("    Bottom field first", false);
+	menu->AddPopupItem(hPopup, "YUV matrix auto", true); // Checked
+	menu->AddPopupItem(hPopup, "    BT.601", false, false); // Not auto-check
+	menu->AddPopupItem(hPopup, "    BT.709", false, false);
+	menu->AddPopupItem(hPopup, "    BT.2020", false, false);
+	menu->AddPopupItem(hPopup, "YUV full range", false); // Not checked
+	menu->AddPopupItem(hPopup, "Scopes", false); // Not checked
+	menu->AddPopupItem(hPopup, "Preview", true); // Checked
+	menu->AddPopupItem(hPopup, "    Reduced rate", false);
+	menu->AddPopupItem(hPopup, "    Half size", false);
 	bShowControls = false;  // don't show controls yet
 	menu->AddPopupItem(hPopup, "Controls");
 	bLoop = false;  // movie loop
 	menu->AddPopupItem(hPopup, "Loop");
+	bSeamless = false; // Loop from cached frames
+	menu->AddPopupItem(hPopup, "    Seamless", false);  // Not checked
+	menu->EnablePopupItem("    Seamless", false); // Until "Loop" is checked
+	bMemoryCache = false; // Play from memory after the first pass
+	menu->AddPopupItem(hPopup, "Memory cache", false); // Not checked
 	bMute = false; // Audio mute
 	menu->AddPopupItem(hPopup, "Mute");
 	bResizeWindow = false; // not resizing
@@ -221,6 +350,15 @@ void ofApp::setup(){
 	// Add NDI options
 	menu->AddPopupItem(hPopup, "    Async", false);  // Not checked
 	menu->EnablePopupItem("    Async", false); // Until "NDI" is checked
+	menu->AddPopupSeparator(hPopup);
+	menu->AddPopupItem(hPopup, "Skip repeated frames", false); // Not checked
+	menu->AddPopupSeparator(hPopup);
+	bFrc = false;
+	menu->AddPopupItem(hPopup, "Fixed output rate", false); // Not checked
+	// Conversion methods
+	menu->AddPopupItem(hPopup, "    Repeat", false, false); // Not auto-check
+	menu->AddPopupItem(hPopup, "    Blend", true, false);
+	menu->AddPopupItem(hPopup, "    Motion", false, false);
 
 	//
 	// Help popup menu
@@ -234,7 +372,8 @@ void ofApp::setup(){
 	ResetWindow(true);
 
 	// Set the menu to the window after adjusting the size
-	menu->SetWindowMenu();
+	if (!bHeadless)
+		menu->SetWindowMenu();
 
 	bMenuExit = false; // to handle mouse position
 	bMessageBox = false; // To handle messagebox and mouse events
@@ -262,43 +401,34 @@ void ofApp::setup(){
 	strcat_s(info, 1024, "  LEFT/RIGHT   back/forward one frame\n");
 	strcat_s(info, 1024, "  PGUP/PGDN  back/forward 8 frames\n");
 	strcat_s(info, 1024, "  HOME/END   start/end of video\n");
+	strcat_s(info, 1024, "  '+' / '-'     faster / slower\n");
 	strcat_s(info, 1024, "  's'	        stop and close movie\n\n");
 	strcat_s(info, 1024, "  RH click window - show / hide Adjust dialog\n");
 
-	// Load splash screen
+	// Splash screen
 	bSplash = true;
-	splashImage.load("images/SpoutVideoPlayer.png");
 
 	// Read ini file to get bLoop, bSpoutOut, bNDIout, bNDIasync and bTopmost flags
 	ReadInitFile();
 
+	// Probe files of movies opened before are next to the ini file
+	char probefolder[MAX_PATH]{};
+	strcpy_s(probefolder, MAX_PATH, g_InitFile);
+	PathRemoveFileSpecA(probefolder);
+	strcat_s(probefolder, MAX_PATH, "\\probe");
+	probes.SetFolder(probefolder);
+
 	//
 	// Play bar
 	//
 
 	// icons
 	icon_size = 20; // 22; // 27; // 32; // 64;
-	icon_reverse.load("icons/reverse.png");
-	icon_fastforward.load("icons/fastforward.png");
-	icon_stop.load("icons/stop.png");
-	icon_back.load("icons/back.png");
-	icon_play.load("icons/play.png");
-	icon_pause.load("icons/pause.png");
-	icon_forward.load("icons/forward.png");
-	icon_full_screen.load("icons/full_screen.png");
-	icon_sound.load("icons/speaker.png");
-	icon_mute.load("icons/speaker_mute.png");
-
-	icon_reverse.resize(icon_size, icon_size);
-	icon_fastforward.resize(icon_size, icon_size);
-	icon_stop.resize(icon_size, icon_size);
-	icon_play.resize(icon_size, icon_size);
-	icon_pause.resize(icon_size, icon_size);
-	icon_back.resize(icon_size, icon_size);
-	icon_forward.resize(icon_size, icon_size);
-	icon_full_screen.resize(icon_size, icon_size);
-	icon_sound.resize(icon_size, icon_size);
-	icon_mute.resize(icon_size, icon_size);
+
+	// The splash image and icons are decoded and resized on worker threads
+	// and uploaded when the window first shows them (see UiAssets.h)
+	if (!bHeadless)
+		assets.Start((int)icon_size);
 
 	icon_playpause_hover = false;
 	icon_reverse_hover = false;
@@ -337,10 +467,8 @@ void ofApp::setup(){
 
 	// Asynchronous sending instead of clocked at the movie fps
 	NDIsender.SetAsync(bNDIasync);
-	// Get NewTek library version number (dll) for the about box
-	// Version number is the last 7 chars - e.g 2.1.0.3
-	string NDIversion = NDIsender.GetNDIversion();
-	NDInumber = NDIversion.substr(NDIversion.length() - 7, 7);
+	// The NewTek library version number for the about box
+	// is found when first used (see GetNDInumber)
 
 	// For movie frame fps calculations
 	// independent of the rendering rate
@@ -350,7 +478,8 @@ void ofApp::setup(){
 	fps = frameRate = 30.0;
 
 	// Keyboard hook for volume dialog
-	hHook = SetWindowsHookExA(WH_KEYBOARD, KeyProc, NULL, GetCurrentThreadId());
+	if (!bHeadless)
+		hHook = SetWindowsHookExA(WH_KEYBOARD, KeyProc, NULL, GetCurrentThreadId());
 
 	// Set RGBA pixel format for Spout, NDI and shaders
 	myMovie.setPixelFormat(OF_PIXELS_RGBA);
@@ -389,6 +518,23 @@ void ofApp::setup(){
 	start = std::chrono::steady_clock::now();
 	end = std::chrono::steady_clock::now();
 
+	// Cue file from the command line. The clock starts now.
+	if (!cueFile.empty()) {
+		if (cues.Load(cueFile))
+			SpoutLogNotice("ofApp::setup - %d cues from %s", cues.GetCues(), cueFile.c_str());
+		else
+			SpoutLogWarning("ofApp::setup - no cues in %s", cueFile.c_str());
+	}
+
+	// Media time shared with other instances
+	if (!syncMode.empty()) {
+		if (sync.Open(syncMode == "master"))
+			SpoutLogNotice("ofApp::setup - sync %s", syncMode.c_str());
+		else
+			SpoutLogWarning("ofApp::setup - could not open the sync clock");
+	}
+	syncLogTime = ofGetElapsedTimef();
+
 	// Command line movie file
 	if (!movieFile.empty()) {
 		if (OpenMovieFile(movieFile)) {
@@ -401,6 +547,50 @@ void ofApp::setup(){
 		}
 	}
 
+	// Time from the start of the process including the window
+	// and the command line movie, e.g. to compare with headless mode.
+	// The time to the first frame sent is logged by SendFrames.
+	SpoutLogNotice("ofApp::setup - started in %.1f msec%s",
+		GetProcessTime(), bHeadless ? " (headless)" : "");
+	drawLogTime = ofGetElapsedTimef();
+
+}
+
+//--------------------------------------------------------------
+double ofApp::GetProcessTime()
+{
+	FILETIME created{}, exited{}, kernel{}, user{}, now{};
+	if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user))
+		return 0.0;
+
+	GetSystemTimeAsFileTime(&now);
+	ULARGE_INTEGER t0{}, t1{};
+	t0.LowPart = created.dwLowDateTime; t0.HighPart = created.dwHighDateTime;
+	t1.LowPart = now.dwLowDateTime; t1.HighPart = now.dwHighDateTime;
+
+	return (double)(t1.QuadPart - t0.QuadPart)/10000.0; // 100 nsec units
+}
+
+//--------------------------------------------------------------
+// The font is only needed for the window information
+void ofApp::LoadFont()
+{
+	if (!myFont.isLoaded()) {
+		myFont.load("fonts/verdana.ttf", 12, true, true);
+		infoText.SetFont(&myFont);
+	}
+}
+
+//--------------------------------------------------------------
+// Version number is the last 7 chars - e.g 2.1.0.3
+std::string ofApp::GetNDInumber()
+{
+	if (NDInumber.empty()) {
+		string NDIversion = NDIsender.GetNDIversion();
+		if (NDIversion.length() >= 7)
+			NDInumber = NDIversion.substr(NDIversion.length() - 7, 7);
+	}
+	return NDInumber;
 }
 
 void ofApp::ParseCommandLine(LPSTR lpCmdLine) {
@@ -454,6 +644,50 @@ void ofApp::ParseCommandLine(LPSTR lpCmdLine) {
 		bFullscreen = (atoi(argstr.c_str()) == 1);
 	}
 
+	// Image sequence frame rate
+	argstr = FindArgString(line, "-fps");
+	if (!argstr.empty()) {
+		sequenceFps = atof(argstr.c_str());
+		if (sequenceFps <= 0.0) sequenceFps = 30.0;
+	}
+
+	// Image sequence decode benchmark
+	argstr = FindArgString(line, "-benchmark");
+	if (!argstr.empty()) {
+		bSequenceBench = (atoi(argstr.c_str()) == 1);
+	}
+
+	// Temporal denoise benchmark
+	argstr = FindArgString(line, "-denoisebench");
+	if (!argstr.empty()) {
+		bDenoiseBench = (atoi(argstr.c_str()) == 1);
+	}
+
+	// Draw cycle timing
+	argstr = FindArgString(line, "-drawbench");
+	if (!argstr.empty()) {
+		bDrawBench = (atoi(argstr.c_str()) == 1);
+	}
+
+	// Playback speed (0.1 - 8)
+	argstr = FindArgString(line, "-speed");
+	if (!argstr.empty()) {
+		playSpeed = (float)atof(argstr.c_str());
+		if (playSpeed < 0.1f || playSpeed > 8.0f) playSpeed = 1.0f;
+	}
+
+	// Cue file for scheduled playback
+	argstr = FindArgString(line, "-cues");
+	if (!argstr.empty()) {
+		cueFile = argstr;
+	}
+
+	// Instance sync, "master" or "follow"
+	argstr = FindArgString(line, "-sync");
+	if (argstr == "master" || argstr == "follow") {
+		syncMode = argstr;
+	}
+
 }
 
 std::string ofApp::FindArgString(std::string line, std::string arg)
@@ -466,7 +700,35 @@ std::string ofApp::FindArgString(std::string line, std::string arg)
 		argstr = line.substr(pos+1); // skip the space
 		// printf("0 [%s]\n", argstr.c_str());
 		pos = argstr.find("movie");
-		if (pos != std::string::npos) {  // A movie name with extension "-movie name.ext "
+		if (arg == "-cues") { // A quoted path, or a path to the next option, with any spaces, stops or dashes
+			argstr = (argstr.length() > arg.length()) ? argstr.substr(arg.length()) : "";
+			argstr.erase(0, argstr.find_first_not_of(' '));
+			if (!argstr.empty() && argstr[0] == '"') {
+				pos = argstr.find('"', 1);
+				argstr = argstr.substr(1, (pos != std::string::npos) ? pos - 1 : std::string::npos);
+			}
+			else {
+				const char* options[] = { "-movie", "-brightness", "-contrast", "-saturation",
+					"-gamma", "-sharpness", "-adaptive", "-fullscreen", "-fps", "-benchmark",
+					"-denoisebench", "-drawbench", "-speed", "-sync" };
+				size_t end = argstr.length();
+				for (const char* option : options) {
+					std::string token = std::string(" ") + option;
+					size_t next = argstr.find(token);
+					while (next != std::string::npos) {
+						size_t after = next + token.length();
+						if (after == argstr.length() || argstr[after] == ' ')
+							break;
+						next = argstr.find(token, after);
+					}
+					if (next < end)
+						end = next;
+				}
+				argstr = argstr.substr(0, end);
+				argstr.erase(argstr.find_last_not_of(' ') + 1);
+			}
+		}
+		else if (arg == "-movie" && pos != std::string::npos) {  // A movie name with extension "-movie name.ext "
 			argstr = argstr.substr(pos+6); // Skip the arg
 			// printf("1 [%s]\n", argstr.c_str());
 			// Skip to the next stop preceding the extension
@@ -500,17 +762,57 @@ std::string ofApp::FindArgString(std::string line, std::string arg)
 //--------------------------------------------------------------
 void ofApp::update(){
 
+	// Scheduled playback
+	if (cues.IsLoaded())
+		UpdateCues();
+
 	if (bLoaded) {
 
+		// The thumbnail is sent until the decoder is open
+		if (bOpening) {
+			UpdateOpening();
+			return;
+		}
+
 		myMovie.update();
+		bNewFrame = myMovie.isFrameNew();
+		bRepeatedFrame = false;
+
+		// Play from memory when all the frames are cached
+		// or from a raw movie file mapping
+		if (bMemoryCache || bClipPlay)
+			UpdateClip();
+
+		// Loop point for timing
+		bool bLoopPoint = false;
+		if (bClipPlay) {
+			// Frames are played from memory
+		}
+		else if (bLoop && bSeamless) {
+			// Cache the first frames and play them at the end of the movie
+			bLoopPoint = UpdateLoop();
+		}
+		else if (bLoop && bNewFrame) {
+			// The decoder has returned to the start
+			int frame = myMovie.getCurrentFrame();
+			bLoopPoint = (frame < nLastFrame);
+			nLastFrame = frame;
+		}
 
 		// Attach the movie frame to an fbo with rgba internal format
 		// necessary for shaders. Also the movie frame alpha may be zero.
-		myFbo.attachTexture(myMovie.getTexture(), GL_RGBA8, 0);
+		// A cached frame replaces the movie frame for a seamless loop.
+		// Frames played from memory are uploaded to a separate texture.
+		if (bClipPlay)
+			myFbo.attachTexture(clipTexture, GL_RGBA8, 0);
+		else if (bLoopPlay)
+			myFbo.attachTexture(loopTexture, GL_RGBA8, 0);
+		else
+			myFbo.attachTexture(myMovie.getTexture(), GL_RGBA8, 0);
 
 		// Handle pause at the end of a movie if not looping
 		// This also prevents the old frame count from incrementing at the end of the movie
-		if (!bPaused && !bLoop) {
+		if (!bPaused && !bLoop && !bClipPlay) {
 			if (myMovie.getCurrentFrame() >= myMovie.getTotalNumFrames() - 2) {
 				myMovie.setPosition(0.0);
 				myMovie.setPaused(true);
@@ -518,67 +820,76 @@ void ofApp::update(){
 			}
 		}
 
+		// Levels of frames already processed
+		if (bAutoLevels && bInitialized)
+			levels.Update();
+
+		// Keyframe file changed
+		automation.CheckFile(ofGetElapsedTimeMillis());
+
+		// Effect files changed
+		if (bEffects && bInitialized)
+			effects.Update(shaders, spoutsender->GetSenderWidth(), spoutsender->GetSenderHeight());
+
+		// Adjustments changed by the Adjust dialog, keyframes or auto levels
+		bool bAdjusted = AdjustChanged();
+		if (bAdjusted) {
+			bFrameHash = false;
+			bHashPending = false;
+		}
+
 		// Check the old frame count
 		// if excessive, the movie is not playing
-		if (myMovie.isFrameNew()) {
+		if (bNewFrame) {
 
 			nOldFrames = 0;
 			nNewFrames++;
 
-			// Activate shaders on the received texture.
-			// Shaders have source and destination textures but the source
-			// can also be the destination. Compute shader extensions are 
-			// loaded when a sender is created in Draw().
-			if (bInitialized) {
+			// Output frame interval at the loop point
+			if (bLoop)
+				loopHead.FrameTime((double)ofGetElapsedTimeMicros(), bLoopPoint);
 
-				GLuint myTextureID  = myFbo.getTexture().getTextureData().textureID;
-				unsigned int width  = spoutsender->GetSenderWidth();
-				unsigned int height = spoutsender->GetSenderHeight();
-
-				// Brightness    -1 - 1   default 0
-				// Contrast       0 - 4   default 1
-				// Saturation     0 - 4   default 1
-				// Gamma          0 - 4   default 1
-				// 0.005 - 0.007 msec
-				if (Brightness     != 0.0
-					|| Contrast    != 1.0
-					|| Saturation  != 1.0
-					|| Gamma       != 1.0) {
-					shaders.Adjust(myTextureID, myTextureID,
-						width, height, Brightness, Contrast, Saturation, Gamma);
-				}
+			// CPU time for decoded and cached frames
+			if (bMemoryCache && clipSource == &clips)
+				clips.FrameTime(bClipPlay);
 
-				// Blur 0 - 4  (default 0)
-				// 0.001 - 0.002 msec
-				if (Blur > 0.0) {
-					shaders.Blur(myTextureID, myTextureID, width, height, Blur);
-				}
+			// Hash the frame before the shaders change it.
+			// It is compared with the last one before processing.
+			HashFrame();
 
-				// Sharpness 0 - 1   default 0
-				// 0.001 - 0.002 msec
-				if (Sharpness > 0.0) {
-					if (bAdaptive) {
-						// Sharpness width radio buttons
-						// 3x3, 5x5, 7x7 : 3.0, 5.0, 7.0
-						float caswidth = 1.0f+(Sharpwidth-3.0f)/2.0f; // 1.0, 2.0, 3.0
-						// Sharpness; // 0.0 - 1.0
-						shaders.AdaptiveSharpen(myTextureID,
-							width, height, caswidth, Sharpness);
-					}
-					else {
-						shaders.Sharpen(myTextureID, myTextureID, width, height, Sharpwidth, Sharpness);
-					}
-				}
+			// Probe of a movie opened without one
+			if (bProbeStore && !bClipPlay && !bLoopPlay)
+				StoreProbe();
+
+			// First frame after a cue
+			if (cues.IsLoaded())
+				cues.FrameShown();
 
-				if (bFlip)
-					shaders.Flip(myTextureID, width, height);
-				if (bMirror)
-					shaders.Mirror(myTextureID, width, height);
-				if (bSwap)
-					shaders.Swap(myTextureID, width, height);
+			// Denoise quality and GPU time at the movie size (command line "-denoisebench")
+			if (bDenoiseBench && bInitialized) {
+				std::string result = temporalDenoise::Benchmark(shaders,
+					spoutsender->GetSenderWidth(), spoutsender->GetSenderHeight());
+				doMessageBox(NULL, result.c_str(), "Temporal denoise", MB_OK);
+				bDenoiseBench = false;
+			}
 
+			// Run the shaders on the new frame, or copy back the
+			// last output if the frame and adjustments are the same
+			bRepeatedFrame = FrameRepeated();
+			if (!bRepeatedFrame || !RestoreRepeated()) {
+				bRepeatedFrame = false;
+				ProcessFrame(false);
+				SaveRepeated();
 			}
-						
+			AddSourceFrame();
+
+			// The second field at double rate is half a frame later
+			fieldTime = (double)ofGetElapsedTimeMicros() + 500000.0/((double)movieFps*(double)playSpeed);
+
+			// Frames passed over at fast speeds
+			if (!bLoopPlay)
+				CountSkipped(bClipPlay ? nClipFrame : myMovie.getCurrentFrame());
+
 			// Calculate movie fps
 			lastTime = startTime;
 			startTime = ofGetElapsedTimeMicros();
@@ -591,10 +902,23 @@ void ofApp::update(){
 			}
 
 		}
+		else if (bAdjusted && (bPaused || (bClipPlay && clipSource == &still))) {
+			// The frame is not changing. Process it again from the
+			// original with the new adjustments and send it (see Draw).
+			if (ProcessFrame(true)) {
+				bNewFrame = true;
+				if (bFrc)
+					frc.ReplaceFrame(shaders, myFbo.getTexture().getTextureData().textureID);
+				if (playSpeed < 1.0f)
+					slowMotion.ReplaceFrame(shaders, myFbo.getTexture().getTextureData().textureID);
+			}
+		}
 		else {
-			if (!bPaused) {
+			// Frames played by the application have no codec to fail.
+			// New frames are less frequent in slow motion.
+			if (!bPaused && !bClipPlay) {
 				nOldFrames++;
-				if (nOldFrames > 60 && nNewFrames < 61) { // 2 seconds at 30 fps
+				if (nOldFrames > (int)(60.0f/playSpeed) && nNewFrames < 61) { // 2 seconds at 30 fps
 
 					// Cannot call close for failure
 					bLoaded = false;
@@ -611,192 +935,1376 @@ void ofApp::update(){
 				}
 			}
 		}
+
+		// Second field of a double rate deinterlace
+		if (deint.FieldPending() && !bNewFrame && !bPaused
+			&& (double)ofGetElapsedTimeMicros() >= fieldTime) {
+			if (ProcessFrame(false, true)) {
+				AddSourceFrame();
+				bNewFrame = true;
+			}
+		}
+
+		// Slow motion frames between the movie frames are
+		// blended for each draw cycle and sent (see Draw)
+		if (playSpeed < 1.0f && !bFrc && !bPaused && bInitialized && slowMotion.Present(shaders)) {
+			shaders.Copy(slowMotion.GetTexture().getTextureData().textureID,
+				myFbo.getTexture().getTextureData().textureID,
+				spoutsender->GetSenderWidth(), spoutsender->GetSenderHeight());
+			bNewFrame = true;
+		}
+
+		// Instances in sync
+		if (sync.IsOpen())
+			UpdateSync();
 	}
 
 }
 
 //--------------------------------------------------------------
-void ofApp::draw() {
+// Run the shaders on the frame attached to the fbo.
+//
+// Shaders work on the texture in place. The original frame is kept
+// before it is changed so that it can be processed again with new
+// adjustments while paused, without decoding.
+// An interlaced frame is deinterlaced first and the original is
+// the deinterlaced frame. bField processes the second field.
+// Returns false if the shaders are not available.
+bool ofApp::ProcessFrame(bool bRestore, bool bField)
+{
+	// A new frame replaces the original
+	if (!bRestore)
+		bPristine = false;
+
+	// Activate shaders on the received texture.
+	// Shaders have source and destination textures but the source
+	// can also be the destination. Compute shader extensions are 
+	// loaded when a sender is created in Draw().
+	if (bInitialized) {
+
+		GLuint myTextureID  = myFbo.getTexture().getTextureData().textureID;
+		unsigned int width  = spoutsender->GetSenderWidth();
+		unsigned int height = spoutsender->GetSenderHeight();
+
+		// Start again from the original frame
+		if (bRestore && bPristine)
+			shaders.Copy(pristineTexture.getTextureData().textureID, myTextureID, width, height);
+
+		// Deinterlace a new frame or the second field
+		if (bField) {
+			deint.ProcessField(shaders, myTextureID);
+		}
+		else if (!bRestore && bDeinterlace) {
+			int frame = bClipPlay ? nClipFrame : (bLoopPlay ? nLoopFrame : myMovie.getCurrentFrame());
+			deint.Process(shaders, myTextureID, width, height, frame);
+		}
 
-	char str[256]{};
-	ofSetColor(255);
-	ofBackground(0);
+		// Keyframes at the time of the frame replace the dialog values
+		float values[keyframes::KEY_PARAMS] = { Brightness, Contrast, Saturation, Gamma, Blur, Sharpness };
+		if (automation.IsLoaded()) {
+			int frame = bClipPlay ? nClipFrame : (bLoopPlay ? nLoopFrame : myMovie.getCurrentFrame());
+			if (movieFps > 0.0f)
+				automation.Evaluate((double)frame / (double)movieFps, values);
+		}
+		float brightness = values[keyframes::KEY_BRIGHTNESS];
+		float contrast   = values[keyframes::KEY_CONTRAST];
+		float saturation = values[keyframes::KEY_SATURATION];
+		float gamma      = values[keyframes::KEY_GAMMA];
+		float blur       = values[keyframes::KEY_BLUR];
+		float sharpness  = values[keyframes::KEY_SHARPNESS];
+
+		// Levels before the adjustments. The adjustments
+		// follow when the result is read (see Update).
+		if (bAutoLevels) {
+			levels.Analyse(shaders, myTextureID, width, height);
+			brightness = levels.GetBrightness();
+			contrast   = levels.GetContrast();
+			gamma      = levels.GetGamma();
+		}
 
-	// Continue play if paused by menu selection
-	// or mouse click outside the client area
-	if (bNCmousePressed) {
-		if (myMovie.isLoaded())
-			myMovie.setPaused(false);
-		bNCmousePressed = false;
-	}
+		// Keep the original frame if the shaders will change it.
+		// There is no copy if there are no adjustments.
+		if (!bPristine && (brightness != 0.0 || contrast != 1.0
+			|| saturation != 1.0 || gamma != 1.0 || bAutoLevels
+			|| (bEffects && effects.HasEffects())
+			|| blur > 0.0 || sharpness > 0.0 || Denoise > 0.0
+			|| bFlip || bMirror || bSwap)) {
+			if ((unsigned int)pristineTexture.getWidth() != width
+				|| (unsigned int)pristineTexture.getHeight() != height)
+				pristineTexture.allocate(width, height, GL_RGBA8);
+			bPristine = shaders.Copy(myTextureID, pristineTexture.getTextureData().textureID, width, height);
+		}
 
-	if (bSplash || !bLoaded) {
-		splashImage.draw(0, 0, ofGetWidth(), ofGetHeight());
-		return;
-	}
+		// User effects after each stage
+		if (bEffects)
+			effects.Process(shaders, effectChain::AFTER_DEINTERLACE, myTextureID, width, height);
+
+		// Brightness    -1 - 1   default 0
+		// Contrast       0 - 4   default 1
+		// Saturation     0 - 4   default 1
+		// Gamma          0 - 4   default 1
+		// 0.005 - 0.007 msec
+		// Denoise        0 - 1   default 0
+		// in the same pass with a history of the last frame.
+		// The history is not changed when the frame is restored.
+		if (Denoise > 0.0) {
+			denoise.Process(shaders, myTextureID, width, height, Denoise, !bRestore,
+				brightness, contrast, saturation, gamma);
+		}
+		else if (brightness != 0.0
+			|| contrast    != 1.0
+			|| saturation  != 1.0
+			|| gamma       != 1.0) {
+			shaders.Adjust(myTextureID, myTextureID,
+				width, height, brightness, contrast, saturation, gamma);
+		}
 
-	// Draw the movie frame sized to the aspect ratio of the movie
-	float drawWidth = ofGetHeight()*movieWidth/movieHeight;
-	float leftx = (ofGetWidth()-drawWidth)/2.0f;
-	myFbo.draw(leftx, 0, drawWidth, ofGetHeight());
+		// Start the history again when the denoise is next used
+		if (Denoise == 0.0)
+			denoise.Start();
 
-	if (myMovie.isFrameNew()) {
+		if (bEffects)
+			effects.Process(shaders, effectChain::AFTER_ADJUST, myTextureID, width, height);
 
-		//
-		// Spout
-		//
-		if (bSpoutOut) {
-			// If not initialized, create a Spout sender the same size as the movie
-			// (sendername is initialized by movie load)
-			if (!bInitialized) {
-				bInitialized = spoutsender->CreateSender(sendername,
-					(unsigned int)myFbo.getWidth(), (unsigned int)myFbo.getHeight());
-			}
-			else {
-				// Receivers will detect the movie frame rate
-				spoutsender->SendTexture(myFbo.getTexture().getTextureData().textureID,
-					myFbo.getTexture().getTextureData().textureTarget,
-					(unsigned int)myFbo.getWidth(), (unsigned int)myFbo.getHeight(), false);
-			}
+		// Blur 0 - 4  (default 0)
+		// 0.001 - 0.002 msec
+		if (blur > 0.0) {
+			shaders.Blur(myTextureID, myTextureID, width, height, blur);
 		}
 
-		//
-		// NDI
-		//
-		if (bNDIout) {
-			if (!bNDIinitialized) {
-				bNDIinitialized = NDIsender.CreateSender(sendername,
-					(unsigned int)myMovie.getWidth(), (unsigned int)myMovie.getHeight());
+		if (bEffects)
+			effects.Process(shaders, effectChain::AFTER_BLUR, myTextureID, width, height);
+
+		// Sharpness 0 - 1   default 0
+		// 0.001 - 0.002 msec
+		if (sharpness > 0.0) {
+			if (bAdaptive) {
+				// Sharpness width radio buttons
+				// 3x3, 5x5, 7x7 : 3.0, 5.0, 7.0
+				float caswidth = 1.0f+(Sharpwidth-3.0f)/2.0f; // 1.0, 2.0, 3.0
+				// Sharpness; // 0.0 - 1.0
+				shaders.AdaptiveSharpen(myTextureID,
+					width, height, caswidth, sharpness);
 			}
 			else {
-				// Send the movie pixels
-				// NDI format set to RGBX will produce alpha = 255
-				NDIsender.SendImage(myMovie.getPixels().getData(),
-					(unsigned int)myMovie.getWidth(), (unsigned int)myMovie.getHeight());
+				shaders.Sharpen(myTextureID, myTextureID, width, height, Sharpwidth, sharpness);
 			}
 		}
 
-	} // endif new frame
+		if (bEffects)
+			effects.Process(shaders, effectChain::AFTER_SHARPEN, myTextureID, width, height);
 
-	// 'Space" to show or hide controls
-	drawPlayBar();
+		if (bFlip)
+			shaders.Flip(myTextureID, width, height);
+		if (bMirror)
+			shaders.Mirror(myTextureID, width, height);
+		if (bSwap)
+			shaders.Swap(myTextureID, width, height);
 
-	ofSetColor(255);
-	if (bLoaded && !bFullscreen && bShowInfo) {
+		if (bEffects)
+			effects.Process(shaders, effectChain::AFTER_OUTPUT, myTextureID, width, height);
 
-		if (spoutsender->IsInitialized()) {
-			sprintf_s(str, 256, "Sending as : [%s] (%dx%d)", sendername, (int)myMovie.getWidth(), (int)myMovie.getHeight());
-			myFont.drawString(str, 20, 20);
-			sprintf_s(str, 256, "fps: %3.3d", (int)fps);
-			myFont.drawString(str, ofGetWidth() - 90, 20);
-		}
+	}
 
-		sprintf_s(str, 256, "Space - show controls : RH click - adjust dialog");
-		myFont.drawString(str, 20, 40);
-		sprintf_s(str, 256, "'f' fullscreen : 'i' hide info : Help menu for details");
-		myFont.drawString(str, 20, 60);
+	return bInitialized;
+}
 
+//--------------------------------------------------------------
+// The new frame is the same as the last one sent.
+//
+// The frame is hashed before the shaders change it. The output is
+// the same if the adjustments have not changed since (see Update).
+// The last output is copied back instead of running the shaders
+// again and the frame is not sent again.
+//
+// The hash shader is queued by HashFrame in Update and the fence
+// is polled without waiting before the frame is processed. If the
+// hash has not completed, the frame is processed and sent as usual
+// and the hash is read with the next frame to compare with it.
+void ofApp::HashFrame()
+{
+	// Hash of the last frame not ready when it was processed
+	if (bHashPending) {
+		uint64_t hash = 0;
+		bFrameHash = shaders.HashResult(hash);
+		if (bFrameHash)
+			frameHash = hash;
+		bHashPending = false;
 	}
 
+	// Frames are sent at a fixed rate by frame rate conversion
+	// and blended between new frames in slow motion. A deinterlaced
+	// frame is made with the next frame. Denoise output keeps changing
+	// for the same frame because the temporal history is updated.
+	if (!bSkipRepeated || bFrc || playSpeed < 1.0f || bDeinterlace || Denoise > 0.0f || !bInitialized
+		|| !shaders.Hash(myFbo.getTexture().getTextureData().textureID,
+			spoutsender->GetSenderWidth(), spoutsender->GetSenderHeight())) {
+		bFrameHash = false;
+		return;
+	}
+	bHashPending = true;
 }
 
-//--------------------------------------------------------------
-void ofApp::keyPressed(int key){
+bool ofApp::FrameRepeated()
+{
+	if (!bHashPending)
+		return false;
 
-	// Close volume dialog
-	CloseVolume();
+	// Not ready yet
+	uint64_t hash = 0;
+	if (!shaders.HashResult(hash))
+		return false;
+	bHashPending = false;
 
-	// Escape key exit has been disabled but it can still be checked here
-	if (key == VK_ESCAPE) {
-		// Disable fullscreen set, otherwise quit the application as usual
-		if (bFullscreen) {
-			bFullscreen = false;
-			doFullScreen(false);
-		}
-		else {
-			if (doMessageBox(NULL, "Escape exit - are you sure?", "Warning", MB_YESNO | MB_ICONWARNING) == IDYES) {
-				ofExit();
-			}
-		}
-	}
+	bool bRepeated = (bFrameHash && hash == frameHash);
+	frameHash = hash;
+	bFrameHash = true;
 
-	if (key == 'f' || key == 'F') {
-		bFullscreen = !bFullscreen;
-		doFullScreen(bFullscreen);
-		// Do not check this menu item because if there is no menu
-		// when you call the SetPopupItem function it will crash
-	}
+	return bRepeated;
+}
 
-	if (key == 'l' || key == 'L') {
-		if (bLoaded) {
-			bLoop = !bLoop;
-			menu->SetPopupItem("Loop", bLoop);
-		}
+// Keep the output of a hashed frame to copy back if it is repeated
+void ofApp::SaveRepeated()
+{
+	if (!bHashPending && !bFrameHash)
+		return;
+
+	unsigned int width  = (unsigned int)myFbo.getWidth();
+	unsigned int height = (unsigned int)myFbo.getHeight();
+	if ((unsigned int)repeatTexture.getWidth() != width
+		|| (unsigned int)repeatTexture.getHeight() != height)
+		repeatTexture.allocate(width, height, GL_RGBA8);
+	if (!shaders.Copy(myFbo.getTexture().getTextureData().textureID,
+		repeatTexture.getTextureData().textureID, width, height)) {
+		bFrameHash = false;
+		bHashPending = false;
 	}
+}
 
-	if (key == 'm' || key == 'M') {
-		if (bLoaded) {
-			bMute = !bMute;
-			if (bMute)
-				myMovie.setVolume(0.0f);
-			else
-				myMovie.setVolume(movieVolume);
-			menu->SetPopupItem("Mute", bMute);
+bool ofApp::RestoreRepeated()
+{
+	unsigned int width  = (unsigned int)myFbo.getWidth();
+	unsigned int height = (unsigned int)myFbo.getHeight();
+	if ((unsigned int)repeatTexture.getWidth() != width
+		|| (unsigned int)repeatTexture.getHeight() != height)
+		return false;
+	if (!shaders.Copy(repeatTexture.getTextureData().textureID,
+		myFbo.getTexture().getTextureData().textureID, width, height))
+		return false;
+	nRepeatedFrames++;
+	return true;
+}
+
+//--------------------------------------------------------------
+// Seamless loop
+//
+// The first frames of the movie are cached as they are decoded.
+// At the end of the movie the decoder seeks to the frame after
+// the cached frames and waits there while the cached frames
+// are played at the movie frame rate.
+// Returns true for the first cached frame (loop point).
+bool ofApp::UpdateLoop()
+{
+	if (bLoopPlay) {
+
+		// Cached frame playback is cancelled by pause
+		if (bPaused) {
+			CancelLoop();
+			return false;
 		}
-	}
 
-	if (key == ' ') {
-		if (bLoaded) {
-			bShowControls = !bShowControls;
-			menu->SetPopupItem("Controls", bShowControls);
-			if(!bShowControls && bFullscreen && hwndAdjust) {
-				// Close adjust dialog if open full screen
-				// It can be opened with mouse click when the controls are visible
-				SendMessageA(hwndAdjust, WM_DESTROY, 0, 0L);
-				hwndAdjust = NULL;
+		// The decoder has the frame after the cached frames
+		if (myMovie.isFrameNew())
+			bLoopSeek = true;
+		bNewFrame = false;
+
+		int frame = (int)floor(((double)ofGetElapsedTimeMicros() - loopStartTime) * (double)movieFps * (double)playSpeed / 1000000.0);
+		if (frame >= loopHead.GetFrames()) {
+			// Return to the movie when the decoder is ready
+			// or if it has not produced a frame after the seek
+			if (bLoopSeek || frame >= loopHead.GetFrames() * 2) {
+				bLoopPlay = false;
+				nLoopFrame = -1;
+				nLastFrame = loopHead.GetFrames();
+				myMovie.setPaused(false);
+				bNewFrame = bLoopSeek;
 			}
 		}
+		else if (frame > nLoopFrame) {
+			// Next cached frame
+			nLoopFrame = frame;
+			bNewFrame = loopHead.Restore(shaders, frame,
+				loopTexture.getTextureData().textureID);
+			return (bNewFrame && frame == 0);
+		}
+		return false;
 	}
 
-	if (key == 'i' || key == 'I') {
-		bShowInfo = !bShowInfo;
-		menu->SetPopupItem("Info", bShowInfo);
+	// Compute shaders are available after the sender is created
+	if (!bNewFrame || !bInitialized)
+		return false;
+
+	// Cache the first frames on the first pass
+	int frame = myMovie.getCurrentFrame();
+	loopHead.Capture(shaders, frame, myMovie.getTexture().getTextureData().textureID,
+		bNDIout ? &myMovie.getPixels() : nullptr);
+
+	// Loop point if seeking to the start
+	bool bLoopPoint = (frame < nLastFrame);
+	nLastFrame = frame;
+
+	// End of the movie
+	if (!bPaused && frame >= myMovie.getTotalNumFrames() - 2) {
+		if (loopHead.IsComplete()) {
+			// Seek past the cached frames and wait there.
+			// The first cached frame follows the last frame
+			// after one frame interval.
+			myMovie.setFrame(loopHead.GetFrames());
+			myMovie.setPaused(true);
+			bLoopSeek = false;
+			bLoopPlay = true;
+			nLoopFrame = -1;
+			loopStartTime = (double)ofGetElapsedTimeMicros() + 1000000.0 / ((double)movieFps*(double)playSpeed);
+		}
+		else {
+			// Seek to the start until all the frames are cached
+			myMovie.setFrame(0);
+		}
 	}
 
-	if (key == 'p' || key == 'P') {
-		bPaused = !bPaused;
-		if (bLoaded)
+	return bLoopPoint;
+}
+
+//--------------------------------------------------------------
+// Stop playing cached frames and return to the movie
+void ofApp::CancelLoop()
+{
+	if (bLoopPlay) {
+		bLoopPlay = false;
+		nLoopFrame = -1;
+		if (myMovie.isLoaded())
 			myMovie.setPaused(bPaused);
 	}
+}
 
-	if (key == 'r' || key == 'R') {
-		if (bLoaded) {
-			bResizeWindow = !bResizeWindow;
-			ResetWindow(true);
-			menu->SetPopupItem("Resize", bResizeWindow);
-		}
-	}
+//--------------------------------------------------------------
+// Memory cache
+//
+// Decoded frames are copied to memory on the first pass.
+// When all the frames are cached, the decoder is paused
+// and the frames are played from memory at the movie frame rate.
+// A raw movie or image sequence is played in the same way.
+// At fast speeds, frames between those shown are not loaded.
+void ofApp::UpdateClip()
+{
+	double period = 1000000.0 / ((double)movieFps*(double)playSpeed);
+	double now = (double)ofGetElapsedTimeMicros();
 
-	// Stop and close movie
-	if (key == 's' || key == 'S') {
-		CloseMovie();
-	}
+	if (bClipPlay) {
 
-	// Go to the start of the movie
-	if (key == OF_KEY_HOME) {
-		if (bLoaded) {
-			myMovie.setPosition(0.0f);
-			bPaused = false;
-			myMovie.play();
+		bNewFrame = false;
+
+		// A still image is processed and sent only when it changes
+		if (clipSource == &still) {
+			UpdateStill();
+			return;
 		}
-	}
+
+		// Show a frame selected before it was decoded
+		if (nClipSeek >= 0 && LoadClipFrame(nClipSeek)) {
+			nClipSeek = -1;
+			bNewFrame = true;
+		}
+
+		// Hold the current frame while paused
+		if (bPaused || bClipHold) {
+			clipStartTime = now - (double)nClipFrame*period;
+			return;
+		}
+
+		int nFrames = clipSource->GetFrames();
+		int frame = (int)floor((now - clipStartTime) / period);
+		if (frame >= nFrames) {
+			if (bLoop) {
+				// Loop without a seek
+				while (frame >= nFrames) {
+					clipStartTime += (double)nFrames*period;
+					frame -= nFrames;
+				}
+				nClipFrame = -1;
+			}
+			else {
+				// Pause at the start as for the movie
+				SetClipFrame(0);
+				bPaused = true;
+				return;
+			}
+		}
+
+		if (frame > nClipFrame) {
+			if (LoadClipFrame(frame)) {
+				nClipFrame = frame;
+				bNewFrame = true;
+			}
+			else {
+				// The frame is not decoded yet.
+				// Wait for it rather than run ahead of the decoder.
+				clipStartTime = now - (double)frame*period;
+			}
+		}
+		return;
+	}
+
+	// Cache the decoded frames
+	int frame = myMovie.getCurrentFrame();
+	if (bNewFrame)
+		clips.Add(frame, myMovie.getPixels());
+
+	// Play from memory when all the frames are cached.
+	// A cached movie plays from memory as soon as it is opened.
+	if (clips.IsComplete() && !bPaused) {
+		CancelLoop();
+		myMovie.setPaused(true);
+		clipTexture.allocate((int)movieWidth, (int)movieHeight, GL_RGBA8);
+		clipSource = &clips;
+		bClipPlay = true;
+		bClipHold = false;
+		nClipFrame = frame;
+		if (nClipFrame < 0) nClipFrame = 0;
+		if (nClipFrame >= clips.GetFrames()) nClipFrame = clips.GetFrames()-1;
+		LoadClipFrame(nClipFrame);
+		clipStartTime = now - (double)nClipFrame*period;
+		SpoutLogNotice("ofApp::UpdateClip - playing %s from memory", movieFile.c_str());
+	}
+}
+
+//--------------------------------------------------------------
+// Still image
+//
+// The image is uploaded and processed only if the file changes.
+// Adjustment changes are processed from the original frame
+// as for a paused movie (see Update).
+void ofApp::UpdateStill()
+{
+	// Reload an image that has been modified
+	if (still.CheckFile()) {
+		if (still.GetFrameWidth() != (int)movieWidth || still.GetFrameHeight() != (int)movieHeight) {
+			// Open again for the new size
+			bLoaded = OpenMovieFile(movieFile);
+			return;
+		}
+		bStillDirty = true;
+	}
+
+	// Until sent (see Draw)
+	if (bStillDirty && LoadClipFrame(0)) {
+		nClipFrame = 0;
+		bNewFrame = true;
+	}
+}
+
+//--------------------------------------------------------------
+// Adjustment values have changed since the last call
+bool ofApp::AdjustChanged()
+{
+	float adjust[ADJUST_VALUES] = { Brightness, Contrast, Saturation, Gamma,
+		Blur, Denoise, Sharpness, Sharpwidth, (float)bAdaptive,
+		(float)bFlip, (float)bMirror, (float)bSwap, (float)bAutoLevels,
+		bEffects ? (float)effects.GetVersion() : -1.0f, (float)automation.GetVersion() };
+	bool bSettings = !bLastAdjust
+		|| memcmp(adjust, lastAdjust, ADJUST_SETTINGS*sizeof(float)) != 0;
+
+	// Keyframe values at the frame shown, so that a repeated or
+	// paused frame is processed and sent again as they change.
+	// Evaluated once for each frame or if the settings change.
+	if (automation.IsLoaded() && movieFps > 0.0f) {
+		int frame = bClipPlay ? nClipFrame : (bLoopPlay ? nLoopFrame : myMovie.getCurrentFrame());
+		if (frame != keyFrame || bSettings) {
+			float values[keyframes::KEY_PARAMS] = { Brightness, Contrast, Saturation, Gamma, Blur, Sharpness };
+			automation.Evaluate((double)frame / (double)movieFps, values);
+			memcpy(keyValues, values, sizeof(keyValues));
+			keyFrame = frame;
+		}
+		memcpy(&adjust[ADJUST_SETTINGS], keyValues, sizeof(keyValues));
+	}
+
+	// Auto levels to the nearest 0.002 so that a frame that
+	// does not change is not processed again as they settle
+	if (bAutoLevels) {
+		float* level = &adjust[ADJUST_SETTINGS + keyframes::KEY_PARAMS];
+		level[0] = roundf(levels.GetBrightness()*500.0f);
+		level[1] = roundf(levels.GetContrast()*500.0f);
+		level[2] = roundf(levels.GetGamma()*500.0f);
+	}
+
+	if (!bSettings && memcmp(adjust, lastAdjust, sizeof(adjust)) == 0)
+		return false;
+	memcpy(lastAdjust, adjust, sizeof(adjust));
+	bLastAdjust = true;
+	return true;
+}
+
+//--------------------------------------------------------------
+// Show a frame played from memory
+void ofApp::SetClipFrame(int frame)
+{
+	if (!bClipPlay)
+		return;
+
+	if (frame < 0) frame = 0;
+	if (frame >= clipSource->GetFrames()) frame = clipSource->GetFrames()-1;
+
+	// A frame that is not decoded yet is shown by UpdateClip
+	nClipFrame = frame;
+	clipStartTime = (double)ofGetElapsedTimeMicros() - (double)frame*1000000.0/((double)movieFps*(double)playSpeed);
+	if (LoadClipFrame(frame)) {
+		nClipSeek = -1;
+		bNewFrame = true;
+	}
+	else {
+		nClipSeek = frame;
+	}
+}
+
+//--------------------------------------------------------------
+// Upload a frame played from memory or from a raw movie.
+// The pixels are uploaded directly from the source without a copy.
+bool ofApp::LoadClipFrame(int frame)
+{
+	const unsigned char* data = clipSource->GetFrameData(frame);
+	if (!data) {
+		// Start decoding from this frame
+		clipSource->Prefetch(frame);
+		return false;
+	}
+
+	int width = clipSource->GetFrameWidth();
+	int height = clipSource->GetFrameHeight();
+	if (clipSource->GetFrameFormat() == frameSource::FRAME_NV12) {
+		// Native planes are uploaded as they are, 4 bytes to a texel,
+		// and converted on the GPU. Compute shaders are available
+		// when the sender has been created and the first frame is
+		// loaded again then (see Draw).
+		if ((int)yuvTexture.getWidth() != width/4 || (int)yuvTexture.getHeight() != height*3/2)
+			yuvTexture.allocate(width/4, height*3/2, GL_RGBA8);
+		yuvTexture.loadData(data, width/4, height*3/2, GL_RGBA);
+		if (bInitialized)
+			shaders.YuvToRgba(yuvTexture.getTextureData().textureID,
+				clipTexture.getTextureData().textureID,
+				(unsigned int)width, (unsigned int)height, GetYuvMatrix(), bYuvFullRange);
+	}
+	else {
+		clipTexture.loadData(data, width, height, GL_RGBA);
+	}
+
+	// Read the next frame shown in the background
+	clipSource->Prefetch(frame + nPlayStep);
+
+	return true;
+}
+
+//--------------------------------------------------------------
+// Return to the decoder at the current frame
+// A raw movie has no decoder and continues
+void ofApp::StopClip()
+{
+	if (bClipPlay && clipSource == &clips) {
+		bClipPlay = false;
+		bClipHold = false;
+		if (myMovie.isLoaded()) {
+			myMovie.setFrame(nClipFrame);
+			myMovie.setPaused(bPaused);
+		}
+		clipTexture.clear();
+	}
+}
+
+//--------------------------------------------------------------
+// Pause or resume the decoder or the frames played from memory
+void ofApp::PauseMovie(bool bPause)
+{
+	if (bClipPlay)
+		bClipHold = bPause;
+	else
+		myMovie.setPaused(bPause);
+}
+
+//--------------------------------------------------------------
+// Movie position 0 - 1
+float ofApp::GetMoviePosition()
+{
+	if (bClipPlay && clipSource->GetFrames() > 0)
+		return (float)nClipFrame/(float)clipSource->GetFrames();
+	return myMovie.getPosition();
+}
+
+//--------------------------------------------------------------
+// Set the movie loop state and the seamless loop cache
+void ofApp::SetLoopState()
+{
+	CancelLoop();
+
+	if (bLoop && bSeamless) {
+		// The end of the movie is handled by UpdateLoop
+		myMovie.setLoopState(OF_LOOP_NONE);
+		// Allocate the cache for the movie size
+		if (movieWidth > 0 && movieHeight > 0 && loopHead.GetFrames() == 0) {
+			loopHead.Allocate(nLoopFrames, movieWidth, movieHeight);
+			loopTexture.allocate((int)movieWidth, (int)movieHeight, GL_RGBA8);
+		}
+	}
+	else {
+		if (bLoop)
+			myMovie.setLoopState(OF_LOOP_NORMAL);
+		else
+			myMovie.setLoopState(OF_LOOP_NONE);
+		// Release the video memory of the cache
+		loopHead.Release();
+		loopTexture.clear();
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::draw() {
+
+	// Draw cycle CPU and GPU time
+	uint64_t drawStart = 0;
+	if (bDrawBench) {
+		drawStart = ofGetElapsedTimeMicros();
+		BeginDrawTiming();
+	}
+
+	// Headless mode has no preview, scopes, controls or information.
+	// Frames processed by update are only sent.
+	if (bHeadless) {
+		if (bLoaded && !bSplash)
+			SendFrames();
+	}
+	else {
+		DrawWindow();
+	}
+
+	if (bDrawBench)
+		EndDrawTiming(drawStart);
+
+}
+
+//--------------------------------------------------------------
+void ofApp::DrawWindow() {
+
+	char str[256]{};
+	ofSetColor(255);
+	ofBackground(0);
+
+	// Continue play if paused by menu selection
+	// or mouse click outside the client area
+	if (bNCmousePressed) {
+		if (bLoaded)
+			PauseMovie(false);
+		bNCmousePressed = false;
+	}
+
+	// Nothing is seen while the window is minimized
+	if (IsIconic(hWnd)) {
+		if (bLoaded && !bSplash)
+			SendFrames();
+		return;
+	}
+
+	if (bSplash || !bLoaded) {
+		assets.DrawSplash(0, 0, (float)ofGetWidth(), (float)ofGetHeight());
+		return;
+	}
+
+	// Draw the movie frame sized to the aspect ratio of the movie
+	float drawWidth = ofGetHeight()*movieWidth/movieHeight;
+	float leftx = (ofGetWidth()-drawWidth)/2.0f;
+	DrawPreview(leftx, drawWidth);
+
+	// Scopes of the processed frame
+	if (bScopes && bInitialized && bNewFrame)
+		scopes.Update(shaders, myFbo.getTexture().getTextureData().textureID,
+			(unsigned int)myFbo.getWidth(), (unsigned int)myFbo.getHeight());
+
+	// Spout and NDI
+	SendFrames();
+
+	// Scopes overlay at the bottom right, above the controls
+	if (bScopes && bLoaded && !bSplash) {
+		float scopeWidth = (float)ofGetWidth()/2.0f;
+		float scopeHeight = scopeWidth/3.0f;
+		float scopeBottom = (float)ofGetHeight();
+		if (bShowControls)
+			scopeBottom -= controlbar_height;
+		scopes.Draw((float)ofGetWidth() - scopeWidth - 10.0f,
+			scopeBottom - scopeHeight - 10.0f, scopeWidth, scopeHeight);
+	}
+
+	// 'Space" to show or hide controls
+	drawPlayBar();
+
+	// Information is formatted at a fixed rate
+	// and drawn from the cached lines in between
+	ofSetColor(255);
+	if (bLoaded && !bFullscreen && bShowInfo)
+		LoadFont();
+	if (bLoaded && !bFullscreen && bShowInfo && infoText.Begin()) {
+
+		if (spoutsender->IsInitialized()) {
+			sprintf_s(str, 256, "Sending as : [%s] (%dx%d)", sendername, (int)movieWidth, (int)movieHeight);
+			infoText.Add(str, 20, 20);
+			sprintf_s(str, 256, "fps: %3.3d", (int)fps);
+			infoText.Add(str, ofGetWidth() - 90, 20);
+		}
+
+		sprintf_s(str, 256, "Space - show controls : RH click - adjust dialog");
+		infoText.Add(str, 20, 40);
+		sprintf_s(str, 256, "'f' fullscreen : 'i' hide info : Help menu for details");
+		infoText.Add(str, 20, 60);
+
+		// Loop point timing
+		if (bLoop) {
+			sprintf_s(str, 256, "Loop jitter : %.2f msec (max %.2f msec)",
+				loopHead.GetJitter(), loopHead.GetMaxJitter());
+			infoText.Add(str, 20, 80);
+		}
+
+		// Memory cache size and CPU per frame
+		if (bMemoryCache) {
+			sprintf_s(str, 256, "Memory cache : %d MB (%d clips) : CPU/frame decoded %.2f cached %.2f msec : saved %.1f sec",
+				(int)(clips.GetBytes()/(1024*1024)), clips.GetClips(),
+				clips.GetDecodeCpu(), clips.GetCachedCpu(), clips.GetSavedCpu()/1000.0);
+			infoText.Add(str, 20, 100);
+		}
+
+		// Image sequence decoder
+		if (bClipPlay && clipSource == &sequence) {
+			sprintf_s(str, 256, "Image sequence : %d frames at %.2f fps : %d threads : %d frames decoded ahead",
+				sequence.GetFrames(), sequence.GetFrameRate(), sequence.GetThreads(), sequence.GetReady());
+			infoText.Add(str, 20, 120);
+		}
+
+		// Frames not sent
+		if (bSkipRepeated && nNewFrames > 0) {
+			sprintf_s(str, 256, "Repeated frames : %d of %d (%.1f%%)",
+				nRepeatedFrames, nNewFrames, 100.0*(double)nRepeatedFrames/(double)nNewFrames);
+			infoText.Add(str, 20, 140);
+		}
+
+		// Frame rate conversion
+		if (bFrc) {
+			sprintf_s(str, 256, "Output : %.2f fps %s : cadence %s : frame %lld at %.3f sec : dropped %d : GPU repeat %.2f blend %.2f motion %.2f msec",
+				frc.GetRate(), rateConverter::GetMethodName(frc.GetMethod()), frc.GetCadence().c_str(),
+				frc.GetFrameNumber(), frc.GetTimestamp(), frc.GetDropped(),
+				frc.GetGpuTime(rateConverter::FRC_REPEAT), frc.GetGpuTime(rateConverter::FRC_BLEND),
+				frc.GetGpuTime(rateConverter::FRC_MOTION));
+			infoText.Add(str, 20, 160);
+		}
+
+		// Variable speed
+		if (playSpeed != 1.0f) {
+			sprintf_s(str, 256, "Speed : x%.2f : %s : frames shown %d skipped %d",
+				playSpeed, (playSpeed < 1.0f) ? "blended" : "skipping",
+				nShownFrames, nSkippedFrames);
+			infoText.Add(str, 20, 180);
+		}
+
+		// Deinterlace
+		if (bDeinterlace) {
+			sprintf_s(str, 256, "Deinterlace : %s : %s field first",
+				deinterlacer::GetModeName(deint.GetMode()), bBottomFirst ? "bottom" : "top");
+			infoText.Add(str, 20, 200);
+		}
+
+		// Nv12 conversion
+		if (bClipPlay && clipSource->GetFrameFormat() == frameSource::FRAME_NV12) {
+			const char* matrices[] = { "BT.601", "BT.709", "BT.2020" };
+			sprintf_s(str, 256, "YUV 4:2:0 : %s%s : %s range", matrices[GetYuvMatrix()],
+				(yuvMatrix == 0) ? " (auto)" : "", bYuvFullRange ? "full" : "limited");
+			infoText.Add(str, 20, 220);
+		}
+
+		// Auto levels
+		if (bAutoLevels) {
+			sprintf_s(str, 256, "Auto levels : %.2f - %.2f mean %.2f : brightness %.2f contrast %.2f gamma %.2f",
+				levels.GetMin(), levels.GetMax(), levels.GetMean(),
+				levels.GetBrightness(), levels.GetContrast(), levels.GetGamma());
+			infoText.Add(str, 20, 260);
+		}
+
+		// Keyframes
+		if (automation.IsLoaded()) {
+			sprintf_s(str, 256, "Keyframes : %d", automation.GetKeys());
+			infoText.Add(str, 20, 300);
+		}
+
+		// User effects
+		if (bEffects) {
+			sprintf_s(str, 256, "Effects : %s", effects.GetStatus().c_str());
+			infoText.Add(str, 20, 280);
+		}
+
+		// Scopes cost
+		if (bScopes) {
+			sprintf_s(str, 256, "Scopes : 1 in %d : GPU %.3f msec",
+				scopes.GetStep(), scopes.GetGpuTime());
+			infoText.Add(str, 20, 240);
+		}
+
+		infoText.End();
+	}
+	if (bLoaded && !bFullscreen && bShowInfo)
+		infoText.Draw();
+
+}
+
+//--------------------------------------------------------------
+// Draw the processed frame in the window.
+// At reduced rate or half size, a copy is made from a new frame
+// and drawn until the next, so that a large movie is not read
+// for each draw cycle.
+void ofApp::DrawPreview(float x, float width)
+{
+	float height = (float)ofGetHeight();
+
+	if (!bPreview) {
+		LoadFont();
+		const char* msg = "Preview off";
+		myFont.drawString(msg, ((float)ofGetWidth() - myFont.stringWidth(msg))/2.0f, height/2.0f);
+		return;
+	}
+
+	if (!bPreviewRate && !bPreviewHalfSize) {
+		myFbo.draw(x, 0, width, height);
+		return;
+	}
+
+	int w = (int)width;
+	int h = (int)height;
+	if (bPreviewHalfSize) {
+		w /= 2;
+		h /= 2;
+	}
+	if (w < 1 || h < 1)
+		return;
+
+	if (!previewFbo.isAllocated() || (int)previewFbo.getWidth() != w || (int)previewFbo.getHeight() != h) {
+		previewFbo.allocate(w, h, GL_RGBA);
+		bPreviewDirty = true;
+	}
+
+	// Frames changed while paused are always shown
+	if (bNewFrame) {
+		if (!bPreviewRate || bPaused || previewFrames % previewInterval == 0)
+			bPreviewDirty = true;
+		previewFrames++;
+	}
+
+	if (bPreviewDirty) {
+		previewFbo.begin();
+		myFbo.draw(0, 0, (float)w, (float)h);
+		previewFbo.end();
+		bPreviewDirty = false;
+	}
+
+	previewFbo.draw(x, 0, width, height);
+}
+
+//--------------------------------------------------------------
+// Send the processed frame to Spout and NDI receivers
+void ofApp::SendFrames() {
+
+	if (bNewFrame && !bRepeatedFrame) {
+
+		// The frame is not sent while the senders are created
+		bool bSent = true;
+
+		//
+		// Spout
+		//
+		if (bSpoutOut) {
+			// If not initialized, create a Spout sender the same size as the movie
+			// (sendername is initialized by movie load)
+			if (!bInitialized) {
+				bInitialized = spoutsender->CreateSender(sendername,
+					(unsigned int)myFbo.getWidth(), (unsigned int)myFbo.getHeight());
+				bSent = false;
+				// Convert the first nv12 frame now that shaders are available
+				if (bInitialized && bClipPlay && nClipFrame >= 0
+					&& clipSource->GetFrameFormat() == frameSource::FRAME_NV12)
+					nClipSeek = nClipFrame;
+			}
+			else if (!bFrc) {
+				// Receivers will detect the movie frame rate
+				spoutsender->SendTexture(myFbo.getTexture().getTextureData().textureID,
+					myFbo.getTexture().getTextureData().textureTarget,
+					(unsigned int)myFbo.getWidth(), (unsigned int)myFbo.getHeight(), false);
+			}
+		}
+
+		//
+		// NDI
+		//
+		if (bNDIout) {
+			if (!bNDIinitialized) {
+				bNDIinitialized = NDIsender.CreateSender(sendername,
+					(unsigned int)movieWidth, (unsigned int)movieHeight);
+				bSent = false;
+			}
+			else if (!bFrc) {
+				SendNDIframe();
+			}
+		}
+
+		// Time from the start of the process to the first frame sent
+		if (bSent && !bFirstSent && (bInitialized || bNDIinitialized)) {
+			SpoutLogNotice("ofApp::SendFrames - first frame sent %.1f msec from the start",
+				GetProcessTime());
+			bFirstSent = true;
+		}
+
+		// A still image is not sent again until it changes
+		// and the next frame is compared with one that was sent
+		if (bSent) {
+			bStillDirty = false;
+		}
+		else {
+			bFrameHash = false;
+			bHashPending = false;
+		}
+
+	} // endif new frame
+	else {
+		// A repeated still image has been sent
+		if (bRepeatedFrame)
+			bStillDirty = false;
+
+		// Processed frame read back since the last new frame
+		if (bNDIout && bNDIinitialized && !bFrc)
+			SendNDIreadback();
+
+		// Keep NDI receivers connected at a low rate while a still
+		// image, repeated frames or the opening thumbnail are unchanged.
+		if (bNDIout && bNDIinitialized && stillNdiRate > 0.0f && !bFrc
+			&& (bRepeatedFrame || bOpening || (bClipPlay && clipSource == &still))) {
+			if (ofGetElapsedTimef() - ndiSendTime >= 1.0f/stillNdiRate)
+				SendNDIframe();
+		}
+	}
+
+	// Frames at the fixed output rate
+	if (bFrc && bInitialized && frc.Update(shaders))
+		SendFrcFrame();
+
+}
+
+//--------------------------------------------------------------
+// GPU time stamps of a draw cycle are read a cycle later
+// if they are available and are discarded if not.
+// Time stamps rather than elapsed time queries so that
+// they can contain the queries of the scopes and rate converter.
+void ofApp::BeginDrawTiming()
+{
+	if (!drawQuery[0])
+		glGenQueries(4, drawQuery);
+
+	drawSlot = 1 - drawSlot;
+	if (bDrawQuery[drawSlot]) {
+		GLint available = 0;
+		glGetQueryObjectiv(drawQuery[drawSlot*2+1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available) {
+			GLuint64 t0 = 0;
+			GLuint64 t1 = 0;
+			glGetQueryObjectui64v(drawQuery[drawSlot*2], GL_QUERY_RESULT, &t0);
+			glGetQueryObjectui64v(drawQuery[drawSlot*2+1], GL_QUERY_RESULT, &t1);
+			if (t1 > t0) {
+				drawGpuTime += (double)(t1 - t0)/1000000.0; // nanoseconds to msec
+				drawGpuCycles++;
+			}
+		}
+		bDrawQuery[drawSlot] = false;
+	}
+	glQueryCounter(drawQuery[drawSlot*2], GL_TIMESTAMP);
+}
+
+//--------------------------------------------------------------
+// Average times are logged every 10 seconds
+void ofApp::EndDrawTiming(uint64_t startMicros)
+{
+	glQueryCounter(drawQuery[drawSlot*2+1], GL_TIMESTAMP);
+	bDrawQuery[drawSlot] = true;
+
+	drawCpuTime += (double)(ofGetElapsedTimeMicros() - startMicros)/1000.0;
+	drawCycles++;
+
+	double now = ofGetElapsedTimef();
+	if (now - drawLogTime >= 10.0) {
+		SpoutLogNotice("ofApp::draw - %s %d cycles, CPU %.3f msec, GPU %.3f msec per cycle",
+			bHeadless ? "headless" : "window", drawCycles,
+			drawCpuTime/(double)drawCycles,
+			drawGpuCycles > 0 ? drawGpuTime/(double)drawGpuCycles : 0.0);
+		drawCycles = 0;
+		drawCpuTime = 0.0;
+		drawGpuTime = 0.0;
+		drawGpuCycles = 0;
+		drawLogTime = now;
+	}
+}
+
+//--------------------------------------------------------------
+// Send the frame rate converted output.
+// Receivers are clocked by the output rate.
+void ofApp::SendFrcFrame()
+{
+	ofTexture &tex = frc.GetTexture();
+
+	if (bSpoutOut && bInitialized) {
+		spoutsender->SendTexture(tex.getTextureData().textureID,
+			tex.getTextureData().textureTarget,
+			(unsigned int)tex.getWidth(), (unsigned int)tex.getHeight(), false);
+	}
+
+	// Read back without waiting and send the latest completed frame
+	if (bNDIout && bNDIinitialized) {
+		ndiReadback.Read(tex);
+		SendNDIreadback();
+	}
+}
+
+//--------------------------------------------------------------
+// Frame rate conversion method menu items
+void ofApp::SetFrcMethod(int method)
+{
+	frcMethod = method;
+	frc.SetMethod(frcMethod);
+	menu->SetPopupItem("    Repeat", frcMethod == rateConverter::FRC_REPEAT);
+	menu->SetPopupItem("    Blend",  frcMethod == rateConverter::FRC_BLEND);
+	menu->SetPopupItem("    Motion", frcMethod == rateConverter::FRC_MOTION);
+}
+
+//--------------------------------------------------------------
+// Variable speed playback 0.1 - 8 times the movie rate
+//
+// The movie decoder plays at the speed and drops frames that
+// are late at fast speeds. Frames played by the application are
+// timed for the speed and only the frames shown are read or
+// decoded. Slow motion frames are blended from the frames either
+// side (see Update). Audio is muted at speeds other than normal.
+void ofApp::SetSpeed(float speed)
+{
+	if (speed < 0.1f) speed = 0.1f;
+	if (speed > 8.0f) speed = 8.0f;
+
+	// Continue from the frame being shown
+	if (bClipPlay && nClipFrame >= 0) {
+		double now = (double)ofGetElapsedTimeMicros();
+		clipStartTime = now - (double)nClipFrame*1000000.0/((double)movieFps*(double)speed);
+	}
+	playSpeed = speed;
+	syncRate = 1.0;
+
+	if (myMovie.isLoaded() && !bClipPlay) {
+		myMovie.setSpeed(playSpeed);
+		if (playSpeed == 1.0f)
+			myMovie.setVolume(bMute ? 0.0f : movieVolume);
+		else
+			myMovie.setVolume(0.0f);
+	}
+
+	// Frames shown by each draw cycle
+	double drawRate = (double)ofGetFrameRate();
+	if (drawRate < 1.0)
+		drawRate = 60.0;
+	nPlayStep = (int)((double)movieFps*(double)playSpeed / drawRate);
+	if (nPlayStep < 1)
+		nPlayStep = 1;
+	clipSource->SetStep(nPlayStep);
+
+	// Source frame rate for blending
+	frc.SetSourceRate(GetSourceRate());
+	if (playSpeed < 1.0f)
+		slowMotion.Start(GetSourceRate());
+
+	nShownFrames = 0;
+	nSkippedFrames = 0;
+	nLastShown = -1;
+}
+
+//--------------------------------------------------------------
+// Processed frame to the rate converters
+void ofApp::AddSourceFrame()
+{
+	if (!bInitialized)
+		return;
+
+	// Source frame for the fixed output rate (see Draw)
+	if (bFrc) {
+		frc.AddFrame(shaders, myFbo.getTexture().getTextureData().textureID,
+			spoutsender->GetSenderWidth(), spoutsender->GetSenderHeight());
+	}
+
+	// Source frame for slow motion
+	if (playSpeed < 1.0f && !bFrc) {
+		slowMotion.AddFrame(shaders, myFbo.getTexture().getTextureData().textureID,
+			spoutsender->GetSenderWidth(), spoutsender->GetSenderHeight());
+	}
+}
+
+//--------------------------------------------------------------
+// Frames per second processed, allowing for the
+// playback speed and double rate deinterlace
+double ofApp::GetSourceRate()
+{
+	double rate = (double)movieFps*(double)playSpeed;
+	if (bDeinterlace && bDoubleRate)
+		rate *= 2.0;
+	return rate;
+}
+
+//--------------------------------------------------------------
+// YUV matrix for nv12 frames from the menu.
+// 0 auto, 1 BT.601, 2 BT.709, 3 BT.2020
+// The frame being shown is converted again.
+void ofApp::SetYuvMatrix(int matrix)
+{
+	if (matrix < 0 || matrix > 3)
+		matrix = 0;
+	yuvMatrix = matrix;
+
+	int shown = GetYuvMatrix();
+	menu->SetPopupItem("YUV matrix auto", yuvMatrix == 0);
+	menu->SetPopupItem("    BT.601", shown == 0);
+	menu->SetPopupItem("    BT.709", shown == 1);
+	menu->SetPopupItem("    BT.2020", shown == 2);
+	menu->EnablePopupItem("    BT.601", yuvMatrix != 0);
+	menu->EnablePopupItem("    BT.709", yuvMatrix != 0);
+	menu->EnablePopupItem("    BT.2020", yuvMatrix != 0);
+	menu->SetPopupItem("YUV full range", bYuvFullRange);
+
+	if (bClipPlay && nClipFrame >= 0 && clipSource->GetFrameFormat() == frameSource::FRAME_NV12)
+		nClipSeek = nClipFrame;
+}
+
+//--------------------------------------------------------------
+// Matrix for the conversion shader, 0 BT.601, 1 BT.709, 2 BT.2020
+// Auto is BT.709 for HD and larger and BT.601 for SD.
+int ofApp::GetYuvMatrix()
+{
+	if (yuvMatrix == 0)
+		return (movieHeight >= 720.0f) ? 1 : 0;
+	return yuvMatrix - 1;
+}
+
+//--------------------------------------------------------------
+// Deinterlace mode and field order from the menu.
+// The rate converters follow the rate for double rate.
+void ofApp::SetDeinterlace()
+{
+	if (!bDeinterlace)
+		deint.SetMode(deinterlacer::DEINT_OFF);
+	else if (bDoubleRate)
+		deint.SetMode(deinterlacer::DEINT_DOUBLE);
+	else
+		deint.SetMode(deinterlacer::DEINT_SINGLE);
+	deint.SetTopFirst(!bBottomFirst);
+	if (!bDeinterlace)
+		deint.Release();
+
+	menu->SetPopupItem("Deinterlace", bDeinterlace);
+	menu->SetPopupItem("    Double rate", bDoubleRate);
+	menu->SetPopupItem("    Bottom field first", bBottomFirst);
+	menu->EnablePopupItem("    Double rate", bDeinterlace);
+	menu->EnablePopupItem("    Bottom field first", bDeinterlace);
+
+	frc.SetSourceRate(GetSourceRate());
+	if (playSpeed < 1.0f)
+		slowMotion.Start(GetSourceRate());
+	bFrameHash = false;
+}
+
+//--------------------------------------------------------------
+// Frames passed over since the last frame shown.
+// A jump of more than a second at the current speed is a seek.
+void ofApp::CountSkipped(int frame)
+{
+	int jump = frame - nLastShown;
+	if (nLastShown >= 0 && jump > 1 && (double)jump <= (double)movieFps*(double)playSpeed)
+		nSkippedFrames += jump - 1;
+	nLastShown = frame;
+	nShownFrames++;
+}
+
+//--------------------------------------------------------------
+// Send the pixels of the frame being played
+// NDI format set to RGBX will produce alpha = 255
+void ofApp::SendNDIframe()
+{
+	// Deinterlaced, blended slow motion and denoised frames and the
+	// thumbnail shown while the decoder opens exist only in the fbo.
+	// They are read back without waiting and sent when the copy has
+	// completed (see SendFrames).
+	if (bOpening || bDeinterlace || Denoise > 0.0f || (playSpeed < 1.0f && !bFrc)) {
+		ndiReadback.Read(myFbo.getTexture());
+		SendNDIreadback();
+		return;
+	}
+
+	if (bClipPlay) {
+		// Frame played from memory, a raw movie or images
+		const unsigned char* data = clipSource->GetFrameData(nClipFrame);
+		if (data && clipSource->GetFrameFormat() == frameSource::FRAME_NV12) {
+			// Frame converted by shader, read back without waiting
+			ndiReadback.Read(clipTexture);
+			SendNDIreadback();
+			return;
+		}
+		else if (data)
+			NDIsender.SendImage(data,
+				(unsigned int)clipSource->GetFrameWidth(), (unsigned int)clipSource->GetFrameHeight());
+	}
+	else if (bLoopPlay) {
+		// Cached frame for a seamless loop. The decoded pixels are
+		// kept with NDI output, otherwise the frame is read back.
+		const ofPixels *pixels = loopHead.GetPixels(nLoopFrame);
+		if (pixels) {
+			NDIsender.SendImage(pixels->getData(),
+				(unsigned int)pixels->getWidth(), (unsigned int)pixels->getHeight());
+		}
+		else {
+			ndiReadback.Read(loopTexture);
+			SendNDIreadback();
+			return;
+		}
+	}
+	else {
+		NDIsender.SendImage(myMovie.getPixels().getData(),
+			(unsigned int)myMovie.getWidth(), (unsigned int)myMovie.getHeight());
+	}
+	ndiSendTime = ofGetElapsedTimef();
+}
+
+//--------------------------------------------------------------
+// Send the latest fbo frame read back for NDI
+void ofApp::SendNDIreadback()
+{
+	if (ndiReadback.Update(ndiPixels)) {
+		NDIsender.SendImage(ndiPixels.getData(),
+			(unsigned int)ndiPixels.getWidth(), (unsigned int)ndiPixels.getHeight());
+		ndiSendTime = ofGetElapsedTimef();
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+
+	// Close volume dialog
+	CloseVolume();
+
+	// Escape key exit has been disabled but it can still be checked here
+	if (key == VK_ESCAPE) {
+		// Disable fullscreen set, otherwise quit the application as usual
+		if (bFullscreen) {
+			bFullscreen = false;
+			doFullScreen(false);
+		}
+		else {
+			if (doMessageBox(NULL, "Escape exit - are you sure?", "Warning", MB_YESNO | MB_ICONWARNING) == IDYES) {
+				ofExit();
+			}
+		}
+	}
+
+	if (key == 'f' || key == 'F') {
+		bFullscreen = !bFullscreen;
+		doFullScreen(bFullscreen);
+		// Do not check this menu item because if there is no menu
+		// when you call the SetPopupItem function it will crash
+	}
+
+	if (key == 'l' || key == 'L') {
+		if (bLoaded) {
+			bLoop = !bLoop;
+			menu->SetPopupItem("Loop", bLoop);
+			menu->EnablePopupItem("    Seamless", bLoop);
+			SetLoopState();
+		}
+	}
+
+	if (key == 'm' || key == 'M') {
+		if (bLoaded) {
+			bMute = !bMute;
+			if (bMute)
+				myMovie.setVolume(0.0f);
+			else
+				myMovie.setVolume(movieVolume);
+			menu->SetPopupItem("Mute", bMute);
+		}
+	}
+
+	if (key == ' ') {
+		if (bLoaded) {
+			bShowControls = !bShowControls;
+			menu->SetPopupItem("Controls", bShowControls);
+			if(!bShowControls && bFullscreen && hwndAdjust) {
+				// Close adjust dialog if open full screen
+				// It can be opened with mouse click when the controls are visible
+				SendMessageA(hwndAdjust, WM_DESTROY, 0, 0L);
+				hwndAdjust = NULL;
+			}
+		}
+	}
+
+	if (key == 'i' || key == 'I') {
+		bShowInfo = !bShowInfo;
+		menu->SetPopupItem("Info", bShowInfo);
+	}
+
+	if (key == 'p' || key == 'P') {
+		bPaused = !bPaused;
+		if (bLoaded)
+			PauseMovie(bPaused);
+	}
+
+	if (key == 'r' || key == 'R') {
+		if (bLoaded) {
+			bResizeWindow = !bResizeWindow;
+			ResetWindow(true);
+			menu->SetPopupItem("Resize", bResizeWindow);
+		}
+	}
+
+	// Stop and close movie
+	if (key == 's' || key == 'S') {
+		CloseMovie();
+	}
+
+	// Go to the start of the movie
+	if (key == OF_KEY_HOME) {
+		if (bLoaded) {
+			CancelLoop();
+			bPaused = false;
+			if (bClipPlay) {
+				SetClipFrame(0);
+			}
+			else {
+				myMovie.setPosition(0.0f);
+				myMovie.play();
+			}
+		}
+	}
 
 	// Go to the end of the movie
 	if (key == OF_KEY_END) { // 49 (0x31) 57363
 		if (bLoaded) {
-			myMovie.setPosition(myMovie.getDuration());
+			CancelLoop();
 			bPaused = false;
-			myMovie.play();
+			if (bClipPlay) {
+				SetClipFrame(clipSource->GetFrames()-1);
+			}
+			else {
+				myMovie.setPosition(myMovie.getDuration());
+				myMovie.play();
+			}
 		}
 	}
 
@@ -818,6 +2326,22 @@ void ofApp::keyPressed(int key){
 	// Forward 8 frames
 	if (key == OF_KEY_PAGE_DOWN)
 		HandleControlButtons(188.0f, y);
+
+	// Faster or slower in steps
+	if (key == '+' || key == '=' || key == '-') {
+		if (bLoaded) {
+			static const float speeds[] = { 0.1f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f };
+			int nSpeeds = (int)(sizeof(speeds)/sizeof(speeds[0]));
+			int index = 0;
+			while (index < nSpeeds-1 && speeds[index] < playSpeed)
+				index++;
+			if (key == '-' && index > 0)
+				index--;
+			else if (key != '-' && speeds[index] <= playSpeed && index < nSpeeds-1)
+				index++;
+			SetSpeed(speeds[index]);
+		}
+	}
 }
 
 
@@ -839,9 +2363,19 @@ void ofApp::mouseMoved(int x, int y){
 	icon_stop_hover = false;
 	icon_fullscreen_hover = false;
 	icon_sound_hover = false;
+	bScrubHover = false;
 
 	if (bShowControls && !bFullscreen) {
 
+		if (bLoaded && !bSplash &&
+			x >= progress_bar.x &&
+			x <= (progress_bar.x + progress_bar.getWidth()) &&
+			y >= progress_bar.y &&
+			y <= (progress_bar.y + progress_bar.getHeight())) {
+			bScrubHover = true;
+			scrubPos = (x - progress_bar.x) / progress_bar.width;
+		}
+
 		if (x >= (icon_playpause_pos_x) &&
 			x <= (icon_playpause_pos_x + icon_size) &&
 			y >= (icon_playpause_pos_y) &&
@@ -951,6 +2485,23 @@ void ofApp::dragEvent(ofDragInfo dragInfo) {
 //--------------------------------------------------------------
 void ofApp::exit() {
 
+	// A movie waiting for the decoder
+	EndOpen();
+	scrub.Close();
+
+	// Cue times up to now
+	EndPreroll();
+	cues.SaveReport();
+
+	// Players are closed on the decoder thread
+	ReleasePlayer();
+	decoder.Stop();
+
+	// Offsets since the last log
+	if (sync.IsOpen() && !sync.IsMaster())
+		SpoutLogNotice("ofApp::exit - sync %s", sync.Report().c_str());
+	sync.Close();
+
 	spoutsender->ReleaseSender();
 	spoutsender->Release(); // Release the Spout SDK library instance
 	NDIsender.ReleaseSender();
@@ -974,16 +2525,10 @@ void ofApp::exit() {
 //--------------------------------------------------------------
 void ofApp::drawPlayBar()
 {
-	char str[256]{};
-
 	//
 	// Play bar
 	//
 
-	// Position of the first button
-	float icon_pos_x = icon_size / 2;
-	float icon_pos_y = progress_bar.getTop() + progress_bar.height * 1.5;
-
 	// Draw controls unless the startup image is showing
 	if (!bSplash) {
 
@@ -1006,165 +2551,47 @@ void ofApp::drawPlayBar()
 			if (!bShowInfo)
 				progress_bar.y += 14;
 
-			ofEnableAlphaBlending();
-			ofSetColor(26, 26, 26, 96);
-			ofDrawRectangle(0, progress_bar.y, controlbar_width, controlbar_height);
-
-			// If the movie is loaded, show the control bar
-			// bLoaded is set in OpenMovieFile
-			if (bLoaded) {
-
-				float position = myMovie.getPosition() / myMovie.getDuration();
-
-				// Draw progress bar
-				ofSetColor(0, 0, 0, 96);
-				ofDrawRectangle(progress_bar);
-
-				// Draw the movie progress in blue
-				ofSetColor(ofColor(74, 144, 226, 255));
-				progress_bar_played.x = progress_bar.x;
-				progress_bar_played.y = progress_bar.y;
-
-				progress_bar_played.width = progress_bar.width * myMovie.getPosition(); // pct
-				progress_bar_played.height = progress_bar.height;
-				ofDrawRectangle(progress_bar_played);
-
-				// Reverse
-				icon_reverse_pos_x = icon_pos_x;
-				icon_reverse_pos_y = icon_pos_y;
-				// if (bPaused && icon_reverse_hover)
-				if (icon_reverse_hover)
-					ofSetColor(icon_highlight_color);
-				else
-					ofSetColor(icon_background_color);
-				icon_background.x = icon_reverse_pos_x;
-				icon_background.y = icon_reverse_pos_y;
-				icon_background.width = icon_size;
-				icon_background.height = icon_size;
-				ofDrawRectRounded(icon_background, 2);
-				ofSetColor(255);
-				icon_reverse.draw(icon_reverse_pos_x, icon_reverse_pos_y);
-
-				// Back
-				icon_back_pos_x = icon_pos_x + 1.0 * (icon_size * 3 / 2);
-				icon_back_pos_y = icon_pos_y;
-				// if (bPaused && icon_back_hover)
-				if (icon_back_hover)
-					ofSetColor(icon_highlight_color);
-				else
-					ofSetColor(icon_background_color);
-				icon_background.x = icon_back_pos_x;
-				icon_background.y = icon_back_pos_y;
-				icon_background.width = icon_size;
-				icon_background.height = icon_size;
-				ofDrawRectRounded(icon_background, 2);
-				ofSetColor(255);
-				icon_back.draw(icon_back_pos_x, icon_back_pos_y);
-
-				// Play/Pause
-				icon_playpause_pos_x = icon_pos_x + 2.0 * (icon_size * 3 / 2);
-				icon_playpause_pos_y = icon_pos_y;
-				if (icon_playpause_hover)
-					ofSetColor(icon_highlight_color);
-				else
-					ofSetColor(icon_background_color);
-				icon_background.x = icon_playpause_pos_x;
-				icon_background.y = icon_playpause_pos_y;
-				icon_background.width = icon_size;
-				icon_background.height = icon_size;
-				ofDrawRectRounded(icon_background, 2);
-
-				// Draw play or pause button
-				ofSetColor(255);
-				if (bPaused)
-					icon_play.draw(icon_playpause_pos_x, icon_playpause_pos_y);
-				else
-					icon_pause.draw(icon_playpause_pos_x, icon_playpause_pos_y);
-
-			} // endif movie loaded
-
-			// Forward
-			icon_forward_pos_x = icon_pos_x + 3.0 * (icon_size * 3 / 2);
-			icon_forward_pos_y = icon_pos_y;
-			if (icon_forward_hover)
-				ofSetColor(icon_highlight_color);
-			else
-				ofSetColor(icon_background_color);
-			icon_background.x = icon_forward_pos_x;
-			icon_background.y = icon_forward_pos_y;
-			icon_background.width = icon_size;
-			icon_background.height = icon_size;
-			ofDrawRectRounded(icon_background, 2);
-			ofSetColor(255);
-			icon_forward.draw(icon_forward_pos_x, icon_forward_pos_y);
-
-			// Fast forward
+			// Button positions for the mouse functions
+			float icon_pos_x = icon_size / 2;
+			float icon_pos_y = progress_bar.getTop() + progress_bar.height * 1.5;
+			icon_reverse_pos_x = icon_pos_x;
+			icon_back_pos_x = icon_pos_x + 1.0 * (icon_size * 3 / 2);
+			icon_playpause_pos_x = icon_pos_x + 2.0 * (icon_size * 3 / 2);
+			icon_forward_pos_x = icon_pos_x + 3.0 * (icon_size * 3 / 2);
 			icon_fastforward_pos_x = icon_pos_x + 4.0 * (icon_size * 3 / 2);
-			icon_fastforward_pos_y = icon_pos_y;
-			if (icon_fastforward_hover)
-				ofSetColor(icon_highlight_color);
-			else
-				ofSetColor(icon_background_color);
-			icon_background.x = icon_fastforward_pos_x;
-			icon_background.y = icon_fastforward_pos_y;
-			icon_background.width = icon_size;
-			icon_background.height = icon_size;
-			ofDrawRectRounded(icon_background, 2);
-			ofSetColor(255);
-			icon_fastforward.draw(icon_fastforward_pos_x, icon_fastforward_pos_y);
-
-			// Stop
 			icon_stop_pos_x = icon_pos_x + 5.0 * (icon_size * 3 / 2);
-			icon_stop_pos_y = icon_pos_y;
-			if (icon_stop_hover)
-				ofSetColor(icon_highlight_color);
-			else
-				ofSetColor(icon_background_color);
-			icon_background.x = icon_stop_pos_x;
-			icon_background.y = icon_stop_pos_y;
-			icon_background.width = icon_size;
-			icon_background.height = icon_size;
-			ofDrawRectRounded(icon_background, 2);
-			ofSetColor(255);
-			icon_stop.draw(icon_stop_pos_x, icon_stop_pos_y);
-
-			// Full screen
 			icon_fullscreen_pos_x = ofGetWidth() - (icon_size * 1.5);
-			icon_fullscreen_pos_y = icon_pos_y;
-			if (icon_fullscreen_hover)
-				ofSetColor(icon_highlight_color);
-			else
-				ofSetColor(icon_background_color);
-			icon_background.x = icon_fullscreen_pos_x;
-			icon_background.y = icon_fullscreen_pos_y;
-			icon_background.width = icon_size;
-			icon_background.height = icon_size;
-			ofDrawRectRounded(icon_background, 2);
-			ofSetColor(255);
-			icon_full_screen.draw(icon_fullscreen_pos_x, icon_fullscreen_pos_y);
-
-			// Sound play / mute
 			icon_sound_pos_x = ofGetWidth() - (icon_size * 3.0);
-			icon_sound_pos_y = icon_pos_y;
-			if (icon_sound_hover)
-				ofSetColor(icon_highlight_color);
-			else
-				ofSetColor(icon_background_color);
-			icon_background.x = icon_sound_pos_x;
-			icon_background.y = icon_sound_pos_y;
-			icon_background.width = icon_size;
-			icon_background.height = icon_size;
-			ofDrawRectRounded(icon_background, 2);
-
-			// Draw sound button
+			icon_reverse_pos_y = icon_back_pos_y = icon_playpause_pos_y = icon_pos_y;
+			icon_forward_pos_y = icon_fastforward_pos_y = icon_stop_pos_y = icon_pos_y;
+			icon_fullscreen_pos_y = icon_sound_pos_y = icon_pos_y;
+
+			// The bar and buttons are drawn again only if they change
+			RenderPlayBar();
+
+			// The fbo alpha is premultiplied
+			ofEnableAlphaBlending();
+			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 			ofSetColor(255);
-			if (bMute)
-				icon_mute.draw(icon_sound_pos_x, icon_sound_pos_y);
-			else
-				icon_sound.draw(icon_sound_pos_x, icon_sound_pos_y);
+			iconFbo.draw(0, progress_bar.y);
+			ofEnableAlphaBlending();
+
+			// If the movie is loaded, draw the movie progress in blue
+			// bLoaded is set in OpenMovieFile
+			if (bLoaded) {
+				ofSetColor(ofColor(74, 144, 226, 255));
+				progress_bar_played.x = progress_bar.x;
+				progress_bar_played.y = progress_bar.y;
+				progress_bar_played.width = progress_bar.width * GetMoviePosition(); // pct
+				progress_bar_played.height = progress_bar.height;
+				ofDrawRectangle(progress_bar_played);
+			}
 
 			ofDisableAlphaBlending();
 
+			if (bLoaded && bScrubHover)
+				DrawScrubThumbnail();
+
 		} // endif show controls
 		else {
 			if (bFullscreen) {
@@ -1179,6 +2606,82 @@ void ofApp::drawPlayBar()
 	// ============ end playbar controls ==============
 }
 
+//--------------------------------------------------------------
+// Draw the control bar background, the progress bar background and
+// the buttons into iconFbo if the size, a hover or a button state
+// has changed since it was last drawn.
+void ofApp::RenderPlayBar()
+{
+	int width  = (int)controlbar_width;
+	int height = (int)controlbar_height;
+	if (width < 1 || height < 1)
+		return;
+
+	unsigned int state = (bLoaded ? 1 : 0) | (bPaused ? 2 : 0) | (bMute ? 4 : 0)
+		| (icon_reverse_hover ? 8 : 0) | (icon_back_hover ? 16 : 0)
+		| (icon_playpause_hover ? 32 : 0) | (icon_forward_hover ? 64 : 0)
+		| (icon_fastforward_hover ? 128 : 0) | (icon_stop_hover ? 256 : 0)
+		| (icon_fullscreen_hover ? 512 : 0) | (icon_sound_hover ? 1024 : 0)
+		| (assets.Upload() ? 2048 : 0); // Icons available
+
+	bool bSize = iconFbo.isAllocated()
+		&& (int)iconFbo.getWidth() == width && (int)iconFbo.getHeight() == height;
+	if (bSize && state == playBarState)
+		return;
+	if (!bSize)
+		iconFbo.allocate(width, height, GL_RGBA);
+	playBarState = state;
+
+	// Positions in the fbo are from the top of the progress bar
+	float top = progress_bar.y;
+
+	iconFbo.begin();
+	ofClear(0, 0, 0, 0);
+
+	// Colour is blended and alpha accumulated
+	// so that the fbo has premultiplied alpha
+	ofEnableAlphaBlending();
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	ofSetColor(26, 26, 26, 96);
+	ofDrawRectangle(0, 0, controlbar_width, controlbar_height);
+
+	if (bLoaded) {
+		// Progress bar
+		ofSetColor(0, 0, 0, 96);
+		ofDrawRectangle(0, 0, progress_bar.width, progress_bar.height);
+
+		DrawPlayButton(uiAssets::ICON_REVERSE, icon_reverse_pos_x, icon_reverse_pos_y - top, icon_reverse_hover);
+		DrawPlayButton(uiAssets::ICON_BACK, icon_back_pos_x, icon_back_pos_y - top, icon_back_hover);
+		DrawPlayButton(bPaused ? uiAssets::ICON_PLAY : uiAssets::ICON_PAUSE,
+			icon_playpause_pos_x, icon_playpause_pos_y - top, icon_playpause_hover);
+	}
+	DrawPlayButton(uiAssets::ICON_FORWARD, icon_forward_pos_x, icon_forward_pos_y - top, icon_forward_hover);
+	DrawPlayButton(uiAssets::ICON_FASTFORWARD, icon_fastforward_pos_x, icon_fastforward_pos_y - top, icon_fastforward_hover);
+	DrawPlayButton(uiAssets::ICON_STOP, icon_stop_pos_x, icon_stop_pos_y - top, icon_stop_hover);
+	DrawPlayButton(uiAssets::ICON_FULLSCREEN, icon_fullscreen_pos_x, icon_fullscreen_pos_y - top, icon_fullscreen_hover);
+	DrawPlayButton(bMute ? uiAssets::ICON_MUTE : uiAssets::ICON_SOUND, icon_sound_pos_x, icon_sound_pos_y - top, icon_sound_hover);
+
+	ofDisableAlphaBlending();
+	iconFbo.end();
+}
+
+//--------------------------------------------------------------
+void ofApp::DrawPlayButton(int icon, float x, float y, bool bHover)
+{
+	if (bHover)
+		ofSetColor(icon_highlight_color);
+	else
+		ofSetColor(icon_background_color);
+	icon_background.x = x;
+	icon_background.y = y;
+	icon_background.width = icon_size;
+	icon_background.height = icon_size;
+	ofDrawRectRounded(icon_background, 2);
+	ofSetColor(255);
+	assets.DrawIcon(icon, x, y);
+}
+
 //--------------------------------------------------------------
 void ofApp::HandleControlButtons(float x, float y, int button) {
 
@@ -1189,7 +2692,11 @@ void ofApp::HandleControlButtons(float x, float y, int button) {
 	float frametime = 0.0333333333333333; // 30 fps
 
 	if (bLoaded) {
-		bPaused = myMovie.isPaused();
+		// The decoder is paused while frames are played from memory
+		if (bClipPlay)
+			bPaused = this->bPaused;
+		else
+			bPaused = myMovie.isPaused();
 	}
 
 	if (bLoaded &&
@@ -1199,10 +2706,16 @@ void ofApp::HandleControlButtons(float x, float y, int button) {
 		y <= (progress_bar.y + progress_bar.getHeight())) {
 
 		// Click on progress bar
+		CancelLoop();
 		float pos = (x - progress_bar.x) / progress_bar.width;
-		myMovie.setPosition(pos);
-		if (bPaused)
-			myMovie.setPaused(true);
+		if (bClipPlay) {
+			SetClipFrame((int)(pos*(float)clipSource->GetFrames()));
+		}
+		else {
+			myMovie.setPosition(pos);
+			if (bPaused)
+				myMovie.setPaused(true);
+		}
 
 		controlbar_timer_end = false;
 		controlbar_start_time = ofGetElapsedTimeMillis();
@@ -1221,6 +2734,9 @@ void ofApp::HandleControlButtons(float x, float y, int button) {
 		x <= (icon_reverse_pos_x + icon_size) &&
 		y >= (icon_reverse_pos_y) &&
 		y <= (icon_reverse_pos_y + icon_size)) {
+		if (bClipPlay)
+			SetClipFrame(0);
+		else
 			myMovie.setPosition(0);
 	}
 
@@ -1230,7 +2746,10 @@ void ofApp::HandleControlButtons(float x, float y, int button) {
 		x <= (icon_back_pos_x + icon_size) &&
 		y >= (icon_back_pos_y) &&
 		y <= (icon_back_pos_y + icon_size)) {
-		myMovie.previousFrame();
+		if (bClipPlay)
+			SetClipFrame(nClipFrame-1);
+		else
+			myMovie.previousFrame();
 	}
 
 	// Play / pause
@@ -1248,7 +2767,10 @@ void ofApp::HandleControlButtons(float x, float y, int button) {
 		x <= (icon_forward_pos_x + icon_size) &&
 		y >= (icon_forward_pos_y) &&
 		y <= (icon_forward_pos_y + icon_size)) {
-		myMovie.nextFrame();
+		if (bClipPlay)
+			SetClipFrame(nClipFrame+1);
+		else
+			myMovie.nextFrame();
 	}
 
 	// Fast forward (go to end)
@@ -1258,8 +2780,13 @@ void ofApp::HandleControlButtons(float x, float y, int button) {
 		y >= (icon_fastforward_pos_y) &&
 		y <= (icon_fastforward_pos_y + icon_size)) {
 		// Show the last frame (-2 is minimum)
-		myMovie.setFrame(myMovie.getTotalNumFrames()-2);
-		myMovie.update();
+		if (bClipPlay) {
+			SetClipFrame(clipSource->GetFrames()-1);
+		}
+		else {
+			myMovie.setFrame(myMovie.getTotalNumFrames()-2);
+			myMovie.update();
+		}
 	}
 
 	// Stop (stop movie)
@@ -1271,132 +2798,687 @@ void ofApp::HandleControlButtons(float x, float y, int button) {
 		CloseMovie();
 	}
 
-	// Full screen
-	else if (myMovie.isLoaded() &&
-		x >= (icon_fullscreen_pos_x) &&
-		x <= (icon_fullscreen_pos_x + icon_size) &&
-		y >= (icon_fullscreen_pos_y) &&
-		y <= (icon_fullscreen_pos_y + icon_size)) {
-		bFullscreen = !bFullscreen;
-		doFullScreen(bFullscreen);
-	}
+	// Full screen
+	else if (myMovie.isLoaded() &&
+		x >= (icon_fullscreen_pos_x) &&
+		x <= (icon_fullscreen_pos_x + icon_size) &&
+		y >= (icon_fullscreen_pos_y) &&
+		y <= (icon_fullscreen_pos_y + icon_size)) {
+		bFullscreen = !bFullscreen;
+		doFullScreen(bFullscreen);
+	}
+
+	// Sound
+	else if (myMovie.isLoaded() &&
+		x >= (icon_sound_pos_x) &&
+		x <= (icon_sound_pos_x + icon_size) &&
+		y >= (icon_sound_pos_y) &&
+		y <= (icon_sound_pos_y + icon_size)) {
+		// LH click to open/close for volume slider
+		if (button == 0) {
+			if (hwndVolume)
+				CloseVolume();
+			else
+				hwndVolume = CreateDialogA(g_hInstance, MAKEINTRESOURCEA(IDD_OPTIONSBOX), hWnd, (DLGPROC)UserVolume);
+		}
+		else if (button == 2) {
+			// RH click to mute
+			bMute = !bMute;
+			if (bMute)
+				myMovie.setVolume(0.0f);
+			else
+				myMovie.setVolume(movieVolume);
+		}
+	}
+
+}
+
+
+//--------------------------------------------------------------
+void ofApp::setVideoPlaypause() {
+
+	controlbar_timer_end = false;
+	controlbar_start_time = ofGetElapsedTimeMillis();
+	bPaused = !bPaused;
+
+	if (bPaused)
+		bShowControls = true;
+
+	if (bLoaded)
+		PauseMovie(bPaused);
+
+}
+
+//--------------------------------------------------------------
+bool ofApp::OpenMovieFile(string filePath) {
+
+	// Close volume dialog
+	CloseVolume();
+
+	bLoaded = false;
+	nOldFrames = 0;
+	nNewFrames = 0;
+	nRepeatedFrames = 0;
+	bRepeatedFrame = false;
+	bHashPending = false;
+	bFrameHash = false;
+
+	// Return from frames played from memory
+	bClipPlay = false;
+	bClipHold = false;
+	clipTexture.clear();
+	bPristine = false;
+	rawSource.Close();
+	sequence.Close();
+	still.Close();
+	clipSource = &clips;
+
+	EndOpen();
+	scrub.Close();
+	bProbeStore = false;
+	bPrerolled = false;
+	ReleasePlayer();
+
+	// An uncompressed raw movie is played from the file mapping and
+	// numbered image files are decoded by a thread pool, both without
+	// the movie decoder. Otherwise load the movie and check the
+	// duration in case the user loads an image.
+	frameSource* source = nullptr;
+	bool bRaw = rawMovie::IsRawMovie(filePath);
+	bool bSequence = !bRaw && imageSequence::IsImageFile(filePath);
+	bool bOpened = false;
+	if (bRaw) {
+		if (rawSource.Open(filePath) && rawSource.GetFrames() > 0)
+			source = &rawSource;
+		bOpened = (source != nullptr);
+	}
+	else if (bSequence && sequence.Open(filePath, sequenceFps, nSequenceThreads)) {
+		source = &sequence;
+		bOpened = true;
+	}
+	else if (bSequence && still.Open(filePath)) {
+		// An image that is not numbered
+		source = &still;
+		bStillDirty = true;
+		bOpened = true;
+	}
+	else if (UsePreroll(filePath)) {
+		// Opened and seeked for a cue
+		bPrerolled = true;
+		bOpened = true;
+	}
+	else if (probes.Find(filePath, openProbe)) {
+		// Opened before. The decoder is opened while the thumbnail is sent.
+		StartOpen();
+		bOpened = true;
+	}
+	else {
+		// The player is made on the decoder thread (see DecoderThread.h)
+		std::shared_ptr<ofBaseVideoPlayer> player = decoder.Load(filePath);
+		bOpened = (player != nullptr);
+		if (bOpened)
+			myMovie.setPlayer(player);
+		bProbeStore = bOpened;
+	}
+
+	if (bOpened) {
+
+		// Play 60 frames in case of incompatible codec to avoid a freeze
+		nOldFrames = 0;
+		nNewFrames = 0;
+
+		// fps is calculated when playing
+		fps = frameRate = 30.0;
+
+		bPaused = false;
+		movieFile = filePath; // For movie folder open
+		bSplash = false;
+
+		// Loop state for the new movie
+		bLoopPlay = false;
+		nLoopFrame = -1;
+		nLastFrame = 0;
+		loopHead.Release();
+
+		if (source) {
+			movieWidth = (float)source->GetFrameWidth();
+			movieHeight = (float)source->GetFrameHeight();
+			movieFps = (float)source->GetFrameRate();
+			if (movieFps <= 0.0f)
+				movieFps = 30.0f;
+
+			// Frames are played by UpdateClip and loop without a seek
+			loopTexture.clear();
+			clipSource = source;
+			clipTexture.allocate((int)movieWidth, (int)movieHeight, GL_RGBA8);
+			SetYuvMatrix(yuvMatrix); // Auto matrix for the movie size
+			bClipPlay = true;
+			bClipHold = false;
+			nClipFrame = -1; // The first frame is loaded by UpdateClip
+			nClipSeek = -1;
+			clipStartTime = (double)ofGetElapsedTimeMicros();
+			SpoutLogNotice("ofApp::OpenMovieFile - %s (%d frames %dx%d at %.2f fps)",
+				filePath.c_str(), source->GetFrames(), (int)movieWidth, (int)movieHeight, movieFps);
+
+			// Decode rate for each number of threads (command line "-benchmark")
+			if (bSequence && bSequenceBench) {
+				std::string result = sequence.Benchmark(0);
+				doMessageBox(NULL, result.c_str(), "Image sequence decode", MB_OK);
+				bSequenceBench = false;
+			}
+		}
+		else if (bOpening) {
+			// Until the decoder is open (see UpdateOpening)
+			movieWidth = (float)openProbe.width;
+			movieHeight = (float)openProbe.height;
+			movieFps = (float)openProbe.frames / openProbe.duration;
+			if (movieFps <= 0.0f)
+				movieFps = 30.0f;
+		}
+		else {
+			// A pre-rolled movie is at the cue frame
+			if (!bPrerolled)
+				myMovie.setPosition(0.0f);
+			myMovie.setVolume(movieVolume);
+
+			movieWidth = myMovie.getWidth();
+			movieHeight = myMovie.getHeight();
+			movieFps = (float)myMovie.getTotalNumFrames() / myMovie.getDuration();
+
+			// Seamless loop cache for the new movie size
+			SetLoopState();
+
+			// Memory cache for the frames shown before the end of the movie
+			// is detected (see Update). A cached movie plays from memory.
+			if (bMemoryCache)
+				clips.Begin(filePath, myMovie.getTotalNumFrames()-1, (int)movieWidth, (int)movieHeight);
+
+			// Progress bar thumbnails
+			if (!bHeadless)
+				scrub.Open(filePath, (int)movieWidth, (int)movieHeight, probes.GetCacheFile(filePath, "thumbs"));
+		}
+
+		if (bResizeWindow)
+			ResetWindow(true);
+
+		// Allocat an rgba fbno the size of the movie
+		myFbo.allocate(movieWidth, movieHeight, GL_RGBA);
+
+		// The thumbnail is the first frame until the decoder is open
+		if (bOpening && openProbe.thumbnail.isAllocated()) {
+			ofTexture thumbnail;
+			thumbnail.loadData(openProbe.thumbnail);
+			ofSetColor(255);
+			myFbo.begin();
+			thumbnail.draw(0, 0, movieWidth, movieHeight);
+			myFbo.end();
+			openProbe.thumbnail.clear();
+		}
+
+		// Frame rate conversion from the movie rate
+		frc.Start(movieFps);
+
+		// The playback speed continues for the new movie
+		SetSpeed(playSpeed);
+		deint.Start();
+		denoise.Start();
+		levels.Start();
+		ndiReadback.Start();
+
+		// Keyframes for the movie if there is a sidecar file
+		if (automation.Load(filePath + ".keys"))
+			SpoutLogNotice("ofApp::OpenMovieFile - %d keyframes from %s.keys", automation.GetKeys(), filePath.c_str());
+
+		// Release senders to recreate
+		spoutsender->ReleaseSender();
+		bInitialized = false;
+
+		NDIsender.ReleaseSender();
+		bNDIinitialized = false;
+
+		// Set the sender name to the movie file name
+		strcpy_s(sendername, 256, filePath.c_str());
+		PathStripPathA(sendername);
+		PathRemoveExtensionA(sendername);
+
+		return true;
+
+	}
+	else {
+		rawSource.Close();
+		if (bRaw)
+			doMessageBox(NULL, "Could not open the raw movie file", "SpoutVideoPlayer", MB_ICONERROR | MB_OK);
+		else if (bSequence)
+			doMessageBox(NULL, "Could not open the image file", "SpoutVideoPlayer", MB_ICONERROR | MB_OK);
+		else
+			doMessageBox(NULL, "Could not load the movie file\nMake sure you have codecs installed on your system.\nOF recommends the free K - Lite Codec pack.", "SpoutVideoPlayer", MB_ICONERROR | MB_OK);
+		bLoaded = false;
+		bSplash = true;
+		return false;
+	}
+
+}
+
+// Open the movie decoder while the thumbnail is sent (see UpdateOpening)
+void ofApp::StartOpen()
+{
+	bOpening = true;
+	nOpeningFrames = 0;
+	nOpenJob = -1;
+	nOpenFrame = -1;
+}
+
+//--------------------------------------------------------------
+// The decoder thread starts to open the movie on the first cycle.
+// The senders are created on the first cycle and the thumbnail is
+// sent on the second (see SendFrames). From the third, the player
+// is checked each cycle without waiting and NDI is kept connected.
+void ofApp::UpdateOpening()
+{
+	bRepeatedFrame = false;
+	bHashPending = false;
+	bNewFrame = (nOpeningFrames < 2);
+	if (nOpeningFrames == 0)
+		nOpenJob = decoder.Open(movieFile);
+	nOpeningFrames++;
+
+	if (nOpeningFrames <= 2)
+		return;
+
+	std::shared_ptr<ofBaseVideoPlayer> player;
+	int state = decoder.Poll(nOpenJob, player);
+	if (state == decoderThread::DECODER_WAITING)
+		return;
+
+	bOpening = false;
+	nOpenJob = -1;
+
+	if (state != decoderThread::DECODER_READY) {
+		bLoaded = false;
+		bSplash = true;
+		spoutsender->ReleaseSender();
+		bInitialized = false;
+		NDIsender.ReleaseSender();
+		bNDIinitialized = false;
+		doMessageBox(NULL, "Could not load the movie file\nMake sure you have codecs installed on your system.\nOF recommends the free K - Lite Codec pack.", "SpoutVideoPlayer", MB_ICONERROR | MB_OK);
+		return;
+	}
+
+	myMovie.setPlayer(player);
+	if (nOpenFrame > 0)
+		myMovie.setFrame(nOpenFrame);
+	else
+		myMovie.setPosition(0.0f);
+	myMovie.setVolume(movieVolume);
+
+	// The probe is for an unchanged file but the decoder decides
+	if (myMovie.getWidth() != movieWidth || myMovie.getHeight() != movieHeight) {
+		movieWidth = myMovie.getWidth();
+		movieHeight = myMovie.getHeight();
+		myFbo.allocate(movieWidth, movieHeight, GL_RGBA);
+		spoutsender->ReleaseSender();
+		bInitialized = false;
+		NDIsender.ReleaseSender();
+		bNDIinitialized = false;
+		bProbeStore = true;
+	}
+	movieFps = (float)myMovie.getTotalNumFrames() / myMovie.getDuration();
+	frc.Start(movieFps);
+	SetSpeed(playSpeed);
+
+	// As for a movie opened directly (see OpenMovieFile)
+	SetLoopState();
+	if (bMemoryCache)
+		clips.Begin(movieFile, myMovie.getTotalNumFrames()-1, (int)movieWidth, (int)movieHeight);
+	if (!bHeadless)
+		scrub.Open(movieFile, (int)movieWidth, (int)movieHeight, probes.GetCacheFile(movieFile, "thumbs"));
+
+	myMovie.play();
+	myMovie.setPaused(bPaused);
+
+	SpoutLogNotice("ofApp::UpdateOpening - %s opened after %d cycles", movieFile.c_str(), nOpeningFrames);
+}
+
+//--------------------------------------------------------------
+// Cancel an open that is waiting for the decoder
+void ofApp::EndOpen()
+{
+	if (bOpening && nOpenJob >= 0)
+		decoder.Cancel(nOpenJob);
+	bOpening = false;
+	nOpenJob = -1;
+}
+
+//--------------------------------------------------------------
+// Give the movie player to the decoder thread to close. myMovie
+// has a new player that is not loaded, which does not use COM.
+void ofApp::ReleasePlayer()
+{
+	myMovie.stop();
+	std::shared_ptr<ofBaseVideoPlayer> player = myMovie.getPlayer();
+	myMovie.setPlayer(std::make_shared<OF_VID_PLAYER_TYPE>());
+	decoder.Release(std::move(player));
+}
+
+//--------------------------------------------------------------
+// Stream parameters and thumbnail from the first movie frame
+void ofApp::StoreProbe()
+{
+	bProbeStore = false;
+
+	mediaProbe::info probe;
+	probe.width = (int)myMovie.getWidth();
+	probe.height = (int)myMovie.getHeight();
+	probe.frames = myMovie.getTotalNumFrames();
+	probe.duration = myMovie.getDuration();
+	probe.thumbnail = myMovie.getPixels();
+	probes.Store(movieFile, probe);
+}
+
+//--------------------------------------------------------------
+// Fire the cues that are due and pre-roll the next movie.
+// A cue is fired in the cycle nearest its time.
+void ofApp::UpdateCues()
+{
+	int index = cues.Due(ofGetLastFrameTime()/2.0);
+	while (index >= 0) {
+		FireCue(index);
+		index = cues.Due(ofGetLastFrameTime()/2.0);
+	}
+
+	// A pre-roll for a cue that has passed
+	if (nPrerollCue >= 0 && cues.GetCue(nPrerollCue).bFired)
+		EndPreroll();
+
+	// One pre-roll at a time
+	if (nPrerollCue < 0) {
+		int next = cues.NextPlay();
+		if (next >= 0)
+			StartPreroll(next);
+	}
+	UpdatePreroll();
+}
+
+//--------------------------------------------------------------
+void ofApp::FireCue(int index)
+{
+	cueList::cue &c = cues.GetCue(index);
+
+	switch (c.command) {
+
+		case cueList::CUE_PLAY:
+			if (OpenMovieFile(c.path)) {
+				if (!bPrerolled && !bClipPlay)
+					SpoutLogWarning("ofApp::FireCue - line %d not pre-rolled", c.line);
+				bLoaded = true;
+				bPaused = false;
+				// Without a pre-roll, a movie opened before plays from the
+				// cue frame when the decoder thread has opened it
+				if (bOpening) {
+					nOpenFrame = c.frame;
+				}
+				else {
+					myMovie.setPaused(false);
+					myMovie.play();
+					// Frames played by the application
+					if (bClipPlay && c.frame > 0 && clipSource != &still)
+						SetClipFrame(c.frame);
+					else if (!bClipPlay && !bPrerolled && c.frame > 0 && myMovie.isLoaded())
+						myMovie.setFrame(c.frame);
+				}
+			}
+			EndPreroll();
+			break;
+
+		case cueList::CUE_SEEK:
+			if (!bLoaded)
+				break;
+			if (bClipPlay)
+				SetClipFrame(c.frame);
+			else if (!bOpening)
+				myMovie.setFrame(c.frame);
+			break;
+
+		case cueList::CUE_PAUSE:
+			if (bLoaded) {
+				PauseMovie(true);
+				bPaused = true;
+			}
+			break;
+
+		case cueList::CUE_RESUME:
+			if (bLoaded) {
+				PauseMovie(false);
+				bPaused = false;
+			}
+			break;
 
-	// Sound
-	else if (myMovie.isLoaded() &&
-		x >= (icon_sound_pos_x) &&
-		x <= (icon_sound_pos_x + icon_size) &&
-		y >= (icon_sound_pos_y) &&
-		y <= (icon_sound_pos_y + icon_size)) {
-		// LH click to open/close for volume slider
-		if (button == 0) {
-			if (hwndVolume)
-				CloseVolume();
-			else
-				hwndVolume = CreateDialogA(g_hInstance, MAKEINTRESOURCEA(IDD_OPTIONSBOX), hWnd, (DLGPROC)UserVolume);
-		}
-		else if (button == 2) {
-			// RH click to mute
-			bMute = !bMute;
-			if (bMute)
-				myMovie.setVolume(0.0f);
-			else
-				myMovie.setVolume(movieVolume);
-		}
+		case cueList::CUE_STOP:
+			if (bLoaded)
+				CloseMovie();
+			break;
 	}
 
+	SpoutLogNotice("ofApp::FireCue - line %d %s %s %d (%+.1f msec)",
+		c.line, cueList::GetCommandName(c.command), c.path.c_str(), c.frame, c.fired*1000.0);
 }
 
-
 //--------------------------------------------------------------
-void ofApp::setVideoPlaypause() {
+// Pre-roll the movie of a cue so that the decoder is ready at the cue time.
+// Raw movies and image files open without a decoder.
+void ofApp::StartPreroll(int index)
+{
+	cueList::cue &c = cues.GetCue(index);
+	nPrerollCue = index;
+	if (rawMovie::IsRawMovie(c.path) || imageSequence::IsImageFile(c.path))
+		return;
 
-	controlbar_timer_end = false;
-	controlbar_start_time = ofGetElapsedTimeMillis();
-	bPaused = !bPaused;
+	// Opened, paused at the cue frame and seeked by the decoder thread
+	prerollPath = c.path;
+	nPrerollJob = decoder.Open(c.path, (c.frame > 0) ? c.frame : 0);
+}
 
-	if (bPaused)
-		bShowControls = true;
+//--------------------------------------------------------------
+// Take the pre-rolled player when the decoder thread has it ready
+void ofApp::UpdatePreroll()
+{
+	if (nPrerollJob < 0)
+		return;
 
-	if (bLoaded)
-		myMovie.setPaused(bPaused);
+	int state = decoder.Poll(nPrerollJob, prerollPlayer);
+	if (state == decoderThread::DECODER_WAITING)
+		return;
 
+	nPrerollJob = -1;
+	if (state != decoderThread::DECODER_READY) {
+		SpoutLogWarning("ofApp::UpdatePreroll - could not open %s", prerollPath.c_str());
+		prerollPlayer.reset();
+		prerollPath.clear();
+	}
 }
 
 //--------------------------------------------------------------
-bool ofApp::OpenMovieFile(string filePath) {
-
-	// Close volume dialog
-	CloseVolume();
+// Discard a pre-roll. The player is closed on the decoder thread.
+void ofApp::EndPreroll()
+{
+	if (nPrerollJob >= 0)
+		decoder.Cancel(nPrerollJob);
+	nPrerollJob = -1;
+	decoder.Release(std::move(prerollPlayer));
+	prerollPlayer.reset();
+	prerollPath.clear();
+	nPrerollCue = -1;
+}
 
-	bLoaded = false;
-	nOldFrames = 0;
-	nNewFrames = 0;
+//--------------------------------------------------------------
+// Give the pre-rolled player to myMovie if it is ready
+bool ofApp::UsePreroll(std::string path)
+{
+	if (!prerollPlayer || path != prerollPath)
+		return false;
 
-	myMovie.stop();
-	myMovie.close();
-	
-	// Load and check the duration in case the user loads an image
-	if (myMovie.load(filePath) && myMovie.getDuration() > 0.0f) {
+	myMovie.setPlayer(prerollPlayer);
+	prerollPlayer.reset();
+	prerollPath.clear();
 
-		// Play 60 frames in case of incompatible codec to avoid a freeze
-		nOldFrames = 0;
-		nNewFrames = 0;
+	return true;
+}
 
-		// fps is calculated when playing
-		fps = frameRate = 30.0;
+//--------------------------------------------------------------
+// Publish the media time as the master, or follow it.
+// A follower measures the offset when a frame is shown or while
+// paused. The speed correction continues between frames.
+void ofApp::UpdateSync()
+{
+	if (bOpening || bSplash)
+		return;
 
-		bPaused = false;
-		myMovie.setPosition(0.0f);
+	double mediaTime = GetMediaTime();
+	if (sync.IsMaster()) {
+		sync.Publish(mediaTime, GetMediaDuration(), (double)movieFps, (double)playSpeed, bPaused);
+		return;
+	}
 
-		if (bLoop)
-			myMovie.setLoopState(OF_LOOP_NORMAL);
-		else
-			myMovie.setLoopState(OF_LOOP_NONE);
+	// The master was writing for all the retries. It is still
+	// there so the last correction is kept for this cycle.
+	syncClock::state master;
+	int result = sync.Read(master);
+	if (result == syncClock::READ_BUSY)
+		return;
 
-		myMovie.setVolume(movieVolume);
+	bool bMaster = (result == syncClock::READ_OK);
+	if (bMaster && (master.bPaused != 0) != bPaused) {
+		PauseMovie(master.bPaused != 0);
+		bPaused = (master.bPaused != 0);
+	}
 
-		movieFile = filePath; // For movie folder open
-		bSplash = false;
+	double rate = syncRate;
+	if (!bMaster) {
+		rate = 1.0;
+	}
+	else if (bNewFrame || bPaused) {
+		double offset = syncClock::Offset(master, mediaTime);
+		sync.Record(offset, (double)movieFps);
+		if (sync.Correct(offset, (double)movieFps, rate) == syncClock::SYNC_SKIP) {
+			int frame = (int)(syncClock::Predict(master)*(double)movieFps + 0.5);
+			if (bClipPlay) {
+				SetClipFrame(frame);
+			}
+			else {
+				if (frame > myMovie.getTotalNumFrames()-1)
+					frame = myMovie.getTotalNumFrames()-1;
+				myMovie.setFrame(frame);
+			}
+			rate = 1.0;
+		}
+		if (bPaused)
+			rate = 1.0;
+	}
 
-		movieWidth = myMovie.getWidth();
-		movieHeight = myMovie.getHeight();
+	// Frames played from memory are timed from the clip start (see UpdateClip)
+	if (bClipPlay) {
+		syncRate = rate;
+		if (!bPaused)
+			clipStartTime -= (syncRate - 1.0)*ofGetLastFrameTime()*1000000.0;
+	}
+	else if (fabs(rate - syncRate) > 0.001) {
+		syncRate = rate;
+		myMovie.setSpeed(playSpeed*(float)syncRate);
+	}
 
-		if (bResizeWindow)
-			ResetWindow(true);
+	// Offset statistics every 10 seconds
+	float now = ofGetElapsedTimef();
+	if (now - syncLogTime >= 10.0) {
+		SpoutLogNotice("ofApp::UpdateSync - %s", sync.Report().c_str());
+		sync.ResetStats();
+		syncLogTime = now;
+	}
+}
 
-		// Allocat an rgba fbno the size of the movie
-		myFbo.allocate(movieWidth, movieHeight, GL_RGBA);
+//--------------------------------------------------------------
+// Media time of the frame shown (seconds)
+double ofApp::GetMediaTime()
+{
+	if (bClipPlay)
+		return (double)((nClipFrame > 0) ? nClipFrame : 0)/(double)movieFps;
+	return (double)myMovie.getPosition()*(double)myMovie.getDuration();
+}
 
-		// Release senders to recreate
-		spoutsender->ReleaseSender();
-		bInitialized = false;
+//--------------------------------------------------------------
+double ofApp::GetMediaDuration()
+{
+	if (bClipPlay)
+		return (double)clipSource->GetFrames()/(double)movieFps;
+	return (double)myMovie.getDuration();
+}
 
-		NDIsender.ReleaseSender();
-		bNDIinitialized = false;
+//--------------------------------------------------------------
+// Thumbnail of the movie position under the mouse above the
+// progress bar, centred on the mouse and inside the window
+void ofApp::DrawScrubThumbnail()
+{
+	scrub.Update();
 
-		// Set the sender name to the movie file name
-		strcpy_s(sendername, 256, filePath.c_str());
-		PathStripPathA(sendername);
-		PathRemoveExtensionA(sendername);
+	float w = (float)scrub.GetWidth();
+	float h = (float)scrub.GetHeight();
+	if (w <= 0.0f || h <= 0.0f)
+		return;
 
-		return true;
+	float x = progress_bar.x + scrubPos*progress_bar.width - w/2.0f;
+	if (x > (float)ofGetWidth() - w - 2.0f) x = (float)ofGetWidth() - w - 2.0f;
+	if (x < 2.0f) x = 2.0f;
+	float y = progress_bar.y - h - 6.0f;
 
+	ofSetColor(26);
+	ofDrawRectangle(x - 2.0f, y - 2.0f, w + 4.0f, h + 4.0f);
+	ofSetColor(255);
+	if (!scrub.Draw(scrubPos, x, y)) {
+		// None extracted yet
+		ofSetColor(64);
+		ofDrawRectangle(x, y, w, h);
+		ofSetColor(255);
 	}
-	else {
-		doMessageBox(NULL, "Could not load the movie file\nMake sure you have codecs installed on your system.\nOF recommends the free K - Lite Codec pack.", "SpoutVideoPlayer", MB_ICONERROR | MB_OK);
-		bLoaded = false;
-		bSplash = true;
-		return false;
-	}
-
 }
 
+//--------------------------------------------------------------
 void ofApp::CloseMovie() {
 
 	// Close volume dialog
 	CloseVolume();
-	myMovie.stop();
-	myMovie.close();
+	EndOpen();
+	scrub.Close();
+	ReleasePlayer();
+
+	// Release the seamless loop cache
+	bLoopPlay = false;
+	nLoopFrame = -1;
+	loopHead.Release();
+	loopTexture.clear();
+
+	// Cached clips are kept for the next movie
+	bClipPlay = false;
+	bClipHold = false;
+	clipTexture.clear();
+	yuvTexture.clear();
+	bPristine = false;
+	pristineTexture.clear();
+	bRepeatedFrame = false;
+	bHashPending = false;
+	bFrameHash = false;
+	frc.Start(movieFps);
+	slowMotion.Release();
+	deint.Release();
+	denoise.Release();
+	levels.Release();
+	ndiReadback.Release();
+	scopes.Release();
+	previewFbo.clear();
+	bPreviewDirty = true;
+	automation.Clear();
+	rawSource.Close();
+	sequence.Close();
+	still.Close();
+	clipSource = &clips;
 
 	nOldFrames = 0;
 	nNewFrames = 0;
@@ -1424,6 +3506,10 @@ void ofApp::CloseMovie() {
 //--------------------------------------------------------------
 void ofApp::ResetWindow(bool bCentre)
 {
+	// The headless window stays hidden
+	if (bHeadless)
+		return;
+
 	// Close volume dialog
 	CloseVolume();
 
@@ -1503,8 +3589,8 @@ void ofApp::appMenuFunction(string title, bool bChecked) {
 	// WM_ENTERMENULOOP and WM_EXITMENULOOP are returned by ofxWinMenu
 	// but are not required if WM_NCLBUTTONDOWN is tested.
 	if (title == "WM_NCLBUTTONDOWN") {
-		if (myMovie.isLoaded())
-			myMovie.setPaused(true);
+		if (bLoaded)
+			PauseMovie(true);
 		// WM_NCLBUTTONUP is not generated if the
 		// mouse is released on the title bar.
 		// Reset the flag when Draw() resumes 
@@ -1566,6 +3652,7 @@ void ofApp::appMenuFunction(string title, bool bChecked) {
 				OldSharpwidth = Sharpwidth;
 				OldAdaptive   = bAdaptive;
 				OldBlur       = Blur;
+				OldDenoise    = Denoise;
 				OldFlip       = bFlip;
 				OldMirror     = bMirror;
 				OldSwap       = bSwap;
@@ -1583,10 +3670,98 @@ void ofApp::appMenuFunction(string title, bool bChecked) {
 
 	if (title == "Loop") {
 		bLoop = bChecked;
-		if (bLoop)
-			myMovie.setLoopState(OF_LOOP_NORMAL);
+		menu->EnablePopupItem("    Seamless", bLoop);
+		SetLoopState();
+	}
+
+	if (title == "    Seamless") {
+		// Auto-check
+		bSeamless = bChecked;
+		SetLoopState();
+	}
+
+	if (title == "Deinterlace") {
+		// Auto-check
+		bDeinterlace = bChecked;
+		SetDeinterlace();
+	}
+
+	if (title == "    Double rate") {
+		bDoubleRate = bChecked;
+		SetDeinterlace();
+	}
+
+	if (title == "    Bottom field first") {
+		bBottomFirst = bChecked;
+		SetDeinterlace();
+	}
+
+	if (title == "YUV matrix auto") {
+		// Auto-check. The matrix continues from auto.
+		SetYuvMatrix(bChecked ? 0 : GetYuvMatrix() + 1);
+	}
+	if (title == "    BT.601")
+		SetYuvMatrix(1);
+	if (title == "    BT.709")
+		SetYuvMatrix(2);
+	if (title == "    BT.2020")
+		SetYuvMatrix(3);
+	if (title == "YUV full range") {
+		bYuvFullRange = bChecked;
+		SetYuvMatrix(yuvMatrix);
+	}
+
+	if (title == "Auto levels") {
+		// Auto-check
+		bAutoLevels = bChecked;
+		levels.Start();
+	}
+
+	if (title == "Effects") {
+		// Auto-check
+		bEffects = bChecked;
+		if (bEffects)
+			effects.Open(ofToDataPath("shaders", true));
 		else
-			myMovie.setLoopState(OF_LOOP_NONE);
+			effects.Close();
+	}
+
+	if (title == "Scopes") {
+		// Auto-check
+		bScopes = bChecked;
+		if (!bScopes)
+			scopes.Release();
+	}
+
+	if (title == "Preview") {
+		// Auto-check
+		bPreview = bChecked;
+		menu->EnablePopupItem("    Reduced rate", bPreview);
+		menu->EnablePopupItem("    Half size", bPreview);
+		bPreviewDirty = true;
+	}
+	if (title == "    Reduced rate") {
+		bPreviewRate = bChecked;
+		bPreviewDirty = true;
+	}
+	if (title == "    Half size") {
+		bPreviewHalfSize = bChecked;
+		bPreviewDirty = true;
+	}
+
+	if (title == "Memory cache") {
+		// Auto-check
+		bMemoryCache = bChecked;
+		if (bMemoryCache) {
+			// Start caching the current movie
+			if (bLoaded && clipSource == &clips)
+				clips.Begin(movieFile, myMovie.getTotalNumFrames()-1, (int)movieWidth, (int)movieHeight);
+		}
+		else {
+			// Return to the decoder and free the memory
+			StopClip();
+			clips.Release();
+		}
 	}
 
 	if (title == "Mute") {
@@ -1663,13 +3838,48 @@ void ofApp::appMenuFunction(string title, bool bChecked) {
 		NDIsender.SetAsync(bNDIasync);
 	}
 
+	if (title == "Fixed output rate") {
+		// Auto-check
+		bFrc = bChecked;
+		menu->EnablePopupItem("    Repeat", bFrc);
+		menu->EnablePopupItem("    Blend", bFrc);
+		menu->EnablePopupItem("    Motion", bFrc);
+		if (bFrc) {
+			frc.SetRate(frcRate);
+			frc.Start(movieFps);
+			NDIsender.SetFrameRate(frcRate);
+		}
+		else {
+			frc.Release();
+			NDIsender.SetFrameRate(60.0); // ofxNDI default
+		}
+		// Frames read back for NDI are from the other output
+		ndiReadback.Start();
+	}
+
+	if (title == "    Repeat")
+		SetFrcMethod(rateConverter::FRC_REPEAT);
+	if (title == "    Blend")
+		SetFrcMethod(rateConverter::FRC_BLEND);
+	if (title == "    Motion")
+		SetFrcMethod(rateConverter::FRC_MOTION);
+
+	if (title == "Skip repeated frames") {
+		// Auto-check
+		bSkipRepeated = bChecked;
+		bFrameHash = false;
+		bHashPending = false;
+		nRepeatedFrames = 0;
+		nNewFrames = 0;
+	}
+
 	//
 	// Help menu
 	//
 
 	if (title == "About") {
 		// Keep the movie in sync while the menu stops drawing
-		if (bLoaded) myMovie.setPaused(true);
+		if (bLoaded) PauseMovie(true);
 		char about[1024]{};
 		DWORD dwSize = 0;
 		DWORD dummy = 0;
@@ -1698,12 +3908,12 @@ void ofApp::appMenuFunction(string title, bool bChecked) {
 
 		// Newtek credit
 		strcat_s(about, 1024, "                <a href=\"https://www.ndi.tv/\">NDI</a>     ");
-		strcat_s(about, 1024, NDInumber.c_str());
+		strcat_s(about, 1024, GetNDInumber().c_str());
 
 		HICON hIcon = LoadIcon(g_hInstance, MAKEINTRESOURCE(IDI_SPOUTICON));
 		spoutsender->SpoutMessageBoxIcon(hIcon);
 		spoutsender->SpoutMessageBox(NULL, about, "About", MB_USERICON | MB_OK);
-		if (bLoaded && !bPaused) myMovie.setPaused(false);
+		if (bLoaded && !bPaused) PauseMovie(false);
 	}
 
 	if (title == "Information") {
@@ -1716,6 +3926,9 @@ void ofApp::appMenuFunction(string title, bool bChecked) {
 //--------------------------------------------------------------
 void ofApp::doFullScreen(bool bFullscreen)
 {
+	if (bHeadless)
+		return;
+
 	RECT rectTaskBar;
 	HWND hWndTaskBar;
 	HWND hWndMode;
@@ -1829,6 +4042,9 @@ void ofApp::doFullScreen(bool bFullscreen)
 //--------------------------------------------------------------
 void ofApp::doTopmost(bool bTop)
 {
+	if (bHeadless)
+		return;
+
 	if (bTop) {
 		// Get the current top window for return
 		hWndForeground = GetForegroundWindow();
@@ -1865,6 +4081,31 @@ void ofApp::WriteInitFile(const char* initfile)
 	else
 		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"loop", (LPCSTR)"0", (LPCSTR)initfile);
 
+	if (bSeamless)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"seamless", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"seamless", (LPCSTR)"0", (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%d", nLoopFrames);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"loopframes", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	if (bMemoryCache)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"memorycache", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"memorycache", (LPCSTR)"0", (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%d", nCacheSize);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"cachesize", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%.2f", sequenceFps);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"sequencefps", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%d", nSequenceThreads);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"sequencethreads", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%.2f", stillNdiRate);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"stillndirate", (LPCSTR)tmp, (LPCSTR)initfile);
+
 	if (bResizeWindow)
 		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"resize", (LPCSTR)"1", (LPCSTR)initfile);
 	else
@@ -1890,6 +4131,66 @@ void ofApp::WriteInitFile(const char* initfile)
 	else
 		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"async", (LPCSTR)"0", (LPCSTR)initfile);
 
+	if (bSkipRepeated)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"skiprepeated", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"skiprepeated", (LPCSTR)"0", (LPCSTR)initfile);
+
+	if (bFrc)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"frc", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"frc", (LPCSTR)"0", (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%.3f", frcRate);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"frcrate", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%d", frcMethod);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"frcmethod", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%d", deint.GetMode());
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"deinterlace", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	if (bBottomFirst)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"bottomfirst", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"bottomfirst", (LPCSTR)"0", (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%d", yuvMatrix);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"yuvmatrix", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	if (bYuvFullRange)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"yuvfullrange", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"yuvfullrange", (LPCSTR)"0", (LPCSTR)initfile);
+
+	if (bEffects)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"effects", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"effects", (LPCSTR)"0", (LPCSTR)initfile);
+
+	if (bScopes)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"scopes", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"scopes", (LPCSTR)"0", (LPCSTR)initfile);
+
+	if (bPreview)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"preview", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"preview", (LPCSTR)"0", (LPCSTR)initfile);
+
+	if (bPreviewRate)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"previewrate", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"previewrate", (LPCSTR)"0", (LPCSTR)initfile);
+
+	sprintf_s(tmp, MAX_PATH, "%d", previewInterval);
+	WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"previewinterval", (LPCSTR)tmp, (LPCSTR)initfile);
+
+	if (bPreviewHalfSize)
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"previewhalfsize", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Options", (LPCSTR)"previewhalfsize", (LPCSTR)"0", (LPCSTR)initfile);
+
 	// Volume
 	sprintf_s(tmp, 256, "%-8.2f", movieVolume); tmp[8] = 0;
 	WritePrivateProfileStringA((LPCSTR)"Audio", (LPCSTR)"volume", (LPCSTR)tmp, (LPCSTR)initfile);
@@ -1905,6 +4206,8 @@ void ofApp::WriteInitFile(const char* initfile)
 	WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Gamma", (LPCSTR)tmp, (LPCSTR)initfile);
 	sprintf_s(tmp, MAX_PATH, "%.3f", Blur);
 	WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Blur", (LPCSTR)tmp, (LPCSTR)initfile);
+	sprintf_s(tmp, MAX_PATH, "%.3f", Denoise);
+	WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Denoise", (LPCSTR)tmp, (LPCSTR)initfile);
 	sprintf_s(tmp, MAX_PATH, "%.3f", Sharpness);
 	WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Sharpness", (LPCSTR)tmp, (LPCSTR)initfile);
 	sprintf_s(tmp, MAX_PATH, "%.3f", Sharpwidth);
@@ -1913,6 +4216,10 @@ void ofApp::WriteInitFile(const char* initfile)
 		WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Adaptive", (LPCSTR)"1", (LPCSTR)initfile);
 	else
 		WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Adaptive", (LPCSTR)"0", (LPCSTR)initfile);
+	if (bAutoLevels)
+		WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Autolevels", (LPCSTR)"1", (LPCSTR)initfile);
+	else
+		WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Autolevels", (LPCSTR)"0", (LPCSTR)initfile);
 	if (bFlip)
 		WritePrivateProfileStringA((LPCSTR)"Adjust", (LPCSTR)"Flip", (LPCSTR)"1", (LPCSTR)initfile);
 	else
@@ -1944,6 +4251,40 @@ void ofApp::ReadInitFile()
 	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"loop", NULL, (LPSTR)tmp, 3, initfile);
 	if (tmp[0]) bLoop = (atoi(tmp) == 1);
 
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"seamless", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bSeamless = (atoi(tmp) == 1);
+
+	// Number of cached frames 1 - 60
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"loopframes", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) nLoopFrames = atoi(tmp);
+	if (nLoopFrames < 1)  nLoopFrames = 1;
+	if (nLoopFrames > 60) nLoopFrames = 60;
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"memorycache", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bMemoryCache = (atoi(tmp) == 1);
+
+	// Memory cache size (MB)
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"cachesize", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) nCacheSize = atoi(tmp);
+	clips.SetBudget(nCacheSize);
+	nCacheSize = clips.GetBudget();
+
+	// Image sequence frame rate and decoder threads (0 - all cores less one)
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"sequencefps", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) sequenceFps = atof(tmp);
+	if (sequenceFps <= 0.0) sequenceFps = 30.0;
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"sequencethreads", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) nSequenceThreads = atoi(tmp);
+	if (nSequenceThreads < 0)  nSequenceThreads = 0;
+	if (nSequenceThreads > 64) nSequenceThreads = 64;
+
+	// NDI frames per second for an unchanged still image (0 - none)
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"stillndirate", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) stillNdiRate = (float)atof(tmp);
+	if (stillNdiRate < 0.0f)  stillNdiRate = 0.0f;
+	if (stillNdiRate > 30.0f) stillNdiRate = 30.0f;
+
 	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"resize", NULL, (LPSTR)tmp, 3, initfile);
 	if (tmp[0]) bResizeWindow = (atoi(tmp) == 1);
 
@@ -1959,12 +4300,74 @@ void ofApp::ReadInitFile()
 	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"async", NULL, (LPSTR)tmp, 3, initfile);
 	if (tmp[0]) bNDIasync = (atoi(tmp) == 1);
 
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"skiprepeated", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bSkipRepeated = (atoi(tmp) == 1);
+
+	// Frame rate conversion to a fixed output rate
+	// Methods : 0 repeat, 1 blend, 2 motion
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"frc", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bFrc = (atoi(tmp) == 1);
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"frcrate", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) frcRate = atof(tmp);
+	if (frcRate < 1.0)   frcRate = 60.0;
+	if (frcRate > 240.0) frcRate = 240.0;
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"frcmethod", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) frcMethod = atoi(tmp);
+	if (frcMethod < 0 || frcMethod >= rateConverter::FRC_METHODS)
+		frcMethod = rateConverter::FRC_BLEND;
+
+	// Deinterlace : 0 off, 1 single rate, 2 double rate
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"deinterlace", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) {
+		int mode = atoi(tmp);
+		bDeinterlace = (mode == deinterlacer::DEINT_SINGLE || mode == deinterlacer::DEINT_DOUBLE);
+		bDoubleRate = (mode == deinterlacer::DEINT_DOUBLE);
+	}
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"bottomfirst", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bBottomFirst = (atoi(tmp) == 1);
+
+	// YUV matrix : 0 auto, 1 BT.601, 2 BT.709, 3 BT.2020
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"yuvmatrix", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) yuvMatrix = atoi(tmp);
+	if (yuvMatrix < 0 || yuvMatrix > 3)
+		yuvMatrix = 0;
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"yuvfullrange", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bYuvFullRange = (atoi(tmp) == 1);
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"effects", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bEffects = (atoi(tmp) == 1);
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"scopes", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bScopes = (atoi(tmp) == 1);
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"preview", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bPreview = (atoi(tmp) == 1);
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"previewrate", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bPreviewRate = (atoi(tmp) == 1);
+
+	// New frames for each preview at reduced rate 2 - 30
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"previewinterval", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) previewInterval = atoi(tmp);
+	if (previewInterval < 2)  previewInterval = 2;
+	if (previewInterval > 30) previewInterval = 30;
+
+	GetPrivateProfileStringA((LPCSTR)"Options", (LPSTR)"previewhalfsize", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bPreviewHalfSize = (atoi(tmp) == 1);
+
 	// Volume
 	if (GetPrivateProfileStringA((LPCSTR)"Audio", (LPSTR)"volume", (LPSTR)"1.00", (LPSTR)tmp, 8, initfile) > 0)
 		movieVolume = atof(tmp);
 
 	// Set up menus etc (menu must have been set up)
 	menu->SetPopupItem("Loop", bLoop);
+	menu->SetPopupItem("    Seamless", bSeamless);
+	menu->EnablePopupItem("    Seamless", bLoop);
+	menu->SetPopupItem("Memory cache", bMemoryCache);
 	menu->SetPopupItem("Resize", bResizeWindow);
 	menu->SetPopupItem("Topmost", bTopmost);
 	menu->SetPopupItem("Spout", bSpoutOut);
@@ -1974,6 +4377,26 @@ void ofApp::ReadInitFile()
 		menu->EnablePopupItem("    Async", true);
 	else
 		menu->EnablePopupItem("    Async", false);
+	menu->SetPopupItem("Skip repeated frames", bSkipRepeated);
+	menu->SetPopupItem("Fixed output rate", bFrc);
+	menu->EnablePopupItem("    Repeat", bFrc);
+	menu->EnablePopupItem("    Blend", bFrc);
+	menu->EnablePopupItem("    Motion", bFrc);
+	SetFrcMethod(frcMethod);
+	frc.SetRate(frcRate);
+	if (bFrc)
+		NDIsender.SetFrameRate(frcRate);
+	SetDeinterlace();
+	SetYuvMatrix(yuvMatrix);
+	menu->SetPopupItem("Scopes", bScopes);
+	menu->SetPopupItem("Preview", bPreview);
+	menu->SetPopupItem("    Reduced rate", bPreviewRate);
+	menu->SetPopupItem("    Half size", bPreviewHalfSize);
+	menu->EnablePopupItem("    Reduced rate", bPreview);
+	menu->EnablePopupItem("    Half size", bPreview);
+	menu->SetPopupItem("Effects", bEffects);
+	if (bEffects)
+		effects.Open(ofToDataPath("shaders", true));
 
 	// Image adjustment
 	// Brightness    -1 - 1   default 0
@@ -1991,18 +4414,25 @@ void ofApp::ReadInitFile()
 	if (tmp[0]) Gamma = (float)atof(tmp);
 	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"Blur", NULL, (LPSTR)tmp, 8, initfile);
 	if (tmp[0]) Blur = (float)atof(tmp);
+	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"Denoise", NULL, (LPSTR)tmp, 8, initfile);
+	if (tmp[0]) Denoise = (float)atof(tmp);
+	if (Denoise < 0.0f) Denoise = 0.0f;
+	if (Denoise > 1.0f) Denoise = 1.0f;
 	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"Sharpness", NULL, (LPSTR)tmp, 8, initfile);
 	if (tmp[0]) Sharpness = (float)atof(tmp);
 	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"Sharpwidth", NULL, (LPSTR)tmp, 8, initfile);
 	if (tmp[0]) Sharpwidth = (float)atof(tmp);
 	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"Adaptive", NULL, (LPSTR)tmp, 3, initfile);
 	if (tmp[0]) bAdaptive = (atoi(tmp) == 1);
+	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"Autolevels", NULL, (LPSTR)tmp, 3, initfile);
+	if (tmp[0]) bAutoLevels = (atoi(tmp) == 1);
 	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"bFlip", NULL, (LPSTR)tmp, 3, initfile);
 	if (tmp[0]) bFlip = (atoi(tmp) == 1);
 	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"bMirror", NULL, (LPSTR)tmp, 3, initfile);
 	if (tmp[0]) bMirror = (atoi(tmp) == 1);
 	GetPrivateProfileStringA((LPCSTR)"Adjust", (LPSTR)"bSwap", NULL, (LPSTR)tmp, 3, initfile);
 	if (tmp[0]) bSwap = (atoi(tmp) == 1);
+	menu->SetPopupItem("Auto levels", bAutoLevels);
 
 }
 
@@ -2013,17 +4443,24 @@ void ofApp::ReadInitFile()
 int ofApp::doMessageBox(HWND hwnd, LPCSTR message, LPCSTR caption, UINT uType)
 {
 	int iRet = 0;
+
+	// Nobody to answer in headless mode
+	if (bHeadless) {
+		SpoutLogWarning("%s - %s", caption, message);
+		return IDOK;
+	}
+
 	bMessageBox = true; // To skip mouse events
 
 	// Pause the movie or it still plays in the background
 	if (bLoaded)
-		myMovie.setPaused(true);
+		PauseMovie(true);
 
 	// Keep the messagebox topmost
 	iRet = spoutsender->SpoutMessageBox(hwnd, message, caption, uType | MB_TOPMOST);
 
 	if (bLoaded && !bPaused)
-		myMovie.setPaused(false);
+		PauseMovie(false);
 
 	bMessageBox = false;
 
@@ -2070,7 +4507,7 @@ INT_PTR CALLBACK About(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam)
 		strcat_s(about, 1024, "\n\n");
 		strcat_s(about, 1024, "  NewTek NDI - Version ");
 		// Add NewTek library version number (dll)
-		strcat_s(about, 1024, NDInumber.c_str());
+		strcat_s(about, 1024, pThis->GetNDInumber().c_str());
 		strcat_s(about, 1024, "\n  NDI is a trademark of NewTek, Inc.");
 		SetDlgItemTextA(hDlg, IDC_ABOUT_TEXT, (LPCSTR)about);
 
@@ -2269,6 +4706,15 @@ LRESULT CALLBACK UserAdjust(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 		sprintf_s(str1, 256, "%.3f", pThis->Blur);
 		SetDlgItemTextA(hDlg, IDC_BLUR_TEXT, (LPCSTR)str1);
 
+		hBar = GetDlgItem(hDlg, IDC_DENOISE);
+		SendMessage(hBar, TBM_SETRANGEMIN, (WPARAM)1, (LPARAM)0);
+		SendMessage(hBar, TBM_SETRANGEMAX, (WPARAM)1, (LPARAM)100);
+		SendMessage(hBar, TBM_SETPAGESIZE, (WPARAM)1, (LPARAM)10);
+		iPos = (int)(pThis->Denoise * 100.0f);
+		SendMessage(hBar, TBM_SETPOS, (WPARAM)1, (LPARAM)iPos);
+		sprintf_s(str1, 256, "%.3f", pThis->Denoise);
+		SetDlgItemTextA(hDlg, IDC_DENOISE_TEXT, (LPCSTR)str1);
+
 		// Sharpness width radio buttons
 		// 3x3, 5x5, 7x7
 		iPos = ((int)pThis->Sharpwidth-3)/2; // 0, 1, 2
@@ -2343,6 +4789,14 @@ LRESULT CALLBACK UserAdjust(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 			sprintf_s(str1, 256, "%.3f", fValue);
 			SetDlgItemTextA(hDlg, IDC_BLUR_TEXT, (LPCSTR)str1);
 		}
+		else if (hBar == GetDlgItem(hDlg, IDC_DENOISE)) {
+			// 0 - 100 > 0 - 1
+			iPos = SendMessage(hBar, TBM_GETPOS, 0, 0);
+			fValue = ((float)iPos) / 100.0f;
+			pThis->Denoise = fValue;
+			sprintf_s(str1, 256, "%.3f", fValue);
+			SetDlgItemTextA(hDlg, IDC_DENOISE_TEXT, (LPCSTR)str1);
+		}
 		break;
 
 	case WM_DESTROY:
@@ -2401,6 +4855,7 @@ LRESULT CALLBACK UserAdjust(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 			pThis->Sharpwidth = pThis->OldSharpwidth;
 			pThis->bAdaptive  = pThis->OldAdaptive;
 			pThis->Blur       = pThis->OldBlur;
+			pThis->Denoise    = pThis->OldDenoise;
 			pThis->bFlip      = pThis->OldFlip;
 			pThis->bMirror    = pThis->OldMirror;
 			pThis->bSwap      = pThis->OldSwap;
@@ -2413,6 +4868,7 @@ LRESULT CALLBACK UserAdjust(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 			pThis->Saturation = 1.0; //  0 - 1 - 4 default 1
 			pThis->Gamma      = 1.0; //  0 - 1 - 4 default 1
 			pThis->Blur       = 0.0;
+			pThis->Denoise    = 0.0; //  0 - 1 default 0
 			pThis->Sharpness  = 0.0; //  0 - 4 default 0
 			pThis->Sharpwidth = 3.0;
 			pThis->bAdaptive  = false;
@@ -2433,6 +4889,7 @@ LRESULT CALLBACK UserAdjust(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 			pThis->Saturation = pThis->OldSaturation;
 			pThis->Gamma      = pThis->OldGamma;
 			pThis->Blur       = pThis->OldBlur;
+			pThis->Denoise    = pThis->OldDenoise;
 			pThis->Sharpness  = pThis->OldSharpness;
 			pThis->Sharpwidth = pThis->OldSharpwidth;
 			pThis->bAdaptive  = pThis->OldAdaptive;
@@ -32,6 +32,26 @@
 #include "ofxWinMenu.h" // Addon for a windows style menu
 #include "ofxNDI.h" // Addon for NDI streaming
 #include "SpoutGL\SpoutShaders.h" // For image adjust
+#include "LoopCache.h" // For seamless loop
+#include "ClipCache.h" // For memory cache
+#include "RawMovie.h" // For uncompressed movies
+#include "ImageSequence.h" // For numbered image files
+#include "StillImage.h" // For a single image
+#include "RateConverter.h" // For a fixed output rate
+#include "Deinterlacer.h" // For interlaced movies
+#include "Denoiser.h" // For temporal noise reduction
+#include "VideoScopes.h" // For histogram, waveform and vectorscope
+#include "AutoLevels.h" // For automatic levels
+#include "FrameReadback.h" // For processed frames sent by NDI
+#include "EffectChain.h" // For user shader effects
+#include "Keyframes.h" // For adjustments over the timeline
+#include "TextOverlay.h" // For cached information text
+#include "UiAssets.h" // For splash image and icons
+#include "MediaProbe.h" // For movies opened before
+#include "ScrubThumbnails.h" // For progress bar previews
+#include "DecoderThread.h" // For movies opened in the background
+#include "CueList.h" // For scheduled playback
+#include "SyncClock.h" // For instances in sync
 #include "resource.h"
 #include <shlwapi.h>  // for path functions
 #include <Shellapi.h> // for shellexecute
@@ -74,6 +94,7 @@ public:
 	float Saturation = 1.0;
 	float Gamma      = 1.0;
 	float Blur       = 0.0;
+	float Denoise    = 0.0; // Temporal denoise strength 0 - 1
 	float Sharpness  = 0.0;
 	float Sharpwidth = 3.0; // 3x3, 5x5, 7x7
 	bool bAdaptive   = false; // CAS adaptive sharpen
@@ -87,6 +108,7 @@ public:
 	float OldSaturation = 1.0;
 	float OldGamma      = 1.0;
 	float OldBlur       = 0.0;
+	float OldDenoise    = 0.0;
 	float OldSharpness  = 0.0;
 	float OldSharpwidth = 3.0;
 	bool OldAdaptive    = false;
@@ -100,22 +122,14 @@ public:
 
 	// Movie
 	ofVideoPlayer myMovie; // Movie to send
-	ofImage splashImage; // Startup splash image
 	string movieFile;
 	float movieWidth = 0;
 	float movieHeight = 0;
+	float movieFps = 30.0f; // Frame rate from the number of frames and duration
+	bool bNewFrame = false; // New movie or cached frame to process and send
 
-	// icons and controlbar
-	ofImage icon_reverse;
-	ofImage	icon_fastforward;
-	ofImage	icon_play;
-	ofImage	icon_pause;
-	ofImage	icon_forward;
-	ofImage	icon_back;
-	ofImage	icon_stop;
-	ofImage	icon_full_screen;
-	ofImage	icon_sound;
-	ofImage	icon_mute;
+	// Splash image and icon atlas for the controlbar
+	uiAssets assets;
 
 	// Things to display the icons
 	ofRectangle	icon_background;
@@ -151,7 +165,8 @@ public:
 	ofColor		icon_highlight_color;
 	ofColor		icon_background_color;
 
-	ofFbo iconFbo;
+	ofFbo iconFbo; // Control bar drawn when it changes (premultiplied alpha)
+	unsigned int playBarState = 0; // Button states drawn in iconFbo
 	ofFbo myFbo;
 
 	// progress bar
@@ -175,7 +190,198 @@ public:
 	void setVideoPlaypause();
 	void HandleControlButtons(float x, float y, int button = 0);
 	void drawPlayBar();
+	void RenderPlayBar();
+	void DrawPlayButton(int icon, float x, float y, bool bHover);
 	void CloseVolume();
+	void SetLoopState();
+
+	// Seamless loop
+	loopCache loopHead; // First frames of the movie
+	ofTexture loopTexture; // Cached frame being played
+	bool bSeamless = false; // Loop from the cache instead of seeking to the start
+	int nLoopFrames = 8; // Number of frames cached
+	bool bLoopPlay = false; // Playing the cached frames
+	int nLoopFrame = -1; // Cached frame being played
+	int nLastFrame = 0; // Previous movie frame to detect the loop point
+	bool bLoopSeek = false; // The decoder has a frame after the cached frames
+	double loopStartTime = 0.0; // Start of cached frame playback (microseconds)
+	bool UpdateLoop();
+	void CancelLoop();
+
+	// Memory cache
+	clipCache clips; // Decoded frames of recent movies
+	ofTexture clipTexture; // Cached frame being played
+	bool bMemoryCache = false; // Play from memory after the first pass
+	int nCacheSize = 4096; // Cache size budget (MB)
+	bool bClipPlay = false; // Playing frames from memory
+	bool bClipHold = false; // Hold the current frame while a dialog is open
+	int nClipFrame = 0; // Frame being played from memory
+	double clipStartTime = 0.0; // Time of the first frame (microseconds)
+	frameSource* clipSource = &clips; // Memory cache, raw movie or image sequence
+	rawMovie rawSource; // Memory mapped uncompressed movie
+	ofTexture yuvTexture; // Nv12 frame packed 4 bytes to a texel
+	int yuvMatrix = 0; // 0 auto, 1 BT.601, 2 BT.709, 3 BT.2020
+	bool bYuvFullRange = false; // Full rather than limited range
+	void SetYuvMatrix(int matrix);
+	int GetYuvMatrix(); // Matrix for the shader 0 - 2
+	imageSequence sequence; // Numbered image files
+	double sequenceFps = 30.0; // Image sequence frame rate
+	int nSequenceThreads = 0; // Image decoder threads (0 - all cores less one)
+	bool bSequenceBench = false; // Decode benchmark when a sequence is opened
+	int nClipSeek = -1; // Frame to show when it has been decoded
+	stillImage still; // Image that is not numbered
+	bool bStillDirty = false; // Still image to be processed and sent
+	float stillNdiRate = 1.0f; // NDI frames per second for an unchanged still
+	float ndiSendTime = 0.0f; // Time of the last NDI frame (seconds)
+	frameReadback ndiReadback; // Processed frames read from the fbo for NDI
+	ofPixels ndiPixels;
+	// Adjustments when last processed. The settings are followed by
+	// the keyframe values and the auto levels.
+	enum { ADJUST_SETTINGS = 15, ADJUST_VALUES = ADJUST_SETTINGS + keyframes::KEY_PARAMS + 3 };
+	float lastAdjust[ADJUST_VALUES]{};
+	bool bLastAdjust = false; // lastAdjust is set
+	float keyValues[keyframes::KEY_PARAMS]{}; // Keyframe values at keyFrame
+	int keyFrame = -1; // Frame the keyframes were evaluated for
+	void UpdateStill();
+	bool AdjustChanged();
+
+	// Original of the frame being shown
+	ofTexture pristineTexture;
+	bool bPristine = false; // pristineTexture has the current frame
+	bool ProcessFrame(bool bRestore, bool bField = false);
+
+	// Deinterlace before the adjustments
+	deinterlacer deint;
+	bool bDeinterlace = false; // Motion adaptive deinterlace
+	bool bDoubleRate = false; // A frame for each field
+	bool bBottomFirst = false; // Field order
+	double fieldTime = 0.0; // Time to show the second field (microseconds)
+	void SetDeinterlace();
+	double GetSourceRate();
+
+	// Temporal denoise with the adjustments
+	temporalDenoise denoise;
+	bool bDenoiseBench = false; // Denoise benchmark when the first frame is processed
+
+	// Automatic levels replace brightness, contrast and gamma
+	autoLevels levels;
+	bool bAutoLevels = false;
+
+	// Keyframed adjustments from "movie.keys"
+	keyframes automation;
+
+	// Stream parameters and first frame thumbnail of movies opened before.
+	// With a probe, the senders are created and the thumbnail is shown
+	// and sent while the decoder thread opens the movie. The player is
+	// played here when it is ready and given back to the thread to close.
+	mediaProbe probes;
+	mediaProbe::info openProbe;
+	decoderThread decoder;
+	bool bProbeStore = false; // Store the probe from the first frame
+	bool bOpening = false; // Thumbnail shown until the decoder is opened
+	int nOpeningFrames = 0; // Draw cycles while opening
+	int nOpenJob = -1; // Decoder thread job
+	int nOpenFrame = -1; // Frame to show first, e.g. for a cue
+	void StartOpen();
+	void UpdateOpening();
+	void EndOpen();
+	void StoreProbe();
+	void ReleasePlayer();
+
+	// Thumbnails over the movie timeline shown above the progress bar
+	scrubThumbnails scrub;
+	bool bScrubHover = false;
+	float scrubPos = 0.0f; // movie position under the mouse
+	void DrawScrubThumbnail();
+
+	// Scheduled playback from a cue file (command line "-cues").
+	// The decoder of the next "play" cue is opened and seeked by the
+	// decoder thread before the cue time. The player is checked each
+	// update cycle without waiting and played at the cue time.
+	cueList cues;
+	std::string cueFile;
+	int nPrerollCue = -1;
+	int nPrerollJob = -1; // Decoder thread job
+	std::string prerollPath;
+	std::shared_ptr<ofBaseVideoPlayer> prerollPlayer; // Ready at the cue frame
+	bool bPrerolled = false; // Movie opened from the pre-roll player
+	void UpdateCues();
+	void FireCue(int index);
+	void StartPreroll(int index);
+	void UpdatePreroll();
+	void EndPreroll();
+	bool UsePreroll(std::string path);
+
+	// Media time shared with other instances (command line
+	// "-sync master" or "-sync follow"). A follower slews its
+	// speed or skips to stay within a frame of the master.
+	syncClock sync;
+	std::string syncMode;
+	double syncRate = 1.0; // speed correction of a follower
+	double syncLogTime = 0.0; // seconds
+	void UpdateSync();
+	double GetMediaTime();
+	double GetMediaDuration();
+
+	// User compute shader effects from "data/shaders"
+	effectChain effects;
+	bool bEffects = false;
+
+	// Scopes of the processed frame shown in the window only
+	videoScopes scopes;
+	bool bScopes = false;
+
+	// Window preview independent of the output. The preview can be off,
+	// updated for one in previewInterval new frames or drawn from a half
+	// size copy. Nothing is drawn while the window is minimized.
+	bool bPreview = true;
+	bool bPreviewRate = false; // Reduced rate
+	bool bPreviewHalfSize = false; // Half size copy
+	int previewInterval = 2; // New frames for each update at reduced rate (ini previewinterval)
+	int previewFrames = 0;
+	bool bPreviewDirty = true; // Update the copy on the next draw
+	ofFbo previewFbo;
+	void DrawPreview(float x, float width);
+
+	// Frames identical to the last one sent
+	bool bSkipRepeated = false; // Do not send repeated frames
+	bool bRepeatedFrame = false; // The new frame is the same as the last
+	bool bFrameHash = false; // frameHash is for the last frame sent
+	uint64_t frameHash = 0; // Hash of the last frame before the shaders
+	int nRepeatedFrames = 0; // Frames not sent
+	bool bHashPending = false; // Hash of the last frame not read yet
+	ofTexture repeatTexture; // Processed output of the frame with frameHash
+	void HashFrame();
+	bool FrameRepeated();
+	void SaveRepeated();
+	bool RestoreRepeated();
+	void SendNDIframe();
+	void SendNDIreadback();
+
+	// Frame rate conversion
+	rateConverter frc; // Output frames at a fixed rate
+	bool bFrc = false; // Send at the fixed rate instead of for each new frame
+	double frcRate = 60.0; // Output frame rate
+	int frcMethod = rateConverter::FRC_BLEND; // Repeat, blend or motion
+	void SetFrcMethod(int method);
+	void SendFrcFrame();
+
+	// Variable speed playback
+	float playSpeed = 1.0f; // 0.1 - 8 times the movie rate
+	int nPlayStep = 1; // Frames between those shown by each draw cycle
+	int nShownFrames = 0; // Frames shown at the current speed
+	int nSkippedFrames = 0; // Frames passed over at fast speeds
+	int nLastShown = -1; // Movie frame number last shown
+	rateConverter slowMotion; // Frames blended at slow speeds
+	void SetSpeed(float speed);
+	void CountSkipped(int frame);
+	void AddSourceFrame();
+	void UpdateClip();
+	void SetClipFrame(int frame);
+	bool LoadClipFrame(int frame);
+	void StopClip();
+	void PauseMovie(bool bPause);
+	float GetMoviePosition();
 
 	// Menu
 	ofxWinMenu* menu = nullptr; // Menu object
@@ -231,10 +437,35 @@ public:
 	void ParseCommandLine(LPSTR lpCmdLine);
 	std::string FindArgString(std::string line, std::string arg);
 
+	// Headless server mode with no window, menu or preview (command line "-headless 1")
+	// Frames are decoded, processed and sent. Messages are logged to SpoutVideoPlayer.log.
+	bool bHeadless = false;
+	void DrawWindow();
+	void SendFrames();
+
+	// Startup and draw cycle times logged to compare with headless mode
+	// (command line "-drawbench 1")
+	bool bDrawBench = false;
+	GLuint drawQuery[4]{}; // GPU time stamps, start and end of alternate cycles
+	bool bDrawQuery[2]{};
+	int drawSlot = 0;
+	int drawCycles = 0;
+	double drawCpuTime = 0.0; // msec totals since the last log
+	double drawGpuTime = 0.0;
+	int drawGpuCycles = 0;
+	double drawLogTime = 0.0; // seconds
+	void BeginDrawTiming();
+	void EndDrawTiming(uint64_t startMicros);
+	double GetProcessTime(); // msec from the start of the process
+	bool bFirstSent = false; // Time to the first frame sent has been logged
+
 
 	int doMessageBox(HWND hwnd, LPCSTR message, LPCSTR caption, UINT uType);
 
-	ofTrueTypeFont myFont;
+	ofTrueTypeFont myFont; // Loaded when first used (see LoadFont)
+	void LoadFont();
+	std::string GetNDInumber(); // NDI library version number when first used
+	textOverlay infoText; // Information lines refreshed 4 times a second
 	char info[1024]{}; // for info box
 
 	// For received frame fps calculations
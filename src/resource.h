@@ -38,4 +38,6 @@
 #define IDC_SHARPNESS_7x7                       30018
 #define IDC_SWAP                                30019
 #define IDC_ADAPTIVE                            30020
+#define IDC_DENOISE                             30021
+#define IDC_DENOISE_TEXT                        30022
 
@@ -0,0 +1,799 @@
+/*
+
+	rawtool.cpp
+
+	Spout Video Player
+
+	Converter and benchmark for the uncompressed raw movie container (.svr).
+	Benchmarks of the CPU references of the player's shaders.
+	Test of the clock shared by player instances.
+
+	Build :
+
+	  Windows : cl /O2 /EHsc rawtool.cpp ..\..\src\RawMovie.cpp ..\..\src\DeinterlaceCpu.cpp ..\..\src\DenoiseCpu.cpp ..\..\src\SyncClock.cpp
+	  Linux   : g++ -O2 -std=c++17 rawtool.cpp ../../src/RawMovie.cpp ../../src/DeinterlaceCpu.cpp ../../src/DenoiseCpu.cpp ../../src/SyncClock.cpp -o rawtool -lrt
+
+	Usage :
+
+	  rawtool convert <input.rgba | -> <output.svr> <width> <height> <fps> [nv12]
+
+	    The frame rate is a number or a ratio, e.g. 25, 29.97 or 30000/1001.
+	    23.976, 29.97, 59.94 and the other NTSC rates are n*1000/1001.
+
+	    Convert a stream of raw rgba or nv12 frames. Any movie can be
+	    converted with FFmpeg, for example :
+
+	      ffmpeg -i movie.mp4 -f rawvideo -pix_fmt rgba - | rawtool convert - movie.svr 3840 2160 60
+	      ffmpeg -i movie.mp4 -f rawvideo -pix_fmt nv12 - | rawtool convert - movie.svr 3840 2160 60 nv12
+
+	    Nv12 keeps the decoder's native YUV planes at 1.5 bytes per pixel.
+	    The player converts them with the matrix and range of the View menu.
+	    The width must be a multiple of 4.
+
+	  rawtool generate <output.svr> <width> <height> <fps> <frames> [nv12]
+
+	    Create a test movie with a moving pattern.
+	    Nv12 is BT.709 limited range.
+
+	  rawtool bench <input.svr> [seconds] [fps] [mapped]
+
+	    Sustained sequential read throughput compared with the frame
+	    rate to be sustained, by default that of the movie. Frames are
+	    read without the page cache (FILE_FLAG_NO_BUFFERING or O_DIRECT)
+	    by 4 readers, as many as the frames read ahead for playback.
+	    "mapped" reads from the mapping as playback does, which measures
+	    the page cache unless the movie is larger than the memory.
+	    For 3840x2160 at 60 fps rgba needs 1.99 GB/sec and nv12 0.75 GB/sec.
+
+	  rawtool deinterlace <input.svr> <output.svr> [double] [bff]
+
+	    Deinterlace an rgba movie with the CPU reference of the player's compute
+	    shader. "double" for a frame for each field, "bff" for bottom
+	    field first. The SSE2 result of the first frame is checked
+	    against the scalar result.
+
+	  rawtool denoise [width] [height] [frames] [sigma]
+
+	    Temporal denoise quality on a synthetic sequence with gaussian
+	    noise (default 1280x720, 120 frames, sigma 8). PSNR against the
+	    clean sequence of the noisy and denoised frames for each strength,
+	    for all pixels and for the pixels that move, and msec per frame.
+
+	  rawtool sync <master | follow> [seconds] [drift] [offset]
+
+	    A simulated player on the clock shared by player instances
+	    (default 60 seconds). Its clock runs fast or slow by the drift in
+	    parts per million and a follower starts offset by the msec given.
+	    A follower corrects its media time as the player does and prints
+	    the offset statistics each second. Start one master and several
+	    followers in separate terminals, for example :
+
+	      rawtool sync master 120
+	      rawtool sync follow 120 2000 500
+	      rawtool sync follow 120 -3000
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU Lesser General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU Lesser General Public License for more details.
+
+	You should have received a copy of the GNU Lesser General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+	19.10.26	- first version
+
+*/
+#include "../../src/RawMovie.h"
+#include "../../src/DeinterlaceCpu.h"
+#include "../../src/DenoiseCpu.h"
+#include "../../src/SyncClock.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static void Usage()
+{
+	printf("rawtool convert <input.rgba | -> <output.svr> <width> <height> <fps> [nv12]\n");
+	printf("rawtool generate <output.svr> <width> <height> <fps> <frames> [nv12]\n");
+	printf("rawtool bench <input.svr> [seconds] [fps] [mapped]\n");
+	printf("rawtool deinterlace <input.svr> <output.svr> [double] [bff]\n");
+	printf("rawtool denoise [width] [height] [frames] [sigma]\n");
+	printf("rawtool sync <master | follow> [seconds] [drift] [offset]\n");
+}
+
+//---------------------------------------------------------
+// Frame rate "num/den" or a decimal. A decimal rate within 0.005 of
+// n*1000/1001 is that NTSC rate, e.g. 23.976 is 24000/1001.
+static bool ParseFps(const char* str, unsigned int &num, unsigned int &den)
+{
+	const char* slash = strchr(str, '/');
+	if (slash) {
+		long n = atol(str);
+		long d = atol(slash + 1);
+		if (n <= 0 || d <= 0)
+			return false;
+		num = (unsigned int)n;
+		den = (unsigned int)d;
+		return true;
+	}
+
+	double fps = atof(str);
+	if (fps <= 0.0 || fps > 1000.0)
+		return false;
+
+	double ntsc = fps*1001.0/1000.0;
+	if (fabs(fps - floor(fps + 0.5)) > 0.0005 && fabs(ntsc - floor(ntsc + 0.5)) < 0.005) {
+		num = (unsigned int)floor(ntsc + 0.5)*1000;
+		den = 1001;
+		return true;
+	}
+
+	// Thousandths in the lowest terms
+	num = (unsigned int)floor(fps*1000.0 + 0.5);
+	den = 1000;
+	unsigned int a = num, b = den;
+	while (b > 0) {
+		unsigned int r = a % b;
+		a = b;
+		b = r;
+	}
+	num /= a;
+	den /= a;
+	return true;
+}
+
+//---------------------------------------------------------
+// Raw rgba or nv12 frames from a file or stdin
+static int Convert(const char* input, const char* output, int width, int height,
+	unsigned int fpsNum, unsigned int fpsDen, int format)
+{
+	FILE* in = nullptr;
+	bool bStdin = (strcmp(input, "-") == 0);
+	if (bStdin) {
+#ifdef _WIN32
+		_setmode(_fileno(stdin), _O_BINARY);
+#endif
+		in = stdin;
+	}
+	else {
+		in = fopen(input, "rb");
+	}
+	if (!in) {
+		printf("Could not open %s\n", input);
+		return 1;
+	}
+
+	rawWriter writer;
+	if (!writer.Create(output, width, height, fpsNum, fpsDen, format)) {
+		printf("Could not create %s\n", output);
+		if (!bStdin) fclose(in);
+		return 1;
+	}
+
+	std::vector<unsigned char> frame(writer.GetFrameSize());
+	while (fread(frame.data(), 1, frame.size(), in) == frame.size()) {
+		if (!writer.AddFrame(frame.data())) {
+			printf("Write failed at frame %u\n", writer.GetFrames());
+			break;
+		}
+	}
+	if (!bStdin) fclose(in);
+
+	unsigned int nFrames = writer.GetFrames();
+	if (!writer.Close()) {
+		printf("Could not write the index of %s\n", output);
+		return 1;
+	}
+	printf("%s : %u frames %dx%d at %u/%u fps (%s)\n", output, nFrames, width, height, fpsNum, fpsDen,
+		(format == frameSource::FRAME_NV12) ? "nv12" : "rgba");
+
+	return 0;
+}
+
+//---------------------------------------------------------
+// Rgba frame to nv12, BT.709 limited range.
+// The chroma of each 2x2 block is the average.
+static void RgbaToNv12(const unsigned char* rgba, unsigned char* nv12, int width, int height)
+{
+	const double kr = 0.2126, kb = 0.0722, kg = 1.0 - kr - kb;
+	unsigned char* uv = nv12 + (size_t)width*height;
+	for (int y = 0; y < height; y += 2) {
+		for (int x = 0; x < width; x += 2) {
+			double cb = 0.0, cr = 0.0;
+			for (int j = 0; j < 2; j++) {
+				for (int i = 0; i < 2; i++) {
+					const unsigned char* p = rgba + ((size_t)(y+j)*width + (x+i))*4;
+					double r = p[0]/255.0, g = p[1]/255.0, b = p[2]/255.0;
+					double luma = kr*r + kg*g + kb*b;
+					nv12[(size_t)(y+j)*width + (x+i)] = (unsigned char)(16.0 + 219.0*luma + 0.5);
+					cb += (b - luma)/(2.0*(1.0 - kb));
+					cr += (r - luma)/(2.0*(1.0 - kr));
+				}
+			}
+			uv[(size_t)(y/2)*width + x]     = (unsigned char)(128.0 + 224.0*cb/4.0 + 0.5);
+			uv[(size_t)(y/2)*width + x + 1] = (unsigned char)(128.0 + 224.0*cr/4.0 + 0.5);
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Test movie with a moving gradient and bar
+static int Generate(const char* output, int width, int height,
+	unsigned int fpsNum, unsigned int fpsDen, int frames, int format)
+{
+	rawWriter writer;
+	if (!writer.Create(output, width, height, fpsNum, fpsDen, format)) {
+		printf("Could not create %s\n", output);
+		return 1;
+	}
+
+	std::vector<unsigned char> frame((size_t)width*height*4);
+	std::vector<unsigned char> nv12(writer.GetFrameSize());
+	for (int f = 0; f < frames; f++) {
+		int bar = (f*width/frames);
+		unsigned char* p = frame.data();
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				bool bBar = (x >= bar && x < bar + width/32);
+				*p++ = bBar ? 255 : (unsigned char)(x*255/width);
+				*p++ = bBar ? 255 : (unsigned char)(y*255/height);
+				*p++ = bBar ? 255 : (unsigned char)(f*255/frames);
+				*p++ = 255;
+			}
+		}
+		if (format == frameSource::FRAME_NV12)
+			RgbaToNv12(frame.data(), nv12.data(), width, height);
+		if (!writer.AddFrame((format == frameSource::FRAME_NV12) ? nv12.data() : frame.data())) {
+			printf("Write failed at frame %d\n", f);
+			break;
+		}
+	}
+
+	unsigned int nFrames = writer.GetFrames();
+	if (!writer.Close()) {
+		printf("Could not write the index of %s\n", output);
+		return 1;
+	}
+	printf("%s : %u frames %dx%d at %u/%u fps (%s)\n", output, nFrames, width, height, fpsNum, fpsDen,
+		(format == frameSource::FRAME_NV12) ? "nv12" : "rgba");
+
+	return 0;
+}
+
+//---------------------------------------------------------
+// Installed memory in bytes, 0 if not known
+static double MemoryBytes()
+{
+#ifdef _WIN32
+	MEMORYSTATUSEX status{};
+	status.dwLength = sizeof(status);
+	if (GlobalMemoryStatusEx(&status))
+		return (double)status.ullTotalPhys;
+	return 0.0;
+#else
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long size = sysconf(_SC_PAGE_SIZE);
+	return (pages > 0 && size > 0) ? (double)pages*(double)size : 0.0;
+#endif
+}
+
+//---------------------------------------------------------
+// File read without the page cache, so that the throughput is that
+// of the drive. Offsets, sizes and the buffer are aligned to 4096 bytes.
+// If the file system does not allow it (e.g. tmpfs on Linux), the
+// pages read are dropped from the cache after each read instead.
+struct uncachedFile {
+
+	static const size_t ALIGN = 4096;
+	bool bDirect = true;
+#ifdef _WIN32
+	HANDLE hFile = INVALID_HANDLE_VALUE;
+#else
+	int fd = -1;
+#endif
+
+	bool Open(const char* path)
+	{
+#ifdef _WIN32
+		hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+			FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		return (hFile != INVALID_HANDLE_VALUE);
+#else
+		fd = open(path, O_RDONLY | O_DIRECT);
+		if (fd < 0) {
+			bDirect = false;
+			fd = open(path, O_RDONLY);
+		}
+		return (fd >= 0);
+#endif
+	}
+
+	void Close()
+	{
+#ifdef _WIN32
+		if (hFile != INVALID_HANDLE_VALUE)
+			CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+#else
+		if (fd >= 0)
+			close(fd);
+		fd = -1;
+#endif
+	}
+
+	// Bytes read
+	size_t Read(uint64_t offset, size_t size, unsigned char* buffer)
+	{
+#ifdef _WIN32
+		OVERLAPPED ov{};
+		ov.Offset = (DWORD)(offset & 0xFFFFFFFF);
+		ov.OffsetHigh = (DWORD)(offset >> 32);
+		DWORD bytes = 0;
+		if (!ReadFile(hFile, buffer, (DWORD)size, &bytes, &ov))
+			return 0;
+		return (size_t)bytes;
+#else
+		ssize_t bytes = pread(fd, buffer, size, (off_t)offset);
+		if (!bDirect)
+			posix_fadvise(fd, (off_t)offset, (off_t)size, POSIX_FADV_DONTNEED);
+		return (bytes > 0) ? (size_t)bytes : 0;
+#endif
+	}
+
+	static unsigned char* Alloc(size_t size)
+	{
+#ifdef _WIN32
+		return (unsigned char*)_aligned_malloc(size, ALIGN);
+#else
+		void* p = nullptr;
+		return (posix_memalign(&p, ALIGN, size) == 0) ? (unsigned char*)p : nullptr;
+#endif
+	}
+
+	static void Free(unsigned char* p)
+	{
+#ifdef _WIN32
+		_aligned_free(p);
+#else
+		free(p);
+#endif
+	}
+};
+
+//---------------------------------------------------------
+// Sequential read throughput at the frame rate to be sustained.
+//
+// By default frames are read without the page cache by as many
+// readers as the frames read ahead for playback, so that a movie
+// read before is not measured from memory. "mapped" reads each
+// frame from the mapping as playback does. That is only a measure
+// of the drive if the movie is larger than the memory.
+static int Bench(const char* input, double seconds, double targetFps, bool bMapped)
+{
+	rawMovie movie;
+	if (!movie.Open(input)) {
+		printf("Could not open %s\n", input);
+		return 1;
+	}
+
+	int width = movie.GetFrameWidth();
+	int height = movie.GetFrameHeight();
+	int nFrames = movie.GetFrames();
+	bool bNv12 = (movie.GetFrameFormat() == frameSource::FRAME_NV12);
+	size_t frameSize = bNv12 ? (size_t)width*height*3/2 : (size_t)width*height*4;
+	printf("%s : %d frames %dx%d at %.3f fps (%s)\n", input, nFrames, width, height,
+		movie.GetFrameRate(), bNv12 ? "nv12" : "rgba");
+	if (nFrames == 0) {
+		printf("No frames\n");
+		return 1;
+	}
+	if (targetFps <= 0.0)
+		targetFps = movie.GetFrameRate();
+	if (targetFps <= 0.0) {
+		printf("No frame rate\n");
+		return 1;
+	}
+
+	const int READERS = 4; // frames read ahead for playback
+	std::atomic<long long> next{0};
+	std::atomic<long long> late{0};
+	std::atomic<unsigned int> checksum{0};
+	std::atomic<bool> bFailed{false};
+	double slowest[READERS]{};
+	// A frame is late if it takes longer than the
+	// frame periods of the frames read ahead
+	double deadline = 1000.0*(double)(bMapped ? 1 : READERS)/targetFps;
+
+	auto start = std::chrono::steady_clock::now();
+	bool bDirect = true;
+
+	if (bMapped) {
+		double memory = MemoryBytes();
+		double fileBytes = (double)nFrames*(double)movie.GetFrameStride();
+		if (fileBytes < memory) {
+			printf("The movie (%.1f GB) is smaller than the memory (%.1f GB) and may be\n"
+				"read from the page cache. Use a larger movie or the uncached read.\n",
+				fileBytes/1.0e9, memory/1.0e9);
+		}
+		std::vector<unsigned char> upload(frameSize);
+		auto last = start;
+		for (int frame = 0; ; frame = (frame + 1) % nFrames) {
+			movie.Prefetch(frame + 1);
+			const unsigned char* data = movie.GetFrameData(frame);
+			memcpy(upload.data(), data, frameSize);
+			checksum += upload[frameSize/2];
+			next++;
+
+			auto now = std::chrono::steady_clock::now();
+			double frametime = std::chrono::duration<double, std::milli>(now - last).count();
+			if (frametime > slowest[0])
+				slowest[0] = frametime;
+			if (frametime > deadline)
+				late++;
+			last = now;
+			if (std::chrono::duration<double>(now - start).count() >= seconds)
+				break;
+		}
+	}
+	else {
+		// Aligned range for each frame
+		uint64_t align = uncachedFile::ALIGN;
+		size_t readSize = (size_t)((movie.GetFrameStride() + 2*align - 1)/align*align);
+		std::vector<std::thread> readers;
+		std::vector<uncachedFile> files(READERS);
+		for (int r = 0; r < READERS; r++) {
+			if (!files[r].Open(input)) {
+				printf("Could not open %s without buffering\n", input);
+				for (auto &file : files) file.Close();
+				return 1;
+			}
+			bDirect = bDirect && files[r].bDirect;
+		}
+		for (int r = 0; r < READERS; r++) {
+			readers.emplace_back([&, r]() {
+				unsigned char* buffer = uncachedFile::Alloc(readSize);
+				if (!buffer) {
+					bFailed = true;
+					return;
+				}
+				while (!bFailed) {
+					long long n = next++;
+					int frame = (int)(n % nFrames);
+					uint64_t offset = movie.GetFrameOffset(frame);
+					uint64_t first = offset/align*align;
+					size_t size = (size_t)((offset + frameSize - first + align - 1)/align*align);
+					auto t0 = std::chrono::steady_clock::now();
+					if (files[r].Read(first, size, buffer) < (size_t)(offset + frameSize - first)) {
+						bFailed = true;
+						break;
+					}
+					auto t1 = std::chrono::steady_clock::now();
+					checksum += buffer[(offset - first) + frameSize/2];
+					double frametime = std::chrono::duration<double, std::milli>(t1 - t0).count();
+					if (frametime > slowest[r])
+						slowest[r] = frametime;
+					if (frametime > deadline)
+						late++;
+					if (std::chrono::duration<double>(t1 - start).count() >= seconds)
+						break;
+				}
+				uncachedFile::Free(buffer);
+			});
+		}
+		for (auto &reader : readers)
+			reader.join();
+		for (auto &file : files)
+			file.Close();
+		if (bFailed) {
+			printf("Read failed\n");
+			return 1;
+		}
+	}
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	long long count = next;
+	double worst = 0.0;
+	for (double t : slowest)
+		worst = (t > worst) ? t : worst;
+
+	double bytes = (double)count*(double)frameSize;
+	double gbps = bytes/elapsed/1.0e9;
+	double fps = (double)count/elapsed;
+	double required = (double)frameSize*targetFps/1.0e9;
+	bool bPass = (fps >= targetFps);
+	printf("%lld frames in %.2f sec, %s (checksum %u)\n", count, elapsed,
+		bMapped ? "mapped" : (bDirect ? "uncached" : "page cache dropped after each read"),
+		(unsigned int)checksum);
+	printf("Throughput  %.2f GB/sec, %.1f fps at %dx%d, slowest frame %.2f msec\n",
+		gbps, fps, width, height, worst);
+	printf("Target      %.3f fps, %.2f GB/sec - %s, %lld frames over %.1f msec\n",
+		targetFps, required, bPass ? "pass" : "fail", (long long)late, deadline);
+
+	return bPass ? 0 : 2;
+}
+
+//---------------------------------------------------------
+// Deinterlace with the CPU reference.
+// Each frame is deinterlaced with the frames either side.
+static int Deinterlace(const char* input, const char* output, bool bDouble, bool bBottomFirst)
+{
+	rawMovie movie;
+	if (!movie.Open(input)) {
+		printf("Could not open %s\n", input);
+		return 1;
+	}
+
+	int width = movie.GetFrameWidth();
+	int height = movie.GetFrameHeight();
+	int nFrames = movie.GetFrames();
+	double fps = movie.GetFrameRate() * (bDouble ? 2.0 : 1.0);
+	if (nFrames == 0) {
+		printf("No frames\n");
+		return 1;
+	}
+	if (movie.GetFrameFormat() != frameSource::FRAME_RGBA) {
+		printf("Only rgba movies can be deinterlaced\n");
+		return 1;
+	}
+
+	rawWriter writer;
+	if (!writer.Create(output, width, height, (unsigned int)(fps*1000.0 + 0.5), 1000)) {
+		printf("Could not create %s\n", output);
+		return 1;
+	}
+
+	std::vector<unsigned char> frame((size_t)width*height*4);
+	std::vector<unsigned char> check(frame.size());
+	size_t mismatch = 0;
+	double msec = 0.0;
+	int count = 0;
+	for (int f = 0; f < nFrames; f++) {
+		movie.Prefetch(f + 2);
+		const unsigned char* prev = movie.GetFrameData((f > 0) ? f - 1 : f);
+		const unsigned char* cur  = movie.GetFrameData(f);
+		const unsigned char* next = movie.GetFrameData((f + 1 < nFrames) ? f + 1 : f);
+
+		for (int field = 0; field < (bDouble ? 2 : 1); field++) {
+			bool bSecond = (field == 1);
+			int parity = (bBottomFirst == bSecond) ? 0 : 1;
+
+			auto start = std::chrono::steady_clock::now();
+			deinterlaceCpu::Frame(prev, cur, next, frame.data(), width, height, parity, bSecond);
+			msec += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			count++;
+
+			if (f == 0) {
+				deinterlaceCpu::Frame(prev, cur, next, check.data(), width, height, parity, bSecond, false);
+				for (size_t i = 0; i < frame.size(); i++) {
+					if (frame[i] != check[i])
+						mismatch++;
+				}
+			}
+
+			if (!writer.AddFrame(frame.data())) {
+				printf("Write failed at frame %d\n", f);
+				f = nFrames;
+				break;
+			}
+		}
+	}
+
+	unsigned int nWritten = writer.GetFrames();
+	if (!writer.Close()) {
+		printf("Could not write the index of %s\n", output);
+		return 1;
+	}
+	printf("%s : %u frames %dx%d at %.2f fps (%s, %s field first)\n", output, nWritten,
+		width, height, fps, bDouble ? "double rate" : "single rate", bBottomFirst ? "bottom" : "top");
+	printf("%.2f msec per frame (%s), SSE2 and scalar differ in %zu bytes\n",
+		(count > 0) ? msec / (double)count : 0.0,
+		deinterlaceCpu::HasSimd() ? "SSE2" : "scalar", mismatch);
+
+	return (mismatch == 0) ? 0 : 2;
+}
+
+//---------------------------------------------------------
+// Denoise a synthetic noisy sequence with the CPU reference.
+// The first frame starts the history. Moving pixels are those
+// that differ from the clean frame before.
+static int Denoise(int width, int height, int nFrames, float sigma)
+{
+	if (width <= 0 || height <= 0 || nFrames < 2 || sigma <= 0.0f) {
+		Usage();
+		return 1;
+	}
+
+	size_t size = (size_t)width*height*4;
+	std::vector<unsigned char> clean(size), noisy(size), lastClean(size);
+	std::vector<unsigned char> history(size), frame(size);
+	std::vector<unsigned char> moving((size_t)width*height);
+
+	printf("%dx%d, %d frames, noise sigma %.1f\n", width, height, nFrames, sigma);
+	printf("PSNR (dB)    all    static    moving    msec\n");
+
+	const float strengths[] = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f };
+	for (float strength : strengths) {
+		uint32_t seed = 2463534242u;
+		double db[3]{};
+		double msec = 0.0;
+		int count = 0;
+		for (int f = 0; f < nFrames; f++) {
+			denoiseCpu::Synthetic(clean.data(), noisy.data(), width, height, f, sigma, seed);
+
+			auto start = std::chrono::steady_clock::now();
+			if (f == 0)
+				denoiseCpu::Frame(noisy.data(), history.data(), frame.data(), width, height, 0.0f);
+			else
+				denoiseCpu::Frame(noisy.data(), history.data(), frame.data(), width, height, strength);
+			msec += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			if (f > 0) {
+				for (size_t i = 0; i < moving.size(); i++)
+					moving[i] = (memcmp(&clean[i*4], &lastClean[i*4], 3) != 0) ? 2 : 1;
+				db[0] += denoiseCpu::Psnr(clean.data(), frame.data(), width, height);
+				db[1] += denoiseCpu::Psnr(clean.data(), frame.data(), width, height, moving.data(), 1);
+				db[2] += denoiseCpu::Psnr(clean.data(), frame.data(), width, height, moving.data(), 2);
+				count++;
+			}
+			lastClean.swap(clean);
+		}
+		if (strength == 0.0f)
+			printf("noisy     %6.2f    %6.2f    %6.2f\n", db[0]/count, db[1]/count, db[2]/count);
+		else
+			printf("%.2f      %6.2f    %6.2f    %6.2f    %.2f\n", strength,
+				db[0]/count, db[1]/count, db[2]/count, msec/(double)nFrames);
+	}
+
+	return 0;
+}
+
+//---------------------------------------------------------
+// A 30 fps player looping a 60 second movie on the shared clock.
+// The media time advances at the drifting rate times the speed
+// correction, once for each frame period.
+static int Sync(bool bMaster, double seconds, double drift, double offset)
+{
+	syncClock sync;
+	if (!sync.Open(bMaster)) {
+		printf("Could not open the shared clock\n");
+		return 1;
+	}
+
+	const double fps = 30.0;
+	const double duration = 60.0;
+	double period = 1.0/fps;
+	double mediaTime = offset/1000.0;
+	if (mediaTime < 0.0)
+		mediaTime += duration;
+	double rate = 1.0;
+	double start = syncClock::Clock();
+	double last = start;
+	double report = start + 1.0;
+
+	printf("%s, drift %.0f ppm\n", bMaster ? "master" : "follower", drift);
+	while (syncClock::Clock() - start < seconds) {
+		std::this_thread::sleep_for(std::chrono::duration<double>(period));
+		double now = syncClock::Clock();
+		mediaTime = fmod(mediaTime + (now - last)*(1.0 + drift/1000000.0)*rate, duration);
+		last = now;
+
+		if (bMaster) {
+			sync.Publish(mediaTime, duration, fps, 1.0, false);
+			if (now >= report) {
+				printf("%6.1f s  media %.3f\n", now - start, mediaTime);
+				report += 1.0;
+			}
+			continue;
+		}
+
+		syncClock::state master;
+		int result = sync.Read(master);
+		if (result == syncClock::READ_BUSY)
+			continue; // keep the last correction
+		if (result != syncClock::READ_OK) {
+			rate = 1.0;
+			if (now >= report) {
+				printf("%6.1f s  no master\n", now - start);
+				report += 1.0;
+			}
+			continue;
+		}
+		double diff = syncClock::Offset(master, mediaTime);
+		sync.Record(diff, fps);
+		if (sync.Correct(diff, fps, rate) == syncClock::SYNC_SKIP) {
+			mediaTime = syncClock::Predict(master);
+			rate = 1.0;
+		}
+		if (now >= report) {
+			printf("%6.1f s  %s\n", now - start, sync.Report().c_str());
+			sync.ResetStats();
+			report += 1.0;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	std::string mode = (argc > 1) ? argv[1] : "";
+	if (mode == "sync" && argc >= 3) {
+		return Sync(strcmp(argv[2], "master") == 0,
+			(argc > 3) ? atof(argv[3]) : 60.0,
+			(argc > 4) ? atof(argv[4]) : 0.0,
+			(argc > 5) ? atof(argv[5]) : 0.0);
+	}
+	if (mode == "denoise") {
+		return Denoise((argc > 2) ? atoi(argv[2]) : 1280,
+			(argc > 3) ? atoi(argv[3]) : 720,
+			(argc > 4) ? atoi(argv[4]) : 120,
+			(argc > 5) ? (float)atof(argv[5]) : 8.0f);
+	}
+
+	if (argc < 3) {
+		Usage();
+		return 1;
+	}
+
+	unsigned int fpsNum = 0, fpsDen = 1;
+	if (mode == "convert" && argc >= 7) {
+		int format = (argc > 7 && strcmp(argv[7], "nv12") == 0) ? frameSource::FRAME_NV12 : frameSource::FRAME_RGBA;
+		if (!ParseFps(argv[6], fpsNum, fpsDen)) {
+			printf("Frame rate %s not recognised\n", argv[6]);
+			return 1;
+		}
+		return Convert(argv[2], argv[3], atoi(argv[4]), atoi(argv[5]), fpsNum, fpsDen, format);
+	}
+	if (mode == "generate" && argc >= 7) {
+		int format = (argc > 7 && strcmp(argv[7], "nv12") == 0) ? frameSource::FRAME_NV12 : frameSource::FRAME_RGBA;
+		if (!ParseFps(argv[5], fpsNum, fpsDen)) {
+			printf("Frame rate %s not recognised\n", argv[5]);
+			return 1;
+		}
+		return Generate(argv[2], atoi(argv[3]), atoi(argv[4]), fpsNum, fpsDen, atoi(argv[6]), format);
+	}
+	if (mode == "bench") {
+		double fps = 0.0;
+		bool bMapped = false;
+		for (int i = 4; i < argc; i++) {
+			if (strcmp(argv[i], "mapped") == 0)
+				bMapped = true;
+			else if (ParseFps(argv[i], fpsNum, fpsDen))
+				fps = (double)fpsNum/(double)fpsDen;
+		}
+		return Bench(argv[2], (argc > 3) ? atof(argv[3]) : 10.0, fps, bMapped);
+	}
+	if (mode == "deinterlace" && argc >= 4) {
+		bool bDouble = false;
+		bool bBottomFirst = false;
+		for (int i = 4; i < argc; i++) {
+			if (strcmp(argv[i], "double") == 0) bDouble = true;
+			if (strcmp(argv[i], "bff") == 0) bBottomFirst = true;
+		}
+		return Deinterlace(argv[2], argv[3], bDouble, bBottomFirst);
+	}
+
+	Usage();
+	return 1;
+}